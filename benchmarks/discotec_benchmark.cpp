@@ -0,0 +1,423 @@
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+
+#include <algorithm>
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "combicom/CombiCom.hpp"
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "fullgrid/HaloExchange.hpp"
+#include "fullgrid/StencilSweep.hpp"
+#include "hierarchization/DistributedHierarchization.hpp"
+#include "manager/ProcessGroupWorker.hpp"
+#include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "utils/GridAllocator.hpp"
+#include "utils/MonteCarlo.hpp"
+#include "utils/Types.hpp"
+
+using namespace combigrid;
+
+namespace {
+
+struct BenchmarkParameters {
+  DimType dim;
+  LevelVector lmin;
+  LevelVector lmax;
+  BoundaryType boundary;
+  std::vector<int> p;
+  size_t ngroup;
+  size_t nprocs;
+  bool forwardDecomposition;
+  int repetitions;
+  int numInterpolationPoints;
+  std::vector<std::string> kernels;
+  std::vector<std::string> bases;
+  std::string ioPrefix;
+  std::string output;
+  GridMemoryPolicy memoryPolicy;
+};
+
+template <typename T>
+std::vector<T> splitList(const std::string& list) {
+  std::vector<T> values;
+  std::istringstream stream(list);
+  T value;
+  while (stream >> value) values.push_back(value);
+  return values;
+}
+
+template <typename T>
+std::string toJSONArray(const std::vector<T>& values) {
+  std::ostringstream stream;
+  stream << "[";
+  for (size_t i = 0; i < values.size(); ++i) {
+    stream << (i > 0 ? "," : "") << static_cast<long long>(values[i]);
+  }
+  stream << "]";
+  return stream.str();
+}
+
+/**
+ * @brief reads the parameters from the (optional) ini file given as first argument, and the
+ * overrides of the form section.key=value from the further arguments
+ */
+BenchmarkParameters readParameters(int argc, char** argv, int worldSize) {
+  boost::property_tree::ptree cfg;
+  int firstOverride = 1;
+  if (argc > 1 && std::string(argv[1]).find('=') == std::string::npos) {
+    boost::property_tree::ini_parser::read_ini(argv[1], cfg);
+    firstOverride = 2;
+  }
+  for (int i = firstOverride; i < argc; ++i) {
+    std::string argument(argv[i]);
+    auto separator = argument.find('=');
+    if (separator == std::string::npos) {
+      throw std::invalid_argument("expected section.key=value, got " + argument);
+    }
+    cfg.put(argument.substr(0, separator), argument.substr(separator + 1));
+  }
+
+  BenchmarkParameters parameters;
+  parameters.dim = static_cast<DimType>(cfg.get<int>("ct.dim", 2));
+  const auto dim = parameters.dim;
+  parameters.lmin = LevelVector(dim, 2);
+  parameters.lmax = LevelVector(dim, 8);
+  if (cfg.count("ct") && cfg.get_child("ct").count("lmin")) {
+    cfg.get<std::string>("ct.lmin") >> parameters.lmin;
+  }
+  if (cfg.count("ct") && cfg.get_child("ct").count("lmax")) {
+    cfg.get<std::string>("ct.lmax") >> parameters.lmax;
+  }
+  parameters.boundary = static_cast<BoundaryType>(cfg.get<int>("ct.boundary", 2));
+  parameters.ngroup = cfg.get<size_t>("manager.ngroup", 1);
+  parameters.nprocs = cfg.get<size_t>("manager.nprocs", worldSize / parameters.ngroup);
+  parameters.p = std::vector<int>(dim, 1);
+  parameters.p[0] = static_cast<int>(parameters.nprocs);
+  if (cfg.count("ct") && cfg.get_child("ct").count("p")) {
+    parameters.p = splitList<int>(cfg.get<std::string>("ct.p"));
+  }
+  parameters.forwardDecomposition = cfg.get<bool>("ct.forwarddecomposition", false);
+  parameters.repetitions = cfg.get<int>("benchmark.repetitions", 5);
+  parameters.numInterpolationPoints = cfg.get<int>("benchmark.interpolationpoints", 10000);
+  parameters.kernels = splitList<std::string>(cfg.get<std::string>(
+      "benchmark.kernels",
+      "hierarchize dehierarchize stencil add extract reduce interpolate write read"));
+  parameters.bases = splitList<std::string>(
+      cfg.get<std::string>("benchmark.bases", "hierarchical_hat full_weighting biorthogonal"));
+  parameters.ioPrefix = cfg.get<std::string>("benchmark.ioprefix", "benchmark_dsg");
+  parameters.output = cfg.get<std::string>("benchmark.output", "");
+  parameters.memoryPolicy =
+      GridMemoryPolicy::fromString(cfg.get<std::string>("memory.policy", ""));
+
+  if (parameters.lmin.size() != dim || parameters.lmax.size() != dim ||
+      parameters.p.size() != dim) {
+    throw std::invalid_argument("lmin, lmax and p need dim entries");
+  }
+  if (std::accumulate(parameters.p.begin(), parameters.p.end(), 1, std::multiplies<int>()) !=
+          static_cast<int>(parameters.nprocs) ||
+      parameters.ngroup * parameters.nprocs != static_cast<size_t>(worldSize)) {
+    throw std::invalid_argument(
+        "the product of p has to be nprocs, and ngroup * nprocs the number of MPI processes");
+  }
+  return parameters;
+}
+
+/**
+ * @brief runs kernel repetitions times, after a setup that is not timed
+ *
+ * @return the maximum time over all processes of each repetition, in milliseconds
+ */
+template <typename Setup, typename Kernel>
+std::vector<double> timeKernel(int repetitions, Setup&& setup, Kernel&& kernel) {
+  std::vector<double> milliseconds;
+  for (int r = 0; r < repetitions; ++r) {
+    setup();
+    MPI_Barrier(MPI_COMM_WORLD);
+    auto start = std::chrono::high_resolution_clock::now();
+    kernel();
+    auto end = std::chrono::high_resolution_clock::now();
+    double duration = std::chrono::duration<double, std::milli>(end - start).count();
+    MPI_Allreduce(MPI_IN_PLACE, &duration, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+    milliseconds.push_back(duration);
+  }
+  return milliseconds;
+}
+
+/**
+ * @brief writes one JSON object per line, so that the results of several runs can simply be
+ * concatenated; extraFields are appended to the object as they are (",\"key\":value...")
+ */
+void writeResult(std::ostream& out, const BenchmarkParameters& parameters,
+                 const std::string& kernel, const std::string& basis,
+                 std::vector<double> milliseconds, size_t numDOF,
+                 const std::string& extraFields = "") {
+  std::sort(milliseconds.begin(), milliseconds.end());
+  const auto mean =
+      std::accumulate(milliseconds.begin(), milliseconds.end(), 0.) / milliseconds.size();
+  out << "{\"kernel\":\"" << kernel << "\",\"basis\":\"" << basis << "\""
+      << ",\"dim\":" << static_cast<int>(parameters.dim)
+      << ",\"lmin\":" << toJSONArray(parameters.lmin)
+      << ",\"lmax\":" << toJSONArray(parameters.lmax)
+      << ",\"boundary\":" << static_cast<int>(parameters.boundary)
+      << ",\"p\":" << toJSONArray(parameters.p) << ",\"ngroup\":" << parameters.ngroup
+      << ",\"nprocs\":" << parameters.nprocs
+      << ",\"forward_decomposition\":" << (parameters.forwardDecomposition ? "true" : "false")
+      << ",\"memory_policy\":\"" << parameters.memoryPolicy.toString() << "\""
+      << ",\"dof\":" << numDOF << ",\"repetitions\":" << milliseconds.size()
+      << ",\"min_ms\":" << milliseconds.front()
+      << ",\"median_ms\":" << milliseconds[milliseconds.size() / 2]
+      << ",\"mean_ms\":" << mean << ",\"max_ms\":" << milliseconds.back() << extraFields << "}"
+      << std::endl;
+}
+
+template <class Basis>
+void timeHierarchization(std::ostream& out, const BenchmarkParameters& parameters,
+                         const std::string& basisName,
+                         std::vector<std::unique_ptr<DistributedFullGrid<CombiDataType>>>& dfgs,
+                         size_t numDOF) {
+  const std::vector<bool> dims(parameters.dim, true);
+  const auto fillGrids = [&dfgs]() {
+    for (auto& dfg : dfgs) {
+      std::fill(dfg->getElementVector().begin(), dfg->getElementVector().end(), 1.);
+    }
+  };
+  if (std::find(parameters.kernels.begin(), parameters.kernels.end(), "hierarchize") !=
+      parameters.kernels.end()) {
+    auto milliseconds = timeKernel(parameters.repetitions, fillGrids, [&]() {
+      for (auto& dfg : dfgs) {
+        DistributedHierarchization::hierarchizeHierachicalBasis<CombiDataType, Basis>(
+            *dfg, dims, parameters.lmin);
+      }
+    });
+    if (getCommRank(MPI_COMM_WORLD) == 0) {
+      writeResult(out, parameters, "hierarchize", basisName, milliseconds, numDOF);
+    }
+  }
+  if (std::find(parameters.kernels.begin(), parameters.kernels.end(), "dehierarchize") !=
+      parameters.kernels.end()) {
+    auto milliseconds = timeKernel(parameters.repetitions, fillGrids, [&]() {
+      for (auto& dfg : dfgs) {
+        DistributedHierarchization::dehierarchizeHierachicalBasis<CombiDataType, Basis>(
+            *dfg, dims, parameters.lmin);
+      }
+    });
+    if (getCommRank(MPI_COMM_WORLD) == 0) {
+      writeResult(out, parameters, "dehierarchize", basisName, milliseconds, numDOF);
+    }
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  MPI_Init(&argc, &argv);
+  combigrid::Stats::initialize();
+  int worldSize = getCommSize(MPI_COMM_WORLD);
+  int worldRank = getCommRank(MPI_COMM_WORLD);
+
+  BenchmarkParameters parameters;
+  try {
+    parameters = readParameters(argc, argv, worldSize);
+  } catch (const std::exception& e) {
+    if (worldRank == 0) {
+      std::cerr << e.what() << std::endl
+                << "usage: mpiexec -n <ngroup * nprocs> " << argv[0]
+                << " [benchmark.ini] [section.key=value ...]" << std::endl;
+    }
+    MPI_Finalize();
+    return 1;
+  }
+  setGridMemoryPolicy(parameters.memoryPolicy);
+  const auto dim = parameters.dim;
+  const auto& kernels = parameters.kernels;
+  auto runs = [&kernels](const std::string& kernel) {
+    return std::find(kernels.begin(), kernels.end(), kernel) != kernels.end();
+  };
+
+  // the results are written by world rank 0
+  std::ofstream outputFile;
+  if (worldRank == 0 && !parameters.output.empty()) {
+    outputFile.open(parameters.output, std::ios::app);
+  }
+  std::ostream& out = outputFile.is_open() ? outputFile : std::cout;
+
+  theMPISystem()->initWorldReusable(MPI_COMM_WORLD, parameters.ngroup, parameters.nprocs, false);
+  {
+    // make local communicator cartesian
+    std::vector<int> periods(dim, parameters.boundary == 1 ? 1 : 0);
+    int reorder = false;
+    MPI_Comm cartesianCommunicator;
+    MPI_Cart_create(theMPISystem()->getLocalComm(), static_cast<int>(dim), parameters.p.data(),
+                    periods.data(), reorder, &cartesianCommunicator);
+    theMPISystem()->storeLocalComm(cartesianCommunicator);
+  }
+  const std::vector<BoundaryType> boundary(dim, parameters.boundary);
+
+  // the component grids of the combination scheme, round robin over the groups
+  CombiMinMaxScheme combischeme(dim, parameters.lmin, parameters.lmax);
+  combischeme.createAdaptiveCombischeme();
+  const auto& levels = combischeme.getCombiSpaces();
+  const auto& coefficients = combischeme.getCoeffs();
+  IndexVector maxNumPoints(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    maxNumPoints[d] = combigrid::getNumDofNodal(parameters.lmax[d], boundary[d]);
+  }
+  const auto decomposition = combigrid::getDefaultDecomposition(maxNumPoints, parameters.p,
+                                                                parameters.forwardDecomposition);
+  std::vector<std::unique_ptr<DistributedFullGrid<CombiDataType>>> dfgs;
+  std::vector<real> dfgCoefficients;
+  size_t numDOF = 0;
+  for (size_t i = theMPISystem()->getProcessGroupNumber(); i < levels.size();
+       i += parameters.ngroup) {
+    auto dfgDecomposition =
+        combigrid::downsampleDecomposition(decomposition, parameters.lmax, levels[i], boundary);
+    dfgs.emplace_back(new DistributedFullGrid<CombiDataType>(
+        dim, levels[i], theMPISystem()->getLocalComm(), boundary, parameters.p, false,
+        dfgDecomposition));
+    dfgCoefficients.push_back(coefficients[i]);
+    numDOF += static_cast<size_t>(dfgs.back()->getNrElements());
+  }
+  // the first group's grids are counted in the results
+  MPI_Bcast(&numDOF, 1, MPI_UNSIGNED_LONG, 0, MPI_COMM_WORLD);
+
+  auto noSetup = []() {};
+
+  if (runs("hierarchize") || runs("dehierarchize")) {
+    for (const auto& basis : parameters.bases) {
+      const bool periodic = parameters.boundary == 1;
+      if (basis == "hierarchical_hat") {
+        if (periodic) {
+          timeHierarchization<HierarchicalHatPeriodicBasisFunction>(out, parameters, basis, dfgs,
+                                                                    numDOF);
+        } else {
+          timeHierarchization<HierarchicalHatBasisFunction>(out, parameters, basis, dfgs, numDOF);
+        }
+      } else if (basis == "full_weighting") {
+        if (periodic) {
+          timeHierarchization<FullWeightingPeriodicBasisFunction>(out, parameters, basis, dfgs,
+                                                                  numDOF);
+        } else {
+          timeHierarchization<FullWeightingBasisFunction>(out, parameters, basis, dfgs, numDOF);
+        }
+      } else if (basis == "biorthogonal") {
+        if (periodic) {
+          timeHierarchization<BiorthogonalPeriodicBasisFunction>(out, parameters, basis, dfgs,
+                                                                 numDOF);
+        } else {
+          timeHierarchization<BiorthogonalBasisFunction>(out, parameters, basis, dfgs, numDOF);
+        }
+      } else if (worldRank == 0) {
+        std::cerr << "unknown basis " << basis << ", skipping" << std::endl;
+      }
+    }
+  }
+
+  if (runs("stencil")) {
+    // one first-order upwind stencil per direction, with ghost layer exchange
+    std::vector<std::unique_ptr<HaloExchange<CombiDataType>>> halos;
+    for (auto& dfg : dfgs) halos.emplace_back(new HaloExchange<CombiDataType>(*dfg));
+    std::vector<GridVector<CombiDataType>> results(dfgs.size());
+    for (DimType d = 0; d < dim; ++d) {
+      std::vector<std::unique_ptr<StencilSweep<CombiDataType>>> sweeps;
+      for (auto& dfg : dfgs) {
+        sweeps.emplace_back(new StencilSweep<CombiDataType>(
+            *dfg, 0.5, std::vector<StencilTap<CombiDataType>>{{d, -1, 0.5}}));
+      }
+      auto milliseconds = timeKernel(parameters.repetitions, noSetup, [&]() {
+        for (size_t i = 0; i < dfgs.size(); ++i) sweeps[i]->apply(*halos[i], results[i]);
+      });
+      if (worldRank == 0) {
+        std::sort(milliseconds.begin(), milliseconds.end());
+        const double numBytes = static_cast<double>(numDOF) * 2 * sizeof(CombiDataType);
+        const double gigabytesPerSecond = numBytes / (milliseconds.front() * 1e6);
+        writeResult(out, parameters, "stencil", "", milliseconds, numDOF,
+                    ",\"direction\":" + std::to_string(d) +
+                        ",\"gb_per_s\":" + std::to_string(gigabytesPerSecond));
+      }
+    }
+  }
+
+  // the sparse grid of the combination, with the sizes of all groups' grids
+  DistributedSparseGridUniform<SparseGridDataType> dsg(dim, parameters.lmax, parameters.lmin,
+                                                       theMPISystem()->getLocalComm());
+  for (const auto& dfg : dfgs) dsg.registerDistributedFullGrid(*dfg);
+  dsg.reduceSubspaceSizes(theMPISystem()->getGlobalReduceComm());
+  dsg.createSubspaceData();
+  size_t numSparseGridDOF = dsg.getRawDataSize();
+  MPI_Allreduce(MPI_IN_PLACE, &numSparseGridDOF, 1, MPI_UNSIGNED_LONG, MPI_SUM,
+                theMPISystem()->getLocalComm());
+
+  if (runs("add")) {
+    auto milliseconds = timeKernel(
+        parameters.repetitions, [&dsg]() { dsg.setZero(); },
+        [&]() {
+          for (size_t i = 0; i < dfgs.size(); ++i) {
+            dsg.addDistributedFullGrid(*dfgs[i], dfgCoefficients[i]);
+          }
+        });
+    if (worldRank == 0) writeResult(out, parameters, "add", "", milliseconds, numDOF);
+  }
+  if (runs("reduce")) {
+    auto milliseconds = timeKernel(parameters.repetitions, noSetup,
+                                   [&dsg]() { CombiCom::distributedGlobalReduce(dsg); });
+    if (worldRank == 0) {
+      writeResult(out, parameters, "reduce", "", milliseconds, numSparseGridDOF);
+    }
+  }
+  if (runs("extract")) {
+    auto milliseconds = timeKernel(parameters.repetitions, noSetup, [&]() {
+      for (auto& dfg : dfgs) dfg->extractFromUniformSG(dsg);
+    });
+    if (worldRank == 0) writeResult(out, parameters, "extract", "", milliseconds, numDOF);
+  }
+  if (runs("interpolate")) {
+    auto interpolationCoords =
+        montecarlo::getRandomCoordinates(parameters.numInterpolationPoints, dim);
+    // all groups need the same coordinates
+    for (auto& coords : interpolationCoords) {
+      MPI_Bcast(coords.data(), static_cast<int>(dim), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    }
+    auto milliseconds = timeKernel(parameters.repetitions, noSetup, [&]() {
+      for (auto& dfg : dfgs) dfg->getInterpolatedValues(interpolationCoords);
+    });
+    if (worldRank == 0) {
+      writeResult(out, parameters, "interpolate", "", milliseconds,
+                  interpolationCoords.size() * dfgs.size());
+    }
+  }
+  const std::string filename =
+      parameters.ioPrefix + "_" + std::to_string(theMPISystem()->getProcessGroupNumber());
+  if (runs("write") || runs("read")) {
+    auto milliseconds = timeKernel(parameters.repetitions, noSetup,
+                                   [&]() { dsg.writeOneFile(filename); });
+    if (worldRank == 0 && runs("write")) {
+      writeResult(out, parameters, "write", "", milliseconds, numSparseGridDOF);
+    }
+  }
+  if (runs("read")) {
+    auto milliseconds = timeKernel(parameters.repetitions, noSetup,
+                                   [&]() { dsg.readOneFile(filename); });
+    if (worldRank == 0) writeResult(out, parameters, "read", "", milliseconds, numSparseGridDOF);
+  }
+  MPI_Barrier(MPI_COMM_WORLD);
+  if ((runs("write") || runs("read")) && getCommRank(theMPISystem()->getLocalComm()) == 0) {
+    std::remove(filename.c_str());
+  }
+
+  dfgs.clear();
+  combigrid::Stats::finalize();
+  MPI_Finalize();
+  return 0;
+}
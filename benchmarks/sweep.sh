@@ -0,0 +1,25 @@
+#!/bin/bash
+# scaling sweep over dimension, level and process count, appending to benchmark_results.jsonl
+# usage: ./sweep.sh [max. number of MPI processes]
+set -e
+MAXPROCS=${1:-4}
+MPIEXEC=${MPIEXEC:-mpiexec}
+cd "$(dirname "$0")"
+
+for dim in 2 3 4; do
+  for lmax in 6 8 10; do
+    if [ $((dim * lmax)) -gt 30 ]; then continue; fi
+    levels=$(printf "$lmax %.0s" $(seq $dim))
+    lmins=$(printf "2 %.0s" $(seq $dim))
+    for nprocs in 1 2 4 8; do
+      for ngroup in 1 2; do
+        if [ $((nprocs * ngroup)) -gt $MAXPROCS ]; then continue; fi
+        # decompose along the first dimension only
+        p="$nprocs $(printf "1 %.0s" $(seq $((dim - 1))))"
+        $MPIEXEC -n $((nprocs * ngroup)) ./discotec_benchmark benchmark.ini ct.dim=$dim \
+          "ct.lmin=$lmins" "ct.lmax=$levels" "ct.p=$p" manager.ngroup=$ngroup \
+          manager.nprocs=$nprocs
+      done
+    done
+  done
+done
@@ -138,10 +138,8 @@ int main(int argc, char** argv) {
         manager.getGroupFaultIDs(faultsID, groupFaults);
 
         /* call optimization code to find new coefficients */
-        const std::string prob_name = "interpolation based optimization";
         std::vector<size_t> redistributeFaultsID, recomputeFaultsID;
-        manager.recomputeOptimumCoefficients(prob_name, faultsID,
-                                             redistributeFaultsID, recomputeFaultsID);
+        manager.recomputeOptimumCoefficients(faultsID, redistributeFaultsID, recomputeFaultsID);
 
         for ( auto id : redistributeFaultsID ) {
           TaskExample* tmp = static_cast<TaskExample*>(manager.getTask(id));
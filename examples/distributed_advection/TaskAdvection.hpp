@@ -1,6 +1,8 @@
 #pragma once
 
 #include "fullgrid/DistributedFullGrid.hpp"
+#include "fullgrid/HaloExchange.hpp"
+#include "fullgrid/StencilSweep.hpp"
 #include "task/Task.hpp"
 
 namespace combigrid {
@@ -40,7 +42,9 @@ class TaskAdvection : public Task {
         p_(p),
         initialized_(false),
         stepsTotal_(0),
-        dfg_(nullptr) {
+        dfg_(nullptr),
+        halo_(nullptr),
+        sweep_(nullptr) {
     for (const auto& b : boundary) {
       assert(b == 1);
     }
@@ -58,8 +62,9 @@ class TaskAdvection : public Task {
     // create local subgrid on each process
     dfg_ = new DistributedFullGrid<CombiDataType>(dim, l, lcomm, this->getBoundary(), p_, false,
                                                   decomposition);
+    halo_ = new HaloExchange<CombiDataType>(*dfg_);
     if (phi_ == nullptr) {
-      phi_ = new std::vector<CombiDataType>(dfg_->getNrLocalElements());
+      phi_ = new GridVector<CombiDataType>(dfg_->getNrLocalElements());
     }
 
     std::vector<double> h = dfg_->getGridSpacing();
@@ -71,6 +76,17 @@ class TaskAdvection : public Task {
       throw std::runtime_error("CFL condition not satisfied!");
     }
 
+    // first-order upwind scheme with velocity 1 in all dimensions:
+    // phi_new = phi - dt * sum_d (phi - phi_{-e_d}) / h_d
+    std::vector<StencilTap<CombiDataType>> upwindTaps;
+    CombiDataType centerWeight = 1.;
+    for (DimType d = 0; d < dim; ++d) {
+      const CombiDataType courantNumber = dt_ / h[d];
+      centerWeight -= courantNumber;
+      upwindTaps.push_back({d, -1, courantNumber});
+    }
+    sweep_ = new StencilSweep<CombiDataType>(*dfg_, centerWeight, upwindTaps);
+
     TestFn f;
     for (IndexType li = 0; li < dfg_->getNrLocalElements(); ++li) {
       static std::vector<double> coords(this->getDim());
@@ -88,65 +104,12 @@ class TaskAdvection : public Task {
    */
   void run(CommunicatorType lcomm) override {
     assert(initialized_);
-    // dfg_->print(std::cout);
-
-    std::vector<CombiDataType> velocity(this->getDim(), 1);
-
-    std::vector<double> h = dfg_->getGridSpacing();
-    const auto& fullOffsets = dfg_->getLocalOffsets();
 
     phi_->resize(dfg_->getNrLocalElements());
-    std::fill(phi_->begin(), phi_->end(), 0.);
-
     for (size_t i = 0; i < nsteps_; ++i) {
-      // compute the gradient in the original dfg_, then update into phi_ and
-      // swap at the end of each time step
-      auto& u_dot_dphi = *phi_;
-
-      for (unsigned int d = 0; d < this->getDim(); ++d) {
-        // to update the values in the "lowest" layer, we need the ghost values from the lower
-        // neighbor
-        std::vector<int> subarrayExtents;
-        std::vector<CombiDataType> phi_ghost{};
-        dfg_->exchangeGhostLayerUpward(d, subarrayExtents, phi_ghost);
-        int subarrayOffset = 1;
-        IndexVector subarrayOffsets(this->getDim());
-        for (DimType d_j = 0; d_j < dim_; ++d_j) {
-          subarrayOffsets[d_j] = subarrayOffset;
-          subarrayOffset *= subarrayExtents[d_j];
-        }
-
-        for (IndexType li = 0; li < dfg_->getNrLocalElements(); ++li) {
-          // calculate local axis index of backward neighbor
-          static IndexVector locAxisIndex(this->getDim());
-          dfg_->getLocalVectorIndex(li, locAxisIndex);
-          // TODO can be unrolled into ghost and other part, avoiding if-statement
-          CombiDataType phi_neighbor = 0.;
-          if (locAxisIndex[d] == 0){
-            assert(phi_ghost.size() > 0);
-            // then use values from boundary exchange
-            IndexType gli = 0;
-            for (DimType d_j = 0; d_j < this->getDim(); ++d_j) {
-              gli = gli + subarrayOffsets[d_j] * locAxisIndex[d_j];
-            }
-            assert(gli > -1);
-            assert(gli < phi_ghost.size());
-            phi_neighbor = phi_ghost[gli];
-          } else{
-            // --locAxisIndex[d];
-            // IndexType lni = dfg_->getLocalLinearIndex(locAxisIndex);
-            // assert(lni == (li - fullOffsets[d]));
-            phi_neighbor = dfg_->getElementVector()[li - fullOffsets[d]];
-          }
-          // calculate gradient of phi with backward differential quotient
-          auto dphi = (dfg_->getElementVector()[li] - phi_neighbor) / h[d];
-
-          u_dot_dphi[li] += velocity[d] * dphi;
-        }
-      }
-      for (IndexType li = 0; li < dfg_->getNrLocalElements(); ++li) {
-        (*phi_)[li] = dfg_->getElementVector()[li] - u_dot_dphi[li] * dt_;
-      }
+      // compute the upwind update of dfg_ into phi_ (exchanging the ghost layers while the
+      // interior is updated) and swap at the end of each time step
+      sweep_->apply(*halo_, *phi_);
       phi_->swap(dfg_->getElementVector());
     }
     stepsTotal_ += nsteps_;
@@ -175,6 +138,10 @@ class TaskAdvection : public Task {
   }
 
   ~TaskAdvection() {
+    if (sweep_ != nullptr) delete sweep_;
+    sweep_ = nullptr;
+    if (halo_ != nullptr) delete halo_;
+    halo_ = nullptr;
     if (dfg_ != nullptr) delete dfg_;
     dfg_ = nullptr;
     if (phi_ != nullptr) delete phi_;
@@ -198,7 +165,8 @@ class TaskAdvection : public Task {
    * this constructor before overwriting the variables that are set by the
    * manager. here we need to set the initialized variable to make sure it is
    * set to false. */
-  TaskAdvection() : initialized_(false), stepsTotal_(0), dfg_(nullptr) {}
+  TaskAdvection()
+      : initialized_(false), stepsTotal_(0), dfg_(nullptr), halo_(nullptr), sweep_(nullptr) {}
 
  private:
   friend class boost::serialization::access;
@@ -212,7 +180,9 @@ class TaskAdvection : public Task {
   bool initialized_;
   size_t stepsTotal_;
   DistributedFullGrid<CombiDataType>* dfg_;
-  static std::vector<CombiDataType>* phi_;
+  HaloExchange<CombiDataType>* halo_;
+  StencilSweep<CombiDataType>* sweep_;
+  static GridVector<CombiDataType>* phi_;
 
   /**
    * The serialize function has to be extended by the new member variables.
@@ -234,6 +204,6 @@ class TaskAdvection : public Task {
   }
 };
 
-std::vector<CombiDataType>* TaskAdvection::phi_ = nullptr;
+GridVector<CombiDataType>* TaskAdvection::phi_ = nullptr;
 
 }  // namespace combigrid
@@ -22,6 +22,7 @@
 #include "manager/ProcessGroupWorker.hpp"
 #include "manager/ProcessManager.hpp"
 #include "task/Task.hpp"
+#include "utils/GridAllocator.hpp"
 #include "utils/MonteCarlo.hpp"
 #include "utils/Types.hpp"
 // include user specific task. this is the interface to your application
@@ -108,6 +109,9 @@ int main(int argc, char** argv) {
   boost::property_tree::ptree cfg;
   boost::property_tree::ini_parser::read_ini(paramfile, cfg);
 
+  // alignment, huge pages and NUMA placement of the grids, e.g. "align=64,hugepages,firsttouch"
+  setGridMemoryPolicy(GridMemoryPolicy::fromString(cfg.get<std::string>("memory.policy", "")));
+
   // number of process groups and number of processes per group
   size_t ngroup = cfg.get<size_t>("manager.ngroup");
   size_t nprocs = cfg.get<size_t>("manager.nprocs");
@@ -286,6 +290,7 @@ int main(int argc, char** argv) {
 
   /* write stats to json file for postprocessing */
   Stats::write("timers.json");
+  Stats::writeChromeTrace("trace.json");
 
   MPI_Finalize();
 
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "fullgrid/DistributedFullGrid.hpp"
+#include "fullgrid/HaloExchange.hpp"
+#include "fullgrid/StencilSweep.hpp"
 #include "task/Task.hpp"
 
 namespace combigrid {
@@ -41,7 +43,9 @@ class TaskAdvection : public Task {
         p_(p),
         initialized_(false),
         stepsTotal_(0),
-        dfg_(nullptr) {
+        dfg_(nullptr),
+        halo_(nullptr),
+        sweep_(nullptr) {
     for (const auto& b : boundary) {
       assert(b == 1);
     }
@@ -59,8 +63,9 @@ class TaskAdvection : public Task {
     // create local subgrid on each process
     dfg_ = new DistributedFullGrid<CombiDataType>(dim, l, lcomm, this->getBoundary(), p_, false,
                                                   decomposition);
+    halo_ = new HaloExchange<CombiDataType>(*dfg_);
     if (phi_ == nullptr) {
-      phi_ = new std::vector<CombiDataType>(dfg_->getNrLocalElements());
+      phi_ = new GridVector<CombiDataType>(dfg_->getNrLocalElements());
     }
 
     std::vector<double> h = dfg_->getGridSpacing();
@@ -72,6 +77,17 @@ class TaskAdvection : public Task {
       throw std::runtime_error("CFL condition not satisfied!");
     }
 
+    // first-order upwind scheme with velocity 1 in all dimensions:
+    // phi_new = phi - dt * sum_d (phi - phi_{-e_d}) / h_d
+    std::vector<StencilTap<CombiDataType>> upwindTaps;
+    CombiDataType centerWeight = 1.;
+    for (DimType d = 0; d < dim; ++d) {
+      const CombiDataType courantNumber = dt_ / h[d];
+      centerWeight -= courantNumber;
+      upwindTaps.push_back({d, -1, courantNumber});
+    }
+    sweep_ = new StencilSweep<CombiDataType>(*dfg_, centerWeight, upwindTaps);
+
     TestFn f;
     for (IndexType li = 0; li < dfg_->getNrLocalElements(); ++li) {
       static std::vector<double> coords(this->getDim());
@@ -89,82 +105,12 @@ class TaskAdvection : public Task {
    */
   void run(CommunicatorType lcomm) override {
     assert(initialized_);
-    // dfg_->print(std::cout);
-    const auto numLocalElements = dfg_->getNrLocalElements();
-
-    std::vector<CombiDataType> velocity(this->getDim(), 1);
-
-    std::vector<double> oneOverH = dfg_->getInverseGridSpacing();
-    const auto& fullOffsets = dfg_->getLocalOffsets();
-
-    phi_->resize(numLocalElements);
-    std::fill(phi_->begin(), phi_->end(), 0.);
 
+    phi_->resize(dfg_->getNrLocalElements());
     for (size_t i = 0; i < nsteps_; ++i) {
-      // compute the gradient in the original dfg_, then update into phi_ and
-      // swap at the end of each time step
-      auto& u_dot_dphi = *phi_;
-      for (unsigned int d = 0; d < this->getDim(); ++d) {
-        static std::vector<int> subarrayExtents;
-        std::vector<CombiDataType> phi_ghost{};
-        dfg_->exchangeGhostLayerUpward(d, subarrayExtents, phi_ghost);
-        auto ghostLayerSize = phi_ghost.size();
-
-        // update all values; this will also (wrongly) update the lowest layer's values
-        for (IndexType li = 0; li < numLocalElements; ++li) {
-#ifndef NDEBUG
-          IndexVector locAxisIndex(this->getDim());
-          dfg_->getLocalVectorIndex(li, locAxisIndex);
-          if (locAxisIndex[d] > 0) {
-            --locAxisIndex[d];
-            IndexType lni = dfg_->getLocalLinearIndex(locAxisIndex);
-            assert(lni == (li - fullOffsets[d]));
-          }
-#endif  // NDEBUG
-          auto neighborLinearIndex = li - fullOffsets[d];
-          // ensure modulo is positive, cf. https://stackoverflow.com/a/12277233
-          neighborLinearIndex = (neighborLinearIndex + numLocalElements) % numLocalElements;
-          assert(neighborLinearIndex >= 0);
-          assert(neighborLinearIndex < numLocalElements);
-          CombiDataType phi_neighbor = dfg_->getElementVector()[neighborLinearIndex];
-          auto dphi = (dfg_->getElementVector()[li] - phi_neighbor) * oneOverH[d];
-          u_dot_dphi[li] += velocity[d] * dphi;
-        }
-        // iterate the lowest layer and update the values, compensating for the wrong update
-        // before
-        assert(dfg_->getNrLocalElements() / dfg_->getLocalSizes()[d] == phi_ghost.size());
-        const auto& stride = dfg_->getLocalOffsets()[d];
-        const IndexType jump = stride * dfg_->getLocalSizes()[d];
-        for (IndexType ghostIndex = 0; ghostIndex < phi_ghost.size(); ++ghostIndex) {
-          const lldiv_t divresult = std::lldiv(ghostIndex, stride);
-          const auto dfgLowestLayerIteratedIndex = divresult.quot * jump + divresult.rem;
-#ifndef NDEBUG
-          assert(dfgLowestLayerIteratedIndex < numLocalElements);
-          IndexVector locAxisIndex(this->getDim());
-          dfg_->getLocalVectorIndex(dfgLowestLayerIteratedIndex, locAxisIndex);
-          if (locAxisIndex[d] != 0) {
-            std::cout << "lowest index = " << dfgLowestLayerIteratedIndex << std::endl;
-            std::cout << "locAxisIndex[" << d << "] = " << locAxisIndex << std::endl;
-            std::cout << "ghostIndex = " << ghostIndex << " of " << phi_ghost.size() << std::endl;
-            std::cout << "offset = " << fullOffsets << " index " << d << std::endl;
-          }
-          assert(locAxisIndex[d] == 0);
-#endif  // NDEBUG
-        // compute wrong term to "subtract" again
-          auto wrongNeighborLinearIndex = dfgLowestLayerIteratedIndex - fullOffsets[d];
-          wrongNeighborLinearIndex =
-              (wrongNeighborLinearIndex + numLocalElements) % numLocalElements;
-          assert(wrongNeighborLinearIndex >= 0);
-          assert(wrongNeighborLinearIndex < numLocalElements);
-          CombiDataType wrongPhiNeighbor = dfg_->getElementVector()[wrongNeighborLinearIndex];
-          // auto wrongDPhi = (dfg_->getElementVector()[ghostIndex] - wrongPhiNeigbor) / h[d];
-          auto dphi = (wrongPhiNeighbor - phi_ghost[ghostIndex]) * oneOverH[d];
-          u_dot_dphi[dfgLowestLayerIteratedIndex] += velocity[d] * dphi;
-        }
-      }
-      for (IndexType li = 0; li < dfg_->getNrLocalElements(); ++li) {
-        (*phi_)[li] = dfg_->getElementVector()[li] - u_dot_dphi[li] * dt_;
-      }
+      // compute the upwind update of dfg_ into phi_ (exchanging the ghost layers while the
+      // interior is updated) and swap at the end of each time step
+      sweep_->apply(*halo_, *phi_);
       phi_->swap(dfg_->getElementVector());
     }
     stepsTotal_ += nsteps_;
@@ -187,6 +133,10 @@ class TaskAdvection : public Task {
   }
 
   ~TaskAdvection() {
+    if (sweep_ != nullptr) delete sweep_;
+    sweep_ = nullptr;
+    if (halo_ != nullptr) delete halo_;
+    halo_ = nullptr;
     if (dfg_ != nullptr) delete dfg_;
     dfg_ = nullptr;
     if (phi_ != nullptr) delete phi_;
@@ -208,7 +158,8 @@ class TaskAdvection : public Task {
    * this constructor before overwriting the variables that are set by the
    * manager. here we need to set the initialized variable to make sure it is
    * set to false. */
-  TaskAdvection() : initialized_(false), stepsTotal_(0), dfg_(nullptr) {}
+  TaskAdvection()
+      : initialized_(false), stepsTotal_(0), dfg_(nullptr), halo_(nullptr), sweep_(nullptr) {}
 
  private:
   friend class boost::serialization::access;
@@ -222,7 +173,9 @@ class TaskAdvection : public Task {
   bool initialized_;
   size_t stepsTotal_;
   DistributedFullGrid<CombiDataType>* dfg_;
-  static std::vector<CombiDataType>* phi_;
+  HaloExchange<CombiDataType>* halo_;
+  StencilSweep<CombiDataType>* sweep_;
+  static GridVector<CombiDataType>* phi_;
 
   /**
    * The serialize function has to be extended by the new member variables.
@@ -244,6 +197,6 @@ class TaskAdvection : public Task {
   }
 };
 
-std::vector<CombiDataType>* TaskAdvection::phi_ = nullptr;
+GridVector<CombiDataType>* TaskAdvection::phi_ = nullptr;
 
 }  // namespace combigrid
@@ -20,6 +20,7 @@
 #include "loadmodel/LinearLoadModel.hpp"
 #include "manager/CombiParameters.hpp"
 #include "manager/ProcessGroupWorker.hpp"
+#include "manager/WorkerOnlyDriver.hpp"
 #include "task/Task.hpp"
 #include "utils/MonteCarlo.hpp"
 #include "utils/Types.hpp"
@@ -96,9 +97,7 @@ int main(int argc, char** argv) {
     throw std::invalid_argument("process group size and parallelization do not match");
   }
 
-  std::vector<LevelVector> levels;
-  std::vector<combigrid::real> coeffs;
-  std::vector<size_t> taskNumbers;  // only used in case of static task assignment
+  TaskAssignment assignment;
   bool useStaticTaskAssignment = false;
   if (ctschemeFile == "") {
     throw std::runtime_error("No CT scheme file specified");
@@ -116,17 +115,11 @@ int main(int argc, char** argv) {
       // assert(*itMax == ngroup - 1); // and goes up to the maximum group //TODO
       // filter out only those tasks that belong to "our" process group
       const auto& pgroupNumber = theMPISystem()->getProcessGroupNumber();
-      for (size_t taskNo = 0; taskNo < pgNumbers.size(); ++taskNo) {
-        if (pgNumbers[taskNo] == pgroupNumber) {
-          taskNumbers.push_back(taskNo);
-          coeffs.push_back(allCoeffs[taskNo]);
-          levels.push_back(allLevels[taskNo]);
-        }
-      }
+      assignment = getTaskAssignment(allLevels, allCoeffs, pgroupNumber, ngroup, pgNumbers);
       MASTER_EXCLUSIVE_SECTION {
-        std::cout << " Process group " << pgroupNumber << " will run " << levels.size() << " of "
-                  << pgNumbers.size() << " tasks." << std::endl;
-        printCombiDegreesOfFreedom(levels, boundary);
+        std::cout << " Process group " << pgroupNumber << " will run " << assignment.levels.size()
+                  << " of " << pgNumbers.size() << " tasks." << std::endl;
+        printCombiDegreesOfFreedom(assignment.levels, boundary);
       }
     }
   }
@@ -180,14 +173,11 @@ int main(int argc, char** argv) {
   }
   MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "read interpolation coordinates" << std::endl;
 
-  ProcessGroupWorker worker;
-  worker.setCombiParameters(params);
+  WorkerOnlyDriver driver(params);
+  auto& worker = driver.getWorker();
 
   // create Tasks
-  worker.initializeAllTasks<TaskAdvection>(levels, coeffs, taskNumbers, loadmodel.get(), dt, nsteps,
-                                           p);
-
-  worker.initCombinedUniDSGVector();
+  driver.initializeTasks<TaskAdvection>(assignment, loadmodel.get(), dt, nsteps, p);
   auto durationInit = Stats::getDuration("register dsgus") / 1000.0;
   MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "worker: initialized SG, registration was "
                                              << durationInit << " seconds" << std::endl;
@@ -211,11 +201,11 @@ int main(int argc, char** argv) {
     MASTER_EXCLUSIVE_SECTION {
       std::cout << "worker: read sizes, will allocate "
                 << static_cast<real>(worker.getCombinedUniDSGVector()[0]->getAccumulatedDataSize() *
-                                     sizeof(CombiDataType)) /
+                                     sizeof(SparseGridDataType)) /
                        1e6
                 << " plus "
                 << static_cast<real>(worker.getExtraUniDSGVector()[0]->getAccumulatedDataSize() *
-                                     sizeof(CombiDataType)) /
+                                     sizeof(SparseGridDataType)) /
                        1e6
                 << " MB" << std::endl;
     }
@@ -224,69 +214,28 @@ int main(int argc, char** argv) {
   // allocate sparse grids now
   worker.zeroDsgsData();
 
-  MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "start simulation loop" << std::endl;
-  for (size_t i = 0; i < ncombi; ++i) {
-    // run tasks for next time interval
-    worker.runAllTasks();
+  // combine through files, with the other system if there is one
+  driver.setFileBasedCombination(systemNumber, hasThirdLevel ? numSystems : 1, "dsg");
+  // everyone writes partial stats
+  driver.setStatsOutput("stats_worker_" + std::to_string(systemNumber));
+  if (evalMCError) {
+    driver.setInterpolation(interpolationCoords,
+                            "worker_interpolated_" + std::to_string(systemNumber));
+  }
+  driver.setAfterRunHook([](WorkerOnlyDriver&, size_t i) {
     auto durationRun = Stats::getDuration("run") / 1000.0;
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "calculation " << i << " took: " << durationRun
                                                << " seconds" << std::endl;
-
-    if (evalMCError) {
-      Stats::startEvent("write interpolated");
-      worker.writeInterpolatedValuesSingleFile(
-          interpolationCoords, "worker_interpolated_" + std::to_string(systemNumber));
-      Stats::stopEvent("write interpolated");
-      OTHER_OUTPUT_GROUP_EXCLUSIVE_SECTION {
-        MASTER_EXCLUSIVE_SECTION {
-          std::cout << "interpolation " << i
-                    << " took: " << Stats::getDuration("write interpolated") / 1000.0 << " seconds"
-                    << std::endl;
-        }
-      }
-    }
-
-    Stats::startEvent("combine");
-    std::string writeSparseGridFile =
-        "dsg_" + std::to_string(systemNumber) + "_step" + std::to_string(i);
-    std::string writeSparseGridFileToken = writeSparseGridFile + "_token.txt";
-
-    worker.combineLocalAndGlobal();
-    OUTPUT_GROUP_EXCLUSIVE_SECTION {
-      worker.combineThirdLevelFileBasedWrite(writeSparseGridFile, writeSparseGridFileToken);
-    }
-    // everyone writes partial stats
-    Stats::writePartial("stats_worker_" + std::to_string(systemNumber) + "_group" +
-                            std::to_string(theMPISystem()->getProcessGroupNumber()) + ".json",
-                        theMPISystem()->getLocalComm());
-
-    if (hasThirdLevel) {
-      std::string readSparseGridFile =
-          "dsg_" + std::to_string((systemNumber + 1) % 2) + "_step" + std::to_string(i);
-      std::string readSparseGridFileToken = readSparseGridFile + "_token.txt";
-      OUTPUT_GROUP_EXCLUSIVE_SECTION {
-        worker.combineThirdLevelFileBasedReadReduce(readSparseGridFile, readSparseGridFileToken);
-      }
-      else {
-        worker.waitForThirdLevelCombiResult(true);
-      }
-    } else {
-      // open question: should all groups read for themselves or one broadcasts?
-      // (currently: one group broadcasts to other groups)
-      OUTPUT_GROUP_EXCLUSIVE_SECTION {
-        worker.combineThirdLevelFileBasedReadReduce(writeSparseGridFile, writeSparseGridFileToken,
-                                                    true);
-      }
-      else {
-        worker.waitForThirdLevelCombiResult(true);
-      }
-    }
-    Stats::stopEvent("combine");
-    auto durationCombine = Stats::getDuration("combine") / 1000.0;
+  });
+  driver.setAfterCombineHook([](WorkerOnlyDriver&, size_t i) {
+    auto durationCombine = Stats::getDuration("worker-only combine") / 1000.0;
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout
         << "combination " << i << " took: " << durationCombine << " seconds" << std::endl;
-  }
-  worker.exit();
+  });
+
+  MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "start simulation loop" << std::endl;
+  driver.run(ncombi);
+  driver.exit();
 
   Stats::finalize();
 
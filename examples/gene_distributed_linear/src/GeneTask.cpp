@@ -511,7 +511,7 @@ cpFile.close();
 void GeneTask::setZero(){
   if(dfgVector_.size() != 0){
     for(int i=0; i< dfgVector_.size(); i++){
-      std::vector<CombiDataType>& data = dfgVector_[i]->getElementVector();
+      auto& data = dfgVector_[i]->getElementVector();
 
       for( size_t i=0; i<data.size(); ++i ){
         data[i] = complex(0.0);
@@ -1182,7 +1182,7 @@ void GeneTask::normalizeDFG(int species){
   if( normalizePhase ){
     // compute local mean value of dfg
     CombiDataType localMean(0.0);
-    std::vector<CombiDataType>& data = dfgVector_[species]->getElementVector();
+    auto& data = dfgVector_[species]->getElementVector();
     for( size_t i=0; i<data.size(); ++i )
       localMean += data[i];
 
@@ -1217,7 +1217,7 @@ void GeneTask::normalizeDFG(int species){
                theMPISystem()->getLocalComm() );
 
     // divide values of dfg
-    std::vector<CombiDataType>& data = dfgVector_[species]->getElementVector();
+    auto& data = dfgVector_[species]->getElementVector();
     for( size_t i=0; i<data.size(); ++i )
       data[i] *= factor;
   }
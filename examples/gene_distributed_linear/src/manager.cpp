@@ -321,11 +321,10 @@ int main(int argc, char** argv) {
         manager.getGroupFaultIDs(faultsID, groupFaults);
 
         /* call optimization code to find new coefficients */
-        const std::string prob_name = "interpolation based optimization";
         //vector with tasks that need to be redistributed (but not recomputed)
         //and tasks that need to be recomputed
         std::vector<size_t> redistributeFaultsID, recomputeFaultsID;
-        manager.recomputeOptimumCoefficients(prob_name, faultsID, redistributeFaultsID, recomputeFaultsID);
+        manager.recomputeOptimumCoefficients(faultsID, redistributeFaultsID, recomputeFaultsID);
         //timestep does not need to be updated in gene but maybe in other applications
         for ( auto id : redistributeFaultsID ) {
          GeneTask* tmp = static_cast<GeneTask*>(manager.getTask(id));
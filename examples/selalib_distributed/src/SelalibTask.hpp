@@ -10,6 +10,7 @@
 
 #include <stddef.h>
 
+#include <algorithm>
 #include <cassert>
 #include <functional>
 #include <iostream>
@@ -164,8 +165,14 @@ class SelalibTask : public combigrid::Task {
     // if coefficient is infty, we are dealing with a single full grid, no need to copy to dfg
     bool haveResolution = coeff_ == std::numeric_limits<combigrid::real>::max();
     if (!haveResolution) {
-      dfg_ = new DistributedFullGrid<CombiDataType>(getDim(), getLevelVector(), lcomm,
-                                                    getBoundary(), p_, false, decomposition);
+      // with one-sided boundaries, the dfg has no extra upper boundary layer and the same layout
+      // as the distribution, so it can use the distribution's memory instead of copies
+      const auto& boundary = getBoundary();
+      const bool wrapDistribution =
+          std::all_of(boundary.begin(), boundary.end(), [](BoundaryType b) { return b == 1; });
+      dfg_ = new DistributedFullGrid<CombiDataType>(
+          getDim(), getLevelVector(), lcomm, getBoundary(), p_, false, decomposition, nullptr,
+          wrapDistribution ? localDistribution_ : nullptr);
       setDFGfromLocalDistribution();
     }
     initialized_ = true;
@@ -239,7 +246,7 @@ class SelalibTask : public combigrid::Task {
   real getCurrentNumTimeStepsRun() { return currentNumTimeStepsRun_; }
 
   // do task-specific postprocessing (by default: nothing)
-  void doDiagnostics(const std::vector<DistributedSparseGridUniform<CombiDataType>*> dsgus,
+  void doDiagnostics(const std::vector<DistributedSparseGridUniform<SparseGridDataType>*> dsgus,
                      const std::vector<bool>& hierarchizationDims) override {
     assert(initialized_);
     assert(dsgus.size() == 1);
@@ -291,6 +298,10 @@ class SelalibTask : public combigrid::Task {
   void setDFGfromLocalDistribution() {
 #ifndef NDEBUG
     auto& localDFGSize = dfg_->getLocalSizes();
+    if (dfg_->hasExternalData()) {
+      assert(dfg_->getData() == localDistribution_);
+      assert(IndexVector(localSize_.begin(), localSize_.end()) == localDFGSize);
+    }
     assert(dim_ == 6);
     // std::cout << localDFGSize << " " << std::vector<int>(localSize_.begin(), localSize_.end()) <<
     // std::endl;
@@ -304,6 +315,10 @@ class SelalibTask : public combigrid::Task {
       assert(localSizeCopy[d] == localSize_[d]);
     }
 #endif  // ndef NDEBUG
+    if (dfg_->hasExternalData()) {
+      // the dfg works on the distribution directly
+      return;
+    }
 
     auto& offsets = dfg_->getLocalOffsets();
     assert(offsets[0] == 1);
@@ -372,6 +387,7 @@ class SelalibTask : public combigrid::Task {
 
   void setLocalDistributionFromDFG() {
     // cf setDFGfromLocalDistribution
+    if (dfg_->hasExternalData()) return;
     auto& offsets = dfg_->getLocalOffsets();
     auto localDistributionIterator = localDistribution_;
     std::array<size_t, 6> localSizeLong;
@@ -14,58 +14,104 @@ class CombiCom {
   static int sumAndCheckSubspaceSizes(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
                                       const std::vector<SubspaceSizeType>& subspaceSizes);
 
+  // in-place MPI_Allreduce of size elements, in chunks of globalReduceChunkSize
+  template <typename FG_ELEMENT>
+  static void allreduceInChunks(FG_ELEMENT* data, size_t size, MPI_Comm comm);
+
  public:
   // reduced fg will ONLY be available on r
   template <typename FG_ELEMENT>
   static void FGReduce(FullGrid<FG_ELEMENT>& fg, RankType r, MPI_Comm comm);
 
+  // non-blocking FGReduce; fg must not be accessed until the request is completed
+  template <typename FG_ELEMENT>
+  static MPI_Request FGIreduce(FullGrid<FG_ELEMENT>& fg, RankType r, MPI_Comm comm);
+
   // reduced fg will be available on all member of comm
   template <typename FG_ELEMENT>
   static void FGAllreduce(FullGrid<FG_ELEMENT>& fg, MPI_Comm comm);
 
+  // non-blocking FGAllreduce; fg must not be accessed until the request is completed
+  template <typename FG_ELEMENT>
+  static MPI_Request FGIallreduce(FullGrid<FG_ELEMENT>& fg, MPI_Comm comm);
+
+  // the global reduce of a sparse grid is done in chunks of this many elements
+  // (16MiB at a time when using double precision)
+  static constexpr size_t globalReduceChunkSize = 2097152;
+
   template <typename FG_ELEMENT>
   static void distributedGlobalReduce(DistributedSparseGridUniform<FG_ELEMENT>& dsg);
 
+  // global reduce of only the subspaces i with selectedSubspaces[i] (all if empty)
+  template <typename FG_ELEMENT>
+  static void distributedGlobalReduce(DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                      const std::vector<bool>& selectedSubspaces);
+
+  // number of chunks of chunkSize elements in the global reduce of dsg, the last one may be
+  // empty
+  template <typename FG_ELEMENT>
+  static size_t getNumGlobalReduceChunks(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                         size_t chunkSize = globalReduceChunkSize);
+
+  // non-blocking global reduce of one chunk of chunkSize elements of the dsg data; all ranks of
+  // the global reduce comm have to start the chunks in the same order and with the same
+  // chunkSize, and the chunk must not be accessed until the request is completed
+  template <typename FG_ELEMENT>
+  static MPI_Request distributedGlobalReduceChunk(DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                                  size_t chunk,
+                                                  size_t chunkSize = globalReduceChunkSize);
+
   template <typename FG_ELEMENT>
   static bool sumAndCheckSubspaceSizes(const DistributedSparseGridUniform<FG_ELEMENT>& dsg);
 };
 
 template <typename FG_ELEMENT>
 void CombiCom::FGReduce(FullGrid<FG_ELEMENT>& fg, RankType r, MPI_Comm comm) {
+  MPI_Request request = CombiCom::FGIreduce(fg, r, comm);
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
+
+template <typename FG_ELEMENT>
+MPI_Request CombiCom::FGIreduce(FullGrid<FG_ELEMENT>& fg, RankType r, MPI_Comm comm) {
   if (!fg.isGridCreated()) fg.createFullGrid();
 
-  auto& sendbuf = fg.getElementVector();
-  std::vector<FG_ELEMENT> recvbuf(sendbuf.size());
+  auto& buf = fg.getElementVector();
+  MPI_Datatype dtype =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
 
   int myrank;
   MPI_Comm_rank(comm, &myrank);
 
-  MPI_Datatype dtype =
-      abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
-
+  // the receive buffer is only significant at the root
+  MPI_Request request;
   if (myrank == r) {
-    MPI_Reduce(MPI_IN_PLACE, &sendbuf[0], static_cast<int>(sendbuf.size()), dtype, MPI_SUM, r,
-               comm);
+    MPI_Ireduce(MPI_IN_PLACE, buf.data(), static_cast<int>(buf.size()), dtype, MPI_SUM, r, comm,
+                &request);
   } else {
-    MPI_Reduce(&sendbuf[0], &recvbuf[0], static_cast<int>(sendbuf.size()), dtype, MPI_SUM, r,
-               comm);
+    MPI_Ireduce(buf.data(), nullptr, static_cast<int>(buf.size()), dtype, MPI_SUM, r, comm,
+                &request);
   }
+  return request;
 }
 
 template <typename FG_ELEMENT>
 void CombiCom::FGAllreduce(FullGrid<FG_ELEMENT>& fg, MPI_Comm comm) {
-  if (!fg.isGridCreated()) fg.createFullGrid();
+  MPI_Request request = CombiCom::FGIallreduce(fg, comm);
+  MPI_Wait(&request, MPI_STATUS_IGNORE);
+}
 
-  auto& sendbuf = fg.getElementVector();
-  std::vector<FG_ELEMENT> recvbuf(sendbuf.size());
+template <typename FG_ELEMENT>
+MPI_Request CombiCom::FGIallreduce(FullGrid<FG_ELEMENT>& fg, MPI_Comm comm) {
+  if (!fg.isGridCreated()) fg.createFullGrid();
 
+  auto& buf = fg.getElementVector();
   MPI_Datatype dtype =
       abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
 
-  int myrank;
-  MPI_Comm_rank(comm, &myrank);
-
-  MPI_Allreduce(MPI_IN_PLACE, &sendbuf[0], static_cast<int>(sendbuf.size()), dtype, MPI_SUM, comm);
+  MPI_Request request;
+  MPI_Iallreduce(MPI_IN_PLACE, buf.data(), static_cast<int>(buf.size()), dtype, MPI_SUM, comm,
+                 &request);
+  return request;
 }
 
 template <typename FG_ELEMENT>
@@ -117,24 +163,94 @@ void CombiCom::distributedGlobalReduce(DistributedSparseGridUniform<FG_ELEMENT>&
 
   assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
 
-  FG_ELEMENT* subspacesData = dsg.getRawData();
-  size_t subspacesDataSize = dsg.getRawDataSize();
-
   // global reduce
+  allreduceInChunks(dsg.getRawData(), dsg.getRawDataSize(), mycomm);
+}
+
+template <typename FG_ELEMENT>
+void CombiCom::allreduceInChunks(FG_ELEMENT* data, size_t size, MPI_Comm comm) {
   MPI_Datatype dtype =
       abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
 
   // auto chunkSize = std::numeric_limits<int>::max();
-  // allreduce up to 16MiB at a time (when using double precision)
-  auto chunkSize = 2097152;
+  auto chunkSize = globalReduceChunkSize;
   size_t sentRecvd = 0;
-  while ((subspacesDataSize - sentRecvd) / chunkSize > 0) {
-    MPI_Allreduce(MPI_IN_PLACE, subspacesData + sentRecvd, static_cast<int>(chunkSize), dtype,
-                  MPI_SUM, mycomm);
+  while ((size - sentRecvd) / chunkSize > 0) {
+    STATS_SCOPED_EVENT("global reduce chunk");
+    MPI_Allreduce(MPI_IN_PLACE, data + sentRecvd, static_cast<int>(chunkSize), dtype, MPI_SUM,
+                  comm);
     sentRecvd += chunkSize;
   }
-  MPI_Allreduce(MPI_IN_PLACE, subspacesData + sentRecvd,
-                static_cast<int>(subspacesDataSize - sentRecvd), dtype, MPI_SUM, mycomm);
+  STATS_SCOPED_EVENT("global reduce chunk");
+  MPI_Allreduce(MPI_IN_PLACE, data + sentRecvd, static_cast<int>(size - sentRecvd), dtype,
+                MPI_SUM, comm);
+}
+
+/**
+ * The data of the selected subspaces is packed into a buffer, which is reduced like the whole
+ * sparse grid above, and unpacked again; the other subspaces are not touched. As the ranks in
+ * the global reduce comm have the same subspace sizes, their buffers match.
+ */
+template <typename FG_ELEMENT>
+void CombiCom::distributedGlobalReduce(DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                       const std::vector<bool>& selectedSubspaces) {
+  if (selectedSubspaces.empty()) {
+    distributedGlobalReduce(dsg);
+    return;
+  }
+  MPI_Comm mycomm = theMPISystem()->getGlobalReduceComm();
+  assert(mycomm != MPI_COMM_NULL);
+  assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
+  assert(selectedSubspaces.size() == static_cast<size_t>(dsg.getNumSubspaces()));
+
+  size_t bufferSize = 0;
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    if (selectedSubspaces[i]) bufferSize += dsg.getDataSize(i);
+  }
+  std::vector<FG_ELEMENT> buffer;
+  buffer.reserve(bufferSize);
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    if (selectedSubspaces[i] && dsg.getDataSize(i) > 0) {
+      buffer.insert(buffer.end(), dsg.getData(i), dsg.getData(i) + dsg.getDataSize(i));
+    }
+  }
+
+  allreduceInChunks(buffer.data(), buffer.size(), mycomm);
+
+  auto bufferIt = buffer.cbegin();
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    if (selectedSubspaces[i] && dsg.getDataSize(i) > 0) {
+      std::copy_n(bufferIt, dsg.getDataSize(i), dsg.getData(i));
+      bufferIt += dsg.getDataSize(i);
+    }
+  }
+}
+
+template <typename FG_ELEMENT>
+size_t CombiCom::getNumGlobalReduceChunks(const DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                          size_t chunkSize) {
+  // same chunks as in distributedGlobalReduce for the default chunkSize
+  assert(chunkSize > 0);
+  return dsg.getRawDataSize() / chunkSize + 1;
+}
+
+template <typename FG_ELEMENT>
+MPI_Request CombiCom::distributedGlobalReduceChunk(DistributedSparseGridUniform<FG_ELEMENT>& dsg,
+                                                   size_t chunk, size_t chunkSize) {
+  MPI_Comm mycomm = theMPISystem()->getGlobalReduceComm();
+  assert(mycomm != MPI_COMM_NULL);
+  assert(dsg.isSubspaceDataCreated() && "Only perform reduce with allocated data");
+  assert(chunk < getNumGlobalReduceChunks(dsg, chunkSize));
+
+  const auto begin = chunk * chunkSize;
+  const auto end = std::min(begin + chunkSize, dsg.getRawDataSize());
+  MPI_Datatype dtype =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+
+  MPI_Request request;
+  MPI_Iallreduce(MPI_IN_PLACE, dsg.getRawData() + begin, static_cast<int>(end - begin), dtype,
+                 MPI_SUM, mycomm, &request);
+  return request;
 }
 
 } /* namespace combigrid */
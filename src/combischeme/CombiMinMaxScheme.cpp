@@ -1,5 +1,10 @@
 #include "combischeme/CombiMinMaxScheme.hpp"
 
+#include <algorithm>
+#include <unordered_set>
+
+#include "utils/LevelVectorPacker.hpp"
+
 namespace combigrid {
 
 void CombiMinMaxScheme::createClassicalCombischeme() {
@@ -99,26 +104,140 @@ void CombiMinMaxScheme::makeFaultTolerant() {
   }
 }
 
+static LevelType getMaximumLevel(const std::vector<LevelVector>& levels) {
+  LevelType maxLevel = 0;
+  for (const auto& level : levels) {
+    for (const auto& l_i : level) {
+      maxLevel = std::max(maxLevel, l_i);
+    }
+  }
+  return maxLevel;
+}
+
 void CombiMinMaxScheme::computeCombiCoeffsAdaptive() {
-  for (size_t i = 0; i < combiSpaces_.size(); i++) {
+  LevelVectorPacker packer(dim_, getMaximumLevel(combiSpaces_));
+  if (!packer.fits()) {
+    computeCombiCoeffsAdaptiveUnpacked();
+    return;
+  }
+  std::unordered_set<LevelVectorPacker::KeyType> packedSpaces;
+  packedSpaces.reserve(combiSpaces_.size());
+  for (const auto& space : combiSpaces_) {
+    packedSpaces.insert(packer.pack(space));
+  }
+
+  // key offsets and signs of the 2^d upper neighbors l + z, z in {0,1}^d
+  const size_t numNeighbors = static_cast<size_t>(1) << dim_;
+  std::vector<LevelVectorPacker::KeyType> neighborOffsets(numNeighbors, 0);
+  std::vector<real> neighborSigns(numNeighbors, 1.);
+  for (size_t z = 1; z < numNeighbors; ++z) {
+    // build from the neighbor with the lowest set bit removed
+    const auto lowestBit = static_cast<DimType>(__builtin_ctzll(z));
+    neighborOffsets[z] = neighborOffsets[z & (z - 1)] + packer.unitIncrement(lowestBit);
+    neighborSigns[z] = -neighborSigns[z & (z - 1)];
+  }
+
+  coefficients_.reserve(coefficients_.size() + combiSpaces_.size());
+  for (const auto& space : combiSpaces_) {
+    const auto key = packer.pack(space);
+    real coeff = 0;
+    for (size_t z = 0; z < numNeighbors; ++z) {
+      if (packedSpaces.count(key + neighborOffsets[z]) > 0) {
+        coeff += neighborSigns[z];
+      }
+    }
+    coefficients_.push_back(coeff);
+  }
+  eraseZeroCoefficientSpaces();
+}
+
+void CombiMinMaxScheme::computeCombiCoeffsAdaptiveUnpacked() {
+  std::set<LevelVector> spaces(combiSpaces_.begin(), combiSpaces_.end());
+  const size_t numNeighbors = static_cast<size_t>(1) << dim_;
+  LevelVector neighbor(dim_);
+  for (const auto& space : combiSpaces_) {
     real coeff = 0;
-    LevelVector tmp(combiSpaces_[i]);
-    tmp = tmp + LevelVector(dim_, 1);
-    for (auto nbr : combiSpaces_) {
-      if (nbr >= combiSpaces_[i] && nbr <= tmp) {
-        LevelVector diff = nbr - combiSpaces_[i];
-        coeff += std::pow(-1.0, std::accumulate(diff.begin(), diff.end(), 0));
+    for (size_t z = 0; z < numNeighbors; ++z) {
+      int numOnes = 0;
+      for (DimType d = 0; d < dim_; ++d) {
+        const auto z_d = static_cast<LevelType>((z >> d) & 1);
+        neighbor[d] = static_cast<LevelType>(space[d] + z_d);
+        numOnes += static_cast<int>(z_d);
+      }
+      if (spaces.find(neighbor) != spaces.end()) {
+        coeff += (numOnes % 2 == 0) ? 1. : -1.;
       }
     }
-    // Flag combiSpaces that will be erased later
-    if (coeff == 0) combiSpaces_[i] = LevelVector(dim_, 0);
     coefficients_.push_back(coeff);
   }
-  // Delete combiSpaces_ and coefficients_ for which the coeff is zero
-  combiSpaces_.erase(std::remove(combiSpaces_.begin(), combiSpaces_.end(), LevelVector(dim_, 0)),
-                     combiSpaces_.end());
-  coefficients_.erase(std::remove(coefficients_.begin(), coefficients_.end(), 0),
-                      coefficients_.end());
+  eraseZeroCoefficientSpaces();
+}
+
+void CombiMinMaxScheme::eraseZeroCoefficientSpaces() {
+  assert(coefficients_.size() == combiSpaces_.size());
+  size_t numKept = 0;
+  for (size_t i = 0; i < combiSpaces_.size(); ++i) {
+    if (coefficients_[i] != 0) {
+      if (numKept != i) {
+        combiSpaces_[numKept] = std::move(combiSpaces_[i]);
+        coefficients_[numKept] = coefficients_[i];
+      }
+      ++numKept;
+    }
+  }
+  combiSpaces_.resize(numKept);
+  coefficients_.resize(numKept);
+}
+
+void CombiMinMaxScheme::createDownSet() {
+  LevelVectorPacker packer(dim_, getMaximumLevel(combiSpaces_));
+  if (!packer.fits()) {
+    std::set<LevelVector> subspaces;
+    for (size_t i = 0; i < combiSpaces_.size(); ++i) {
+      // only check the active front of the scheme -- those grids with coefficient 1
+      if (coefficients_[i] == 1.) {
+        // insert all subspaces covered by grid i into the set
+        auto thisGridsDownSet = combigrid::getDownSet(combiSpaces_[i]);
+        subspaces.insert(thisGridsDownSet.begin(), thisGridsDownSet.end());
+      }
+    }
+    levels_.assign(subspaces.begin(), subspaces.end());
+    return;
+  }
+
+  // start from the active front of the scheme -- those grids with coefficient 1
+  std::unordered_set<LevelVectorPacker::KeyType> subspaces;
+  for (size_t i = 0; i < combiSpaces_.size(); ++i) {
+    const auto& grid = combiSpaces_[i];
+    if (coefficients_[i] == 1. &&
+        std::all_of(grid.begin(), grid.end(), [](LevelType l) { return l > 0; })) {
+      subspaces.insert(packer.pack(grid));
+    }
+  }
+  // close the set downwards, one dimension at a time; going through the keys in descending
+  // order, each pole can stop as soon as it hits a subspace that is already contained, because
+  // the part below that subspace has been or will be added from there
+  std::vector<LevelVectorPacker::KeyType> sortedKeys;
+  for (DimType d = 0; d < dim_; ++d) {
+    sortedKeys.assign(subspaces.begin(), subspaces.end());
+    std::sort(sortedKeys.begin(), sortedKeys.end(), std::greater<LevelVectorPacker::KeyType>());
+    const auto increment = packer.unitIncrement(d);
+    for (auto key : sortedKeys) {
+      for (auto l_d = packer.getLevel(key, d); l_d > 1; --l_d) {
+        key -= increment;
+        if (!subspaces.insert(key).second) {
+          break;
+        }
+      }
+    }
+  }
+  // the packed keys sort like the level vectors in a std::set
+  sortedKeys.assign(subspaces.begin(), subspaces.end());
+  std::sort(sortedKeys.begin(), sortedKeys.end());
+  levels_.resize(sortedKeys.size());
+  for (size_t k = 0; k < sortedKeys.size(); ++k) {
+    packer.unpack(sortedKeys[k], levels_[k]);
+  }
 }
 
 void CombiMinMaxScheme::computeCombiCoeffsClassical() {
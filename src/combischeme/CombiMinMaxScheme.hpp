@@ -79,18 +79,7 @@ class CombiMinMaxScheme {
    * so I re-implemented the downward closed set from the definition)
    *
    */
-  void createDownSet() {
-    std::set<LevelVector> subspaces;
-    for (size_t i = 0; i < combiSpaces_.size(); ++ i) {
-      // only check the active front of the scheme -- those grids with coefficient 1
-      if (coefficients_[i] == 1.) {
-        // insert all subspaces covered by grid i into the set
-        auto thisGridsDownSet = combigrid::getDownSet(combiSpaces_[i]);
-        subspaces.insert(thisGridsDownSet.begin(), thisGridsDownSet.end());
-      }
-    }
-    levels_.assign(subspaces.begin(), subspaces.end());
-  }
+  void createDownSet();
 
   inline void print(std::ostream& os) const;
 
@@ -123,8 +112,15 @@ class CombiMinMaxScheme {
   void computeCombiCoeffsClassical();
 
   /* Calculate the coefficients of the adaptive CT using the formula in Alfredo's
-   * SDC paper (from Brendan Harding)*/
+   * SDC paper (from Brendan Harding), looking up the 2^d upper neighbors of each
+   * component grid in a hash set of packed level vectors -> O(n*2^d)*/
   void computeCombiCoeffsAdaptive();
+
+  /* same as computeCombiCoeffsAdaptive, for level vectors that do not fit into a packed key */
+  void computeCombiCoeffsAdaptiveUnpacked();
+
+  /* remove the component grids whose coefficient has become zero */
+  void eraseZeroCoefficientSpaces();
 };
 
 inline std::ostream& operator<<(std::ostream& os, const combigrid::CombiMinMaxScheme& scheme) {
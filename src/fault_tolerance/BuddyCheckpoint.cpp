@@ -0,0 +1,182 @@
+#include "fault_tolerance/BuddyCheckpoint.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#include "mpi/MPITags.hpp"
+#include "utils/Stats.hpp"
+
+namespace combigrid {
+
+namespace {
+inline MPI_Datatype getCheckpointDatatype() {
+  return abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>());
+}
+
+// the checkpoints are buffers of CombiDataType
+inline void checkNotSinglePrecision(const Task& task) {
+  if (task.isSinglePrecision()) {
+    throw std::runtime_error("BuddyCheckpoint: not implemented for single precision tasks");
+  }
+}
+}  // namespace
+
+BuddyCheckpoint::~BuddyCheckpoint() {
+  // the owner is expected to complete the checkpoint before MPI is finalized
+  int finalized = 0;
+  MPI_Finalized(&finalized);
+  assert(!pending_ || !finalized);
+  if (pending_ && !finalized) {
+    MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+  }
+}
+
+void BuddyCheckpoint::post(const TaskContainer& tasks, int numGrids, CommunicatorType comm) {
+  complete();
+  for (const auto& task : tasks) checkNotSinglePrecision(*task);
+
+  const int size = getCommSize(comm);
+  if (size < 2) return;
+  const int rank = getCommRank(comm);
+  const RankType buddy = (rank + 1) % size;
+  const RankType source = (rank + size - 1) % size;
+
+  Stats::startEvent("checkpoint post");
+  Layout sendLayout;
+  size_t numElements = 0;
+  for (const auto& task : tasks) {
+    auto& offsets = sendLayout[task->getID()];
+    offsets.push_back(numElements);
+    for (int g = 0; g < numGrids; ++g) {
+      numElements += static_cast<size_t>(task->getDistributedFullGrid(g).getNrLocalElements());
+      offsets.push_back(numElements);
+    }
+  }
+  // copy, as the grids change in the time steps the transfer overlaps with
+  sendBuffer_.resize(numElements);
+  for (const auto& task : tasks) {
+    const auto& offsets = sendLayout[task->getID()];
+    for (int g = 0; g < numGrids; ++g) {
+      const auto& dfg = task->getDistributedFullGrid(g);
+      std::memcpy(sendBuffer_.data() + offsets[g], dfg.getData(),
+                  (offsets[g + 1] - offsets[g]) * sizeof(CombiDataType));
+    }
+  }
+
+  incomingLayout_ = exchangeLayouts(sendLayout, buddy, source, comm);
+  size_t numIncoming = 0;
+  for (const auto& entry : incomingLayout_) numIncoming = std::max(numIncoming, entry.second.back());
+  incoming_.resize(numIncoming);
+  trackMemory();
+
+  assert(sendBuffer_.size() <= INT_MAX && incoming_.size() <= INT_MAX);
+  MPI_Irecv(incoming_.data(), static_cast<int>(incoming_.size()), getCheckpointDatatype(), source,
+            TRANSFER_CHECKPOINT_DATA_TAG, comm, &requests_[0]);
+  MPI_Isend(sendBuffer_.data(), static_cast<int>(sendBuffer_.size()), getCheckpointDatatype(),
+            buddy, TRANSFER_CHECKPOINT_DATA_TAG, comm, &requests_[1]);
+  pending_ = true;
+  postTime_ = std::chrono::high_resolution_clock::now();
+  numBytesSent_ += sendBuffer_.size() * sizeof(CombiDataType);
+  Stats::stopEvent("checkpoint post");
+  Stats::setAttribute("checkpoint: bytes sent", std::to_string(numBytesSent_));
+}
+
+void BuddyCheckpoint::complete() {
+  if (!pending_) return;
+  auto waitStart = std::chrono::high_resolution_clock::now();
+  overlap_ += std::chrono::duration_cast<std::chrono::microseconds>(waitStart - postTime_);
+  Stats::startEvent("checkpoint wait");
+  MPI_Waitall(static_cast<int>(requests_.size()), requests_.data(), MPI_STATUSES_IGNORE);
+  Stats::stopEvent("checkpoint wait");
+  pending_ = false;
+
+  std::swap(held_, incoming_);
+  std::swap(heldLayout_, incomingLayout_);
+  // keep the capacity for the next checkpoint
+  incoming_.clear();
+  incomingLayout_.clear();
+  trackMemory();
+  Stats::setAttribute("checkpoint: bytes held", std::to_string(getNumBytesHeld()));
+  Stats::setAttribute("checkpoint: overlap us", std::to_string(overlap_.count()));
+}
+
+bool BuddyCheckpoint::holds(size_t taskID) const {
+  return heldLayout_.find(taskID) != heldLayout_.end();
+}
+
+void BuddyCheckpoint::sendTo(size_t taskID, RankType dest, CommunicatorType comm) {
+  complete();
+  auto found = heldLayout_.find(taskID);
+  if (found == heldLayout_.end()) {
+    MPI_Send(nullptr, 0, getCheckpointDatatype(), dest, TRANSFER_CHECKPOINT_DATA_TAG, comm);
+    return;
+  }
+  const auto& offsets = found->second;
+  MPI_Send(held_.data() + offsets.front(), static_cast<int>(offsets.back() - offsets.front()),
+           getCheckpointDatatype(), dest, TRANSFER_CHECKPOINT_DATA_TAG, comm);
+}
+
+bool BuddyCheckpoint::receiveInto(Task& task, int numGrids, RankType source,
+                                  CommunicatorType comm) {
+  checkNotSinglePrecision(task);
+  size_t numElements = 0;
+  for (int g = 0; g < numGrids; ++g) {
+    numElements += static_cast<size_t>(task.getDistributedFullGrid(g).getNrLocalElements());
+  }
+  std::vector<CombiDataType> buffer(numElements);
+  MPI_Status status;
+  MPI_Recv(buffer.data(), static_cast<int>(buffer.size()), getCheckpointDatatype(), source,
+           TRANSFER_CHECKPOINT_DATA_TAG, comm, &status);
+  int count = 0;
+  MPI_Get_count(&status, getCheckpointDatatype(), &count);
+  if (count == 0 && numElements > 0) return false;
+  assert(static_cast<size_t>(count) == numElements);
+
+  size_t offset = 0;
+  for (int g = 0; g < numGrids; ++g) {
+    auto& dfg = task.getDistributedFullGrid(g);
+    std::memcpy(dfg.getData(), buffer.data() + offset,
+                static_cast<size_t>(dfg.getNrLocalElements()) * sizeof(CombiDataType));
+    offset += static_cast<size_t>(dfg.getNrLocalElements());
+  }
+  return true;
+}
+
+BuddyCheckpoint::Layout BuddyCheckpoint::exchangeLayouts(const Layout& sendLayout, RankType buddy,
+                                                         RankType source, CommunicatorType comm) {
+  // flattened as [taskID, #offsets, offsets...] per task
+  std::vector<unsigned long long> sendbuf;
+  for (const auto& entry : sendLayout) {
+    sendbuf.push_back(entry.first);
+    sendbuf.push_back(entry.second.size());
+    sendbuf.insert(sendbuf.end(), entry.second.begin(), entry.second.end());
+  }
+  int sendSize = static_cast<int>(sendbuf.size());
+  int recvSize = 0;
+  MPI_Sendrecv(&sendSize, 1, MPI_INT, buddy, TRANSFER_CHECKPOINT_LAYOUT_TAG, &recvSize, 1, MPI_INT,
+               source, TRANSFER_CHECKPOINT_LAYOUT_TAG, comm, MPI_STATUS_IGNORE);
+  std::vector<unsigned long long> recvbuf(recvSize);
+  MPI_Sendrecv(sendbuf.data(), sendSize, MPI_UNSIGNED_LONG_LONG, buddy,
+               TRANSFER_CHECKPOINT_LAYOUT_TAG, recvbuf.data(), recvSize, MPI_UNSIGNED_LONG_LONG,
+               source, TRANSFER_CHECKPOINT_LAYOUT_TAG, comm, MPI_STATUS_IGNORE);
+
+  Layout layout;
+  for (size_t i = 0; i < recvbuf.size();) {
+    auto& offsets = layout[static_cast<size_t>(recvbuf[i])];
+    const auto numOffsets = static_cast<size_t>(recvbuf[i + 1]);
+    offsets.assign(recvbuf.begin() + i + 2, recvbuf.begin() + i + 2 + numOffsets);
+    i += 2 + numOffsets;
+  }
+  return layout;
+}
+
+void BuddyCheckpoint::trackMemory() {
+  memory_.setNumBytes((sendBuffer_.capacity() + incoming_.capacity() + held_.capacity()) *
+                      sizeof(CombiDataType));
+}
+
+}  // namespace combigrid
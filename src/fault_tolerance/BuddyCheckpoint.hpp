@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <map>
+#include <vector>
+
+#include "mpi/MPISystem.hpp"
+#include "task/Task.hpp"
+#include "utils/MemoryTracker.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief diskless checkpoints of the tasks' full grid data in the memory of a buddy group
+ *
+ * After each combination, every worker copies the local parts of its tasks' DistributedFullGrids
+ * and sends them, non-blocking, to the process with the same local rank in the next process
+ * group (in the GlobalReduceComm, group g checkpoints to group g+1 mod #groups). In turn, it
+ * keeps the checkpoint of the previous group. The transfers overlap with the following time
+ * steps and are only completed at the next checkpoint, or when a checkpoint is requested for
+ * recovery. A group replacing a failed one can then restore the tasks' state of the last
+ * combination from its buddy, instead of recomputing them or changing the coefficients.
+ *
+ * The received data is double-buffered, so that the last completed checkpoint stays valid
+ * while the next one is in flight; together with the send buffer, this costs up to three
+ * times the full grid memory (accounted as MemoryCategory::checkpoints).
+ */
+class BuddyCheckpoint {
+ public:
+  BuddyCheckpoint() = default;
+
+  BuddyCheckpoint(const BuddyCheckpoint& other) = delete;
+  BuddyCheckpoint& operator=(const BuddyCheckpoint& other) = delete;
+
+  ~BuddyCheckpoint();
+
+  /**
+   * @brief post the checkpoint of the local data of tasks to the buddy and the receive of the
+   * previous group's checkpoint; completes the previous checkpoint first
+   *
+   * Collective on comm (usually the GlobalReduceComm).
+   */
+  void post(const TaskContainer& tasks, int numGrids, CommunicatorType comm);
+
+  /**
+   * @brief wait for the posted transfers; the received checkpoint becomes the held one
+   */
+  void complete();
+
+  /** whether there is a completed checkpoint of this task */
+  bool holds(size_t taskID) const;
+
+  /**
+   * @brief send the held checkpoint of a task to dest (blocking; an empty message if there is
+   * no checkpoint of this task), to be received with receiveInto
+   */
+  void sendTo(size_t taskID, RankType dest, CommunicatorType comm);
+
+  /**
+   * @brief receive a task's checkpoint from source into its full grids, which have to be
+   * initialized with the same decomposition as the checkpointed ones
+   *
+   * @return false if source did not hold a checkpoint of the task (the grids are unchanged)
+   */
+  static bool receiveInto(Task& task, int numGrids, RankType source, CommunicatorType comm);
+
+  inline size_t getNumBytesHeld() const { return held_.size() * sizeof(CombiDataType); }
+
+ private:
+  // the offsets of each task's grids in the buffers, numGrids + 1 per task
+  typedef std::map<size_t, std::vector<size_t>> Layout;
+
+  static Layout exchangeLayouts(const Layout& sendLayout, RankType buddy, RankType source,
+                                CommunicatorType comm);
+
+  void trackMemory();
+
+  std::vector<CombiDataType> sendBuffer_;
+  std::vector<CombiDataType> incoming_;
+  std::vector<CombiDataType> held_;
+
+  Layout incomingLayout_;
+  Layout heldLayout_;
+
+  std::array<MPI_Request, 2> requests_ = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  bool pending_ = false;
+  std::chrono::high_resolution_clock::time_point postTime_;
+
+  // for the Stats attributes
+  size_t numBytesSent_ = 0;
+  std::chrono::microseconds overlap_{0};
+
+  TrackedMemory memory_{MemoryCategory::checkpoints};
+};
+
+}  // namespace combigrid
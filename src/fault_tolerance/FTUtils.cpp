@@ -4,82 +4,6 @@
 #include <valarray>
 
 namespace combigrid {
-template <typename T>
-T str_to_number(const std::string& no) {
-  T value;
-  std::stringstream stream(no);
-  stream >> value;
-
-  if (stream.fail()) {
-    std::runtime_error e(no);
-    std::cout << "Error in the conversion of " << no << "!" << std::endl;
-    throw e;
-  }
-
-  return value;
-}
-
-std::string python_code_caller(const std::string& script_name, const LevelVectorList& levels,
-                               const int& dim) {
-  LevelType levels_no = static_cast<LevelType>(levels.size());
-  LevelType level_size = static_cast<LevelType>(levels[0].size());
-  LevelType one_level = 0;
-  std::stringstream caller;
-
-  caller << "python " << script_name << " " << dim << " ";
-
-  for (int i = 0; i < levels_no; ++i) {
-    for (int j = 0; j < level_size; ++j) {
-      one_level = levels[i][j];
-      caller << one_level << " ";
-    }
-  }
-
-  return caller.str();
-}
-
-CombigridDict get_python_data(const std::string& script_run, const int& dim) {
-  FILE* stream;
-  char buffer[256];
-  std::string level_x_str;
-  std::string level_y_str;
-  std::string coeff_str;
-
-  double coeff = 0.0;
-
-  CombigridDict dict;
-
-  stream = popen(script_run.c_str(), "r");
-
-  if (stream) {
-    while (!feof(stream)) {
-      if (fgets(buffer, sizeof(buffer), stream) != NULL) {
-        std::string one_level_str;
-        int one_level = 0;
-        LevelVector levels;
-        std::stringstream temp(buffer);
-
-        for (int i = 0; i < dim; ++i) {
-          temp >> one_level_str;
-          one_level = str_to_number<int>(one_level_str);
-          levels.push_back(one_level);
-        }
-
-        temp >> coeff_str;
-        coeff = str_to_number<double>(coeff_str);
-
-        dict.insert(std::make_pair(levels, coeff));
-      }
-    }
-
-    pclose(stream);
-  } else {
-    throw "Error reading script output!";
-  }
-
-  return dict;
-}
-
 matrix get_inv_M(const CombigridDict& aux_downset, const int& dim) {
   int size_downset = static_cast<int>(aux_downset.size());
   int i = 0;
@@ -14,17 +14,6 @@ typedef std::vector<std::vector<real>> matrix;
 typedef std::map<LevelVector, real> CombigridDict;
 typedef std::vector<LevelVector> LevelVectorList;
 
-/* used to convert a string to a number in any format */
-template <typename T>
-T str_to_number(const std::string& no);
-
-/* used for calling the python code as python script_name level_min level_max */
-std::string python_code_caller(const std::string& script_name, const LevelVectorList& levels,
-                               const int& dim);
-
-/* used to get data for the GCP when minimizing the interpolation error */
-CombigridDict get_python_data(const std::string& script_run, const int& dim);
-
 /* used to create the inverse of M */
 matrix get_inv_M(const CombigridDict& aux_downset, const int& dim);
 
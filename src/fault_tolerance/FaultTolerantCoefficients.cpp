@@ -0,0 +1,251 @@
+#include "fault_tolerance/FaultTolerantCoefficients.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace combigrid {
+
+namespace {
+// mixes the level keys into the order-independent hash of the removed set (Zobrist hashing)
+inline uint64_t mixKey(uint64_t key) {
+  key += 0x9e3779b97f4a7c15ULL;
+  key = (key ^ (key >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  key = (key ^ (key >> 27)) * 0x94d049bb133111ebULL;
+  return key ^ (key >> 31);
+}
+
+LevelType getMaximumLevel(const CombigridDict& combiDict) {
+  LevelType maxLevel = 0;
+  for (const auto& entry : combiDict) {
+    maxLevel = std::max(maxLevel, *std::max_element(entry.first.begin(), entry.first.end()));
+  }
+  return maxLevel;
+}
+}  // namespace
+
+FaultTolerantCoefficients::FaultTolerantCoefficients(const CombigridDict& combiDict,
+                                                     const LevelVector& lmin)
+    : dim_(static_cast<DimType>(lmin.size())),
+      packer_(static_cast<DimType>(lmin.size()), getMaximumLevel(combiDict)),
+      lmin_(lmin),
+      recomputeBelowLevelSum_(0),
+      bestValue_(0.),
+      stateHash_(0) {
+  assert(!combiDict.empty());
+  if (!packer_.fits()) {
+    throw std::runtime_error("FaultTolerantCoefficients: levels too large to be packed");
+  }
+
+  // the downset spanned by the levels with nonzero coefficients
+  std::vector<KeyType> stack;
+  LevelType maxLevelSum = 0;
+  for (const auto& entry : combiDict) {
+    levels_.push_back(entry.first);
+    dictKeys_.insert(packer_.pack(entry.first));
+    if (entry.second != 0.) {
+      stack.push_back(packer_.pack(entry.first));
+      maxLevelSum = std::max(maxLevelSum, levelSum(entry.first));
+    }
+  }
+  while (!stack.empty()) {
+    KeyType key = stack.back();
+    stack.pop_back();
+    if (!downset_.insert(key).second) continue;
+    for (DimType d = 0; d < dim_; ++d) {
+      if (packer_.getLevel(key, d) > lmin_[d]) {
+        stack.push_back(key - packer_.unitIncrement(d));
+      }
+    }
+  }
+  // as in filter_faults, only the two uppermost diagonals have to be compensated for
+  recomputeBelowLevelSum_ = maxLevelSum - 1;
+
+  for (const auto& entry : combiDict) {
+    if (std::abs(entry.second - coefficient(packer_.pack(entry.first))) > 1e-10) {
+      throw std::invalid_argument(
+          "FaultTolerantCoefficients: coefficients do not describe a downset combination");
+    }
+  }
+  for (auto key : downset_) {
+    if (dictKeys_.find(key) == dictKeys_.end() && coefficient(key) != 0) {
+      throw std::invalid_argument(
+          "FaultTolerantCoefficients: nonzero coefficient outside of the dictionary");
+    }
+  }
+}
+
+bool FaultTolerantCoefficients::addFaults(const LevelVectorList& faults) {
+  std::vector<KeyType> violated;
+  for (const auto& fault : faults) {
+    assert(fault.size() == dim_);
+    KeyType key = packer_.pack(fault);
+    if (dictKeys_.find(key) == dictKeys_.end()) continue;
+    if (levelSum(fault) < recomputeBelowLevelSum_) {
+      recomputableFaults_.insert(key);
+    } else if (blockedFaults_.insert(key).second && isViolated(key)) {
+      // the current downset satisfies all previous faults, so only new ones can be violated
+      violated.push_back(key);
+    }
+  }
+  numSearchNodes_ = 0;
+  if (violated.empty()) return false;
+  std::sort(violated.begin(), violated.end());
+
+  real value = 0.;
+  for (auto key : downset_) value += subspaceWeight(key);
+  // the empty downset is always feasible, with value 0
+  bestValue_ = -1.;
+  bestDownset_.clear();
+  visitedStates_.clear();
+  stateHash_ = 0;
+  search(violated, value);
+  assert(bestValue_ >= 0.);
+  downset_ = std::move(bestDownset_);
+  bestDownset_.clear();
+  visitedStates_.clear();
+  return true;
+}
+
+CombigridDict FaultTolerantCoefficients::getCombiDict() const {
+  CombigridDict dict;
+  for (const auto& level : levels_) {
+    dict.emplace_hint(dict.end(), level, static_cast<real>(coefficient(packer_.pack(level))));
+  }
+  return dict;
+}
+
+real FaultTolerantCoefficients::getCoefficient(const LevelVector& level) const {
+  return static_cast<real>(coefficient(packer_.pack(level)));
+}
+
+LevelVectorList FaultTolerantCoefficients::getLevelsToRecompute() const {
+  LevelVectorList recompute;
+  for (const auto& level : levels_) {
+    KeyType key = packer_.pack(level);
+    if (recomputableFaults_.find(key) != recomputableFaults_.end() && coefficient(key) != 0) {
+      recompute.push_back(level);
+    }
+  }
+  return recompute;
+}
+
+int FaultTolerantCoefficients::coefficient(KeyType key) const {
+  if (downset_.find(key) == downset_.end()) return 0;
+  // the i-th entry of the upper cube is key + z, with the bits of i as z
+  const auto cube = upperCube(key);
+  int c = 0;
+  for (size_t i = 0; i < cube.size(); ++i) {
+    if (downset_.find(cube[i]) != downset_.end()) {
+      c += (__builtin_popcountll(i) % 2 == 0) ? 1 : -1;
+    }
+  }
+  return c;
+}
+
+real FaultTolerantCoefficients::subspaceWeight(KeyType key) const {
+  LevelType sum = 0;
+  for (DimType d = 0; d < dim_; ++d) sum += packer_.getLevel(key, d);
+  return std::ldexp(1., -2 * static_cast<int>(sum));
+}
+
+bool FaultTolerantCoefficients::isViolated(KeyType key) const {
+  if (downset_.find(key) == downset_.end()) return false;
+  if (dictKeys_.find(key) != dictKeys_.end() &&
+      blockedFaults_.find(key) == blockedFaults_.end()) {
+    return false;
+  }
+  return coefficient(key) != 0;
+}
+
+std::vector<FaultTolerantCoefficients::KeyType> FaultTolerantCoefficients::upperCube(
+    KeyType key) const {
+  std::vector<KeyType> cube(1, key);
+  for (DimType d = 0; d < dim_; ++d) {
+    const auto increment = packer_.unitIncrement(d);
+    const size_t numLower = cube.size();
+    for (size_t i = 0; i < numLower; ++i) cube.push_back(cube[i] + increment);
+  }
+  return cube;
+}
+
+void FaultTolerantCoefficients::removeUpset(KeyType key, std::vector<KeyType>& removed) {
+  std::vector<KeyType> stack(1, key);
+  while (!stack.empty()) {
+    KeyType current = stack.back();
+    stack.pop_back();
+    if (downset_.erase(current) == 0) continue;
+    removed.push_back(current);
+    stateHash_ ^= mixKey(current);
+    for (DimType d = 0; d < dim_; ++d) {
+      stack.push_back(current + packer_.unitIncrement(d));
+    }
+  }
+}
+
+void FaultTolerantCoefficients::search(std::vector<KeyType>& violated, real value) {
+  ++numSearchNodes_;
+  // removing subspaces only ever decreases the value
+  if (value <= bestValue_) return;
+  if (!visitedStates_.insert(stateHash_).second) return;
+  if (violated.empty()) {
+    bestValue_ = value;
+    bestDownset_ = downset_;
+    return;
+  }
+
+  // any feasible subset has to remove one of the subspaces that make up the coefficient of the
+  // violated level; try the cheapest removals first
+  const KeyType level = violated.front();
+  std::vector<std::pair<real, KeyType>> options;
+  for (KeyType option : upperCube(level)) {
+    if (downset_.find(option) == downset_.end()) continue;
+    std::vector<KeyType> removed;
+    removeUpset(option, removed);
+    real loss = 0.;
+    for (auto key : removed) {
+      loss += subspaceWeight(key);
+      downset_.insert(key);
+      stateHash_ ^= mixKey(key);
+    }
+    options.emplace_back(loss, option);
+  }
+  std::sort(options.begin(), options.end());
+
+  for (const auto& option : options) {
+    if (value - option.first <= bestValue_) break;
+    std::vector<KeyType> removed;
+    removeUpset(option.second, removed);
+
+    // only the levels below the removed ones can change their coefficient
+    std::unordered_set<KeyType> changed;
+    for (auto key : removed) {
+      std::vector<KeyType> lowerCube(1, key);
+      for (DimType d = 0; d < dim_; ++d) {
+        if (packer_.getLevel(key, d) <= lmin_[d]) continue;
+        const auto increment = packer_.unitIncrement(d);
+        const size_t numUpper = lowerCube.size();
+        for (size_t i = 0; i < numUpper; ++i) lowerCube.push_back(lowerCube[i] - increment);
+      }
+      changed.insert(lowerCube.begin(), lowerCube.end());
+    }
+    std::vector<KeyType> stillViolated;
+    for (auto key : violated) {
+      if (changed.find(key) == changed.end()) stillViolated.push_back(key);
+    }
+    for (auto key : changed) {
+      if (isViolated(key)) stillViolated.push_back(key);
+    }
+    std::sort(stillViolated.begin(), stillViolated.end());
+
+    search(stillViolated, value - option.first);
+
+    for (auto key : removed) {
+      downset_.insert(key);
+      stateHash_ ^= mixKey(key);
+    }
+  }
+}
+
+}  // namespace combigrid
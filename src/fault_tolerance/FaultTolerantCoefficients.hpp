@@ -0,0 +1,107 @@
+#ifndef DISTRIBUTEDCOMBIGRID_SRC_SGPP_DISTRIBUTEDCOMBIGRID_FAULT_TOLERANCE_FAULTTOLERANTCOEFFICIENTS_HPP_
+#define DISTRIBUTEDCOMBIGRID_SRC_SGPP_DISTRIBUTEDCOMBIGRID_FAULT_TOLERANCE_FAULTTOLERANTCOEFFICIENTS_HPP_
+
+#include <unordered_set>
+#include <vector>
+
+#include "fault_tolerance/FTUtils.hpp"
+#include "utils/LevelVectorPacker.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief computes the combination coefficients after grid faults natively on the downset
+ *
+ * The combination is represented by the downset W of subspaces it contains; the coefficient of
+ * level l is c_l = sum_{z in {0,1}^d} (-1)^|z| [l+z in W]. After faults, we look for the
+ * downset W' that is contained in the current one and maximizes sum_{l in W'} 4^-|l|, such that
+ * - every level with a nonzero coefficient is one of the levels of the given combination
+ *   dictionary, and
+ * - every failed level on the two uppermost diagonals gets coefficient 0.
+ * Failed levels further down may keep a nonzero coefficient, they are then recomputed
+ * (cf. getLevelsToRecompute). This is the same optimization problem LP_OPT_INTERP hands to
+ * GLPK, solved exactly by a branch and bound over the removed upsets.
+ *
+ * Since W' is searched among the subsets of the current W, the solver can be updated
+ * incrementally when more grids fail later on.
+ */
+class FaultTolerantCoefficients {
+ public:
+  /**
+   * @param combiDict the levels of the combination scheme and their coefficients; levels with
+   * coefficient 0 (e.g. from CombiMinMaxScheme::makeFaultTolerant) may be used after faults
+   * @param lmin the minimum level of the scheme
+   */
+  FaultTolerantCoefficients(const CombigridDict& combiDict, const LevelVector& lmin);
+
+  /**
+   * @brief adapt the coefficients to additional faults, keeping all previous ones
+   *
+   * Faults that are not part of the combination dictionary are ignored.
+   * @return whether the coefficients changed
+   */
+  bool addFaults(const LevelVectorList& faults);
+
+  inline bool addFault(const LevelVector& fault) { return addFaults(LevelVectorList{fault}); }
+
+  /** the current coefficients of all levels of the combination dictionary */
+  CombigridDict getCombiDict() const;
+
+  real getCoefficient(const LevelVector& level) const;
+
+  /** the failed levels that still have a nonzero coefficient and need to be recomputed */
+  LevelVectorList getLevelsToRecompute() const;
+
+  /** the number of branch and bound nodes visited by the last call to addFaults */
+  inline size_t getNumSearchNodes() const { return numSearchNodes_; }
+
+ private:
+  typedef LevelVectorPacker::KeyType KeyType;
+
+  int coefficient(KeyType key) const;
+
+  bool isViolated(KeyType key) const;
+
+  // the objective weight 4^-|l| of a subspace
+  real subspaceWeight(KeyType key) const;
+
+  void removeUpset(KeyType key, std::vector<KeyType>& removed);
+
+  void search(std::vector<KeyType>& violated, real value);
+
+  std::vector<KeyType> upperCube(KeyType key) const;
+
+  DimType dim_;
+
+  LevelVectorPacker packer_;
+
+  LevelVector lmin_;
+
+  // the levels of the combination dictionary, in order
+  LevelVectorList levels_;
+
+  std::unordered_set<KeyType> dictKeys_;
+
+  // failed levels that must not have a nonzero coefficient
+  std::unordered_set<KeyType> blockedFaults_;
+
+  // failed levels that may be recomputed
+  std::unordered_set<KeyType> recomputableFaults_;
+
+  // failed levels with a sum below this may be recomputed
+  LevelType recomputeBelowLevelSum_;
+
+  // the current downset
+  std::unordered_set<KeyType> downset_;
+
+  // branch and bound state
+  std::unordered_set<KeyType> bestDownset_;
+  real bestValue_;
+  std::unordered_set<uint64_t> visitedStates_;
+  uint64_t stateHash_;
+  size_t numSearchNodes_ = 0;
+};
+
+}  // namespace combigrid
+
+#endif /* DISTRIBUTEDCOMBIGRID_SRC_SGPP_DISTRIBUTEDCOMBIGRID_FAULT_TOLERANCE_FAULTTOLERANTCOEFFICIENTS_HPP_ */
@@ -2,19 +2,25 @@
 #define DISTRIBUTEDCOMBIFULLGRID_HPP_
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <iostream>
 #include <numeric>
+#include <stdexcept>
 #include <string>
+#include <type_traits>
 
 #include "fullgrid/FullGrid.hpp"
 #include "fullgrid/SliceIterator.hpp"
 #include "mpi/MPICartesianUtils.hpp"
 #include "mpi/MPISystem.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
+#include "utils/GridAllocator.hpp"
 #include "utils/IndexVector.hpp"
 #include "utils/LevelSetUtils.hpp"
 #include "utils/LevelVector.hpp"
+#include "utils/LpNormAccumulator.hpp"
+#include "utils/MemoryTracker.hpp"
 #include "utils/PowerOfTwo.hpp"
 #include "utils/Stats.hpp"
 #include "utils/Types.hpp"
@@ -86,7 +92,7 @@ class DistributedFullGrid {
                       const std::vector<BoundaryType>& hasBdrPoints, const std::vector<int>& procs,
                       bool forwardDecomposition = true,
                       const std::vector<IndexVector>& decomposition = std::vector<IndexVector>(),
-                      const BasisFunctionBasis* basis = NULL)
+                      const BasisFunctionBasis* basis = NULL, FG_ELEMENT* externalData = nullptr)
       : dim_(dim), levels_(levels), hasBoundaryPoints_(hasBdrPoints) {
     assert(levels_.size() == dim);
     assert(hasBoundaryPoints_.size() == dim);
@@ -133,7 +139,12 @@ class DistributedFullGrid {
     }
 
     // in contrast to serial implementation we directly create the grid
-    fullgridVector_.resize(nrLocalElements_);
+    if (externalData == nullptr) {
+      fullgridVector_.resize(nrLocalElements_);
+      fullgridVectorMemory_.track(fullgridVector_);
+    } else {
+      wrapExternalData(externalData);
+    }
   }
 
   // explicit DistributedFullGrid(const DistributedFullGrid& other) {
@@ -159,6 +170,9 @@ class DistributedFullGrid {
     for (size_t i = 0; i < downwardSubarrays_.size(); ++i) {
       MPI_Type_free(&downwardSubarrays_[i]);
     }
+    for (size_t i = 0; i < gatherSubarrays_.size(); ++i) {
+      MPI_Type_free(&gatherSubarrays_[i]);
+    }
   }
 
 
@@ -200,96 +214,6 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     this->validateSizes();
   }
 };
-  FG_ELEMENT evalLocalIndexOn(const IndexVector& localIndex,
-                              const std::vector<real>& coords) const {
-    const auto& lowerBounds = this->getLowerBounds();
-
-    // get product of 1D hat functions on coords
-    const auto& h = getGridSpacing();
-    real phi_c = 1.;  // value of product of basis function on coords
-    for (DimType d = 0; d < dim_; ++d) {
-      // get distance between coords and point
-      // this should be the same as
-      // coordDistance = this->getCoordsLocal(localIndex) - coords;
-      // cf. getLowerBoundsCoords()
-      auto coordDistance =
-          static_cast<double>(lowerBounds[d] + (hasBoundaryPoints_[d] > 0 ? 0 : 1) +
-                              localIndex[d]) *
-              h[d] -
-          coords[d];
-#ifndef NDEBUG
-      if (std::abs(coordDistance) > h[d]) {
-        std::cout << "assert bounds " << coordDistance << coords << h << static_cast<int>(d)
-                  << localIndex << std::endl;
-        assert(false &&
-               "should only be called for coordinates within the support of this point's basis "
-               "function");
-      }
-#endif  // ndef NDEBUG
-      phi_c *= 1. - std::abs(coordDistance / h[d]);
-    }
-
-    auto localLinearIndex = getLocalLinearIndex(localIndex);
-    // std::cout << "coords " <<  localIndex << coords << localLinearIndex << h << std::endl;
-    // std::cout << "phi_c " << phi_c << this->getElementVector()[localLinearIndex] << std::endl;
-    assert(phi_c >= 0.);
-    return phi_c * this->getElementVector()[localLinearIndex];
-  }
-
-  /**
-   * @brief recursive call to evaluate all neighbor points' contributions to the coordinate (on this
-   * part of the grid)
-   *
-   * @param localIndex the (in-all-dimensions lower) neighbor of coords
-   * @param dim the current dimension to split on (start with 0)
-   * @param coords the coordinate to interpolate on
-   * @return FG_ELEMENT the interpolated value at coords
-   */
-  FG_ELEMENT evalMultiindexRecursively(const IndexVector& localIndex, DimType dim,
-                                       const std::vector<real>& coords) const {
-    assert(!(dim > this->getDimension()));
-    if (dim == this->getDimension()) {
-      return evalLocalIndexOn(localIndex, coords);
-    } else {
-      FG_ELEMENT sum = 0.;
-      auto lastIndexInDim = this->getLocalSizes()[dim] - 1;
-      if (localIndex[dim] >= 0 && localIndex[dim] <= lastIndexInDim) {
-        sum += evalMultiindexRecursively(localIndex, static_cast<DimType>(dim + 1), coords);
-      } else if (localIndex[dim] > lastIndexInDim &&
-                 !(this->hasBoundaryPoints_[dim] == 1 &&
-                   this->getCartesianUtils().isOnLowerBoundaryInDimension(dim))) {
-        throw std::runtime_error("localIndex[dim] > lastIndexInDim");
-      }
-
-      auto localIndexDimPlusOne = localIndex[dim] + 1;
-      if (localIndexDimPlusOne >= 0) {
-        if (this->hasBoundaryPoints_[dim] == 1 &&
-            this->getCartesianUtils().isOnLowerBoundaryInDimension(dim) &&
-            localIndexDimPlusOne == this->getGlobalSizes()[dim]) {
-          // assume periodicity
-          // if we are at the end of the dimension, wrap around
-          localIndexDimPlusOne = 0;
-          auto secondCoords = coords;
-          secondCoords[dim] -= 1.;
-          // these copies are used to find all the neighbor points of the current coordinate
-          auto neighborIndex = localIndex;
-          neighborIndex[dim] = localIndexDimPlusOne;
-          sum +=
-              evalMultiindexRecursively(neighborIndex, static_cast<DimType>(dim + 1), secondCoords);
-        } else if (localIndexDimPlusOne <= lastIndexInDim) {
-          // these copies are used to find all the neighbor points of the current coordinate
-          auto neighborIndex = localIndex;
-          neighborIndex[dim] = localIndexDimPlusOne;
-          sum += evalMultiindexRecursively(neighborIndex, static_cast<DimType>(dim + 1),
-                                            coords);
-        }
-      } else {
-        throw std::runtime_error("localIndexDimPlusOne < 0");
-      }
-      return sum;
-    }
-  }
-
   /** evaluates the full grid on the specified coordinates
    * @param coords ND coordinates on the unit square [0,1]^D*/
   FG_ELEMENT evalLocal(const std::vector<real>& coords) const {
@@ -298,47 +222,29 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     return value;
   }
 
+  /**
+   * @brief evaluates this process' part of the grid on coords; the values of all processes of
+   * the grid sum up to the interpolated value
+   */
   void evalLocal(const std::vector<real>& coords, FG_ELEMENT& value) const {
     assert(coords.size() == this->getDimension());
+    value = 0.;
+    dispatchEvalDimension([&](auto d) { this->evalCell<decltype(d)::value>(coords, value); });
+  }
 
-    // get the lowest-index point of the points
-    // whose basis functions contribute to the interpolated value
-    auto lowerCoords = getLowerBoundsCoords();
-    const auto& h = getGridSpacing();
-    static IndexVector localIndexLowerNonzeroNeighborPoint;
-    localIndexLowerNonzeroNeighborPoint.resize(dim_);
-    for (DimType d = 0; d < dim_; ++d) {
-#ifndef NDEBUG
-      if (coords[d] < 0. || coords[d] > 1.) {
-        std::cout << "coords " << coords << " out of bounds" << std::endl;
-      }
-      assert(coords[d] >= 0. && coords[d] <= 1.);
-#endif  // ndef NDEBUG
-
-      // this is the local index of the point that is lower than the coordinate
-      // may also be negative if the coordinate is lower than this processes' coordinates
-      localIndexLowerNonzeroNeighborPoint[d] =
-          static_cast<IndexType>(std::floor((coords[d] - lowerCoords[d]) / h[d]));
-
-      // check if we even need to recursively evaluate on this process
-      if (localIndexLowerNonzeroNeighborPoint[d] < -1) {
-        // index too small
-        value = 0.;
-        return;
-      } else if ((coords[d] >= 1.0 - h[d] && coords[d] <= 1.0) &&
-                 this->hasBoundaryPoints_[d] == 1 &&
-                 this->getCartesianUtils().isOnLowerBoundaryInDimension(d)) {
-        // if we have periodic boundary and this process is at the lower end of the dimension d
-        // we need the periodic coordinate => do nothing
-      } else if (localIndexLowerNonzeroNeighborPoint[d] > this->getLocalSizes()[d] - 1) {
-        // index too high
-        value = 0.;
-        return;
+  /**
+   * @brief evaluates this process' part of the grid on a batch of coordinates, without
+   * communication or allocation (values has to be of the same size as interpolationCoords)
+   */
+  void evalLocal(const std::vector<std::vector<real>>& interpolationCoords,
+                 std::vector<FG_ELEMENT>& values) const {
+    assert(values.size() == interpolationCoords.size());
+    dispatchEvalDimension([&](auto d) {
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        values[i] = 0.;
+        this->evalCell<decltype(d)::value>(interpolationCoords[i], values[i]);
       }
-    }
-    // evaluate at those points and sum up according to the basis function
-    // needs to be recursive in order to be dimensionally adaptive
-    value = evalMultiindexRecursively(localIndexLowerNonzeroNeighborPoint, 0, coords);
+    });
   }
 
   /** evaluates the full grid on the specified coordinates
@@ -346,16 +252,35 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   std::vector<FG_ELEMENT> getInterpolatedValues(
       const std::vector<std::vector<real>>& interpolationCoords) const {
     auto numValues = interpolationCoords.size();
-    std::vector<FG_ELEMENT> values;
-    values.resize(numValues);
-    for (size_t i = 0; i < numValues; ++i) {
-      this->evalLocal(interpolationCoords[i], values[i]);
-    }
+    std::vector<FG_ELEMENT> values(numValues);
+    this->evalLocal(interpolationCoords, values);
     MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numValues), this->getMPIDatatype(),
                   MPI_SUM, this->getCommunicator());
     return values;
   }
 
+  /**
+   * @brief evaluates this process' part of the grid on a batch of coordinates, without
+   * communication
+   *
+   * Only the coordinates that are within the support of one of the local points' basis functions
+   * are evaluated; their positions in interpolationCoords are appended to contributingIndices
+   * and their partial values to contributions.
+   */
+  void evalLocalContributions(const std::vector<std::vector<real>>& interpolationCoords,
+                              std::vector<size_t>& contributingIndices,
+                              std::vector<FG_ELEMENT>& contributions) const {
+    dispatchEvalDimension([&](auto d) {
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        FG_ELEMENT value = 0.;
+        if (this->evalCell<decltype(d)::value>(interpolationCoords[i], value)) {
+          contributingIndices.push_back(i);
+          contributions.push_back(value);
+        }
+      }
+    });
+  }
+
   /** return the coordinates on the unit square corresponding to global idx
    * @param globalIndex [IN] global linear index of the element i
    * @param coords [OUT] the vector must be resized already */
@@ -579,10 +504,39 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   /** returns the dimension of the full grid */
   inline DimType getDimension() const { return dim_; }
 
-  /** the getters for the full grid vector */
-  inline std::vector<FG_ELEMENT>& getElementVector() { return fullgridVector_; }
+  /**
+   * the getters for the full grid vector; only for grids that own their data, cf.
+   * wrapExternalData (use getData() and getNrLocalElements() to support both)
+   */
+  inline GridVector<FG_ELEMENT>& getElementVector() {
+    assert(!hasExternalData());
+    return fullgridVector_;
+  }
 
-  inline const std::vector<FG_ELEMENT>& getElementVector() const { return fullgridVector_; }
+  inline const GridVector<FG_ELEMENT>& getElementVector() const {
+    assert(!hasExternalData());
+    return fullgridVector_;
+  }
+
+  /**
+   * @brief use an application-owned buffer as the local data of this grid, instead of copying
+   * from and to it; the grid's own data is released
+   *
+   * The buffer has to hold getNrLocalElements() values in the grid's local layout (first
+   * dimension fastest, without padding), e.g. a solver's distribution function if its
+   * decomposition matches and it has no extra upper boundary layer (as in periodic dimensions
+   * with one-sided boundary, BoundaryType 1). It is not owned and has to outlive the grid, and
+   * hierarchization, the sparse grid transfers and the MPI operations then work in place on it.
+   * getElementVector() and averageBoundaryValues() are not available for such grids.
+   */
+  inline void wrapExternalData(FG_ELEMENT* data) {
+    assert(data != nullptr);
+    externalData_ = data;
+    GridVector<FG_ELEMENT>().swap(fullgridVector_);
+    fullgridVectorMemory_.track(fullgridVector_);
+  }
+
+  inline bool hasExternalData() const { return externalData_ != nullptr; }
 
   /** return the offset in the full grid vector of the dimension */
   inline IndexType getOffset(DimType i) const { return offsets_[i]; }
@@ -638,13 +592,15 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   /** vector of flags to show if the dimension has boundary points*/
   inline const std::vector<BoundaryType>& returnBoundaryFlags() const { return hasBoundaryPoints_; }
 
-  inline void setZero() {
-    std::fill(this->getElementVector().begin(), this->getElementVector().end(), 0.);
-  }
+  inline void setZero() { std::fill(this->getData(), this->getData() + nrLocalElements_, 0.); }
 
-  inline FG_ELEMENT* getData() { return &fullgridVector_[0]; }
+  inline FG_ELEMENT* getData() {
+    return externalData_ != nullptr ? externalData_ : fullgridVector_.data();
+  }
 
-  inline const FG_ELEMENT* getData() const { return &fullgridVector_[0]; }
+  inline const FG_ELEMENT* getData() const {
+    return externalData_ != nullptr ? externalData_ : fullgridVector_.data();
+  }
 
   /** MPI Communicator*/
   inline CommunicatorType getCommunicator() const { return communicator_; }
@@ -938,56 +894,47 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
 
   // gather fullgrid on rank r
   void gatherFullGrid(FullGrid<FG_ELEMENT>& fg, RankType root) {
-    int size = this->getCommunicatorSize();
-    int rank = this->getMpiRank();
-    CommunicatorType comm = this->getCommunicator();
-
-    // each rank: send dfg to root
-    int dest = root;
-    MPI_Request sendRequest;
-    MPI_Isend(this->getData(), static_cast<int>(this->getNrLocalElements()), this->getMPIDatatype(),
-              dest, 0, comm, &sendRequest);
-
-    std::vector<MPI_Request> requests;
-    std::vector<MPI_Datatype> subarrayTypes;
+    MPI_Request request = this->igatherFullGrid(fg, root);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+  }
 
-    // rank r: for each rank create subarray view on fg
+  /**
+   * @brief start gathering the full grid on rank root, directly into fg's data
+   *
+   * Collective on the grid's communicator; neither this grid's data nor fg may be changed until
+   * the returned request is completed, and there can only be one gather per grid at a time. The
+   * subarray datatypes of the ranks' parts are created at the first gather and reused.
+   */
+  MPI_Request igatherFullGrid(FullGrid<FG_ELEMENT>& fg, RankType root) {
+    const int size = this->getCommunicatorSize();
+    const int rank = this->getMpiRank();
+
+    // some MPI implementations (e.g. Open MPI 4.1.4) read as many entries as the cartesian
+    // communicator has neighbors, so the arrays are padded to at least 2*dim entries
+    const int numEntries = std::max(size, 2 * static_cast<int>(this->getDimension()));
+    gatherSendCounts_.assign(numEntries, 0);
+    gatherSendCounts_[root] = static_cast<int>(this->getNrLocalElements());
+    gatherSendTypes_.assign(numEntries, this->getMPIDatatype());
+    gatherRecvCounts_.assign(numEntries, 0);
+    gatherRecvTypes_.assign(numEntries, this->getMPIDatatype());
+    gatherDisplacements_.assign(numEntries, 0);
+
+    FG_ELEMENT* recvbuf = nullptr;
     if (rank == root) {
       if (!fg.isGridCreated()) fg.createFullGrid();
-
-      for (int r = 0; r < size; ++r) {
-        IndexVector sizes(fg.getSizes().begin(), fg.getSizes().end());
-        IndexVector subsizes = this->getUpperBounds(r) - this->getLowerBounds(r);
-        IndexVector starts = this->getLowerBounds(r);
-
-        std::vector<int> csizes(sizes.begin(), sizes.end());
-        std::vector<int> csubsizes(subsizes.begin(), subsizes.end());
-        std::vector<int> cstarts(starts.begin(), starts.end());
-
-        // create subarray view on data
-        MPI_Datatype mysubarray;
-        MPI_Type_create_subarray(static_cast<int>(this->getDimension()), &csizes[0], &csubsizes[0],
-                                 &cstarts[0], MPI_ORDER_FORTRAN, this->getMPIDatatype(),
-                                 &mysubarray);
-        MPI_Type_commit(&mysubarray);
-        subarrayTypes.push_back(mysubarray);
-
-        int src = r;
-        MPI_Request req;
-        MPI_Irecv(fg.getData(), 1, mysubarray, src, 0, this->getCommunicator(), &req);
-        requests.push_back(req);
-      }
+      assert(IndexVector(fg.getSizes().begin(), fg.getSizes().end()) == this->getGlobalSizes());
+      std::fill(gatherRecvCounts_.begin(), gatherRecvCounts_.begin() + size, 1);
+      const auto& subarrays = this->getGatherSubarrays();
+      std::copy(subarrays.begin(), subarrays.end(), gatherRecvTypes_.begin());
+      recvbuf = fg.getData();
     }
 
-    // all
-    MPI_Wait(&sendRequest, MPI_STATUS_IGNORE);
-
-    if (rank == root) {
-      MPI_Waitall(static_cast<int>(requests.size()), &requests[0], MPI_STATUSES_IGNORE);
-    }
-
-    // free subarrays
-    for (size_t i = 0; i < subarrayTypes.size(); ++i) MPI_Type_free(&subarrayTypes[i]);
+    MPI_Request request;
+    MPI_Ialltoallw(this->getData(), gatherSendCounts_.data(), gatherDisplacements_.data(),
+                   gatherSendTypes_.data(), recvbuf, gatherRecvCounts_.data(),
+                   gatherDisplacements_.data(), gatherRecvTypes_.data(), this->getCommunicator(),
+                   &request);
+    return request;
   }
 
   inline void getFGPointsOfSubspaceRecursive(DimType d, IndexType localLinearIndexSum,
@@ -1042,28 +989,36 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
    * @brief extracts the (hopefully) hierarchical coefficients from dsg
    *        to the full grid's data structure
    *
+   * The sparse grid may have a higher precision than the full grid (e.g. double for a float
+   * grid), the values are then rounded to FG_ELEMENT.
+   *
    * @param dsg the DSG to extract from
+   * @param selectedSubspaces if not empty, only the subspaces i of the dsg with
+   * selectedSubspaces[i] are extracted, the others keep their values
    */
-  void extractFromUniformSG(const DistributedSparseGridUniform<FG_ELEMENT>& dsg) {
+  template <typename SG_ELEMENT>
+  void extractFromUniformSG(const DistributedSparseGridUniform<SG_ELEMENT>& dsg,
+                            const std::vector<bool>& selectedSubspaces = {}) {
     assert(dsg.isSubspaceDataCreated());
+    assert(selectedSubspaces.empty() ||
+           selectedSubspaces.size() == static_cast<size_t>(dsg.getNumSubspaces()));
 
-    // all the hierarchical subspaces contained in this full grid
-    const auto downwardClosedSet = combigrid::getDownSet(levels_);
-
-    // loop over all subspaces (-> somewhat linear access in the sg)
-    typename DistributedSparseGridUniform<FG_ELEMENT>::SubspaceIndexType sIndex = 0;
+    // loop over all the hierarchical subspaces contained in this full grid
+    // (-> somewhat linear access in the sg)
     static IndexVector subspaceIndices;
-    for (const auto& level : downwardClosedSet) {
-      sIndex = dsg.getIndexInRange(level, sIndex);
-      if (sIndex > -1 && dsg.getDataSize(sIndex) > 0) {
+    combigrid::forEachLevelInDownSet(levels_, [&](const LevelVector& level) {
+      const auto sIndex = dsg.getIndex(level);
+      if (sIndex > -1 && dsg.getDataSize(sIndex) > 0 &&
+          (selectedSubspaces.empty() || selectedSubspaces[sIndex])) {
         auto sPointer = dsg.getData(sIndex);
+        auto data = this->getData();
         subspaceIndices = getFGPointsOfSubspace(level);
         for (const auto& fIndex : subspaceIndices) {
-          fullgridVector_[fIndex] = *sPointer;
+          data[fIndex] = static_cast<FG_ELEMENT>(*sPointer);
           ++sPointer;
         }
       }
-    }
+    });
   }
 
   inline IndexType getStrideForThisLevel(LevelType l, DimType d) const {
@@ -1167,10 +1122,10 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     MPI_Datatype dtype =
       abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>());
     if (p == 0) {
-      auto& data = getElementVector();
+      auto data = getData();
       real max = 0.0;
 
-      for (size_t i = 0; i < data.size(); ++i) {
+      for (IndexType i = 0; i < this->getNrLocalElements(); ++i) {
         if (std::abs(data[i]) > max) max = std::abs(data[i]);
       }
 
@@ -1180,11 +1135,11 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       return globalMax;
     } else {
       real p_f = static_cast<real>(p);
-      auto& data = getElementVector();
+      auto data = getData();
       real res = 0.0;
 
       // double sumIntegral = 0;
-      for (size_t i = 0; i < data.size(); ++i) {
+      for (IndexType i = 0; i < this->getNrLocalElements(); ++i) {
         auto isOnBoundary = this->isLocalLinearIndexOnBoundary(i);
         auto countBoundary = std::count(isOnBoundary.begin(), isOnBoundary.end(), true);
         double hatFcnIntegral = oneOverPowOfTwo[countBoundary];
@@ -1203,60 +1158,104 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     }
   }
 
+  /**
+   * @brief calls f(localLinearIndex, coords, hatFunctionIntegral) for every local point, in the
+   * order of the local data; the coordinates are updated incrementally, and the hat function
+   * integral is relative to an inner nodal one (cf. getLpNorm)
+   */
+  template <typename F>
+  void forEachLocalPointWithCoords(F&& f) const {
+    const auto& localSizes = this->getLocalSizes();
+    const auto& lowerBounds = this->getLowerBounds();
+    const auto& h = this->getGridSpacing();
+    if (this->getNrLocalElements() == 0) return;
+
+    IndexVector localIndex(dim_, 0);
+    std::vector<real> coords(dim_);
+    std::vector<bool> isOnBoundary(dim_);
+    auto setCoordinate = [&](DimType d) {
+      const auto globalIndex = lowerBounds[d] + localIndex[d];
+      coords[d] = static_cast<real>(globalIndex + (hasBoundaryPoints_[d] > 0 ? 0 : 1)) * h[d];
+      isOnBoundary[d] = hasBoundaryPoints_[d] == 2 &&
+                        (globalIndex == 0 || globalIndex == this->length(d) - 1);
+    };
+    for (DimType d = 0; d < dim_; ++d) setCoordinate(d);
+    auto numBoundaryDims = std::count(isOnBoundary.begin(), isOnBoundary.end(), true);
+
+    for (IndexType li = 0; li < this->getNrLocalElements(); ++li) {
+      f(li, static_cast<const std::vector<real>&>(coords), oneOverPowOfTwo[numBoundaryDims]);
+      // increment the local vector index, first dimension fastest
+      for (DimType d = 0; d < dim_; ++d) {
+        numBoundaryDims -= isOnBoundary[d];
+        if (++localIndex[d] < localSizes[d]) {
+          setCoordinate(d);
+          numBoundaryDims += isOnBoundary[d];
+          break;
+        }
+        localIndex[d] = 0;
+        setCoordinate(d);
+        numBoundaryDims += isOnBoundary[d];
+      }
+    }
+  }
+
+  /** add the local values to the accumulator, without any communication */
+  void accumulateLpNorms(LpNormAccumulator& accumulator) const {
+    const auto data = getData();
+    forEachLocalPointWithCoords(
+        [data, &accumulator](IndexType li, const std::vector<real>&, real hatFunctionIntegral) {
+          accumulator.add(std::abs(data[li]), hatFunctionIntegral);
+        });
+  }
+
+  /**
+   * @brief the maximum, 1 and 2 norm (as getLpNorm with p = 0, 1, 2), in a single pass over the
+   * data and with a single reduction
+   */
+  LpNorms getLpNorms() const {
+    std::vector<LpNormAccumulator> accumulator(1);
+    accumulateLpNorms(accumulator[0]);
+    LpNormAccumulator::allreduce(accumulator, getCommunicator());
+    return accumulator[0].getNorms(this->getInnerNodalBasisFunctionIntegral());
+  }
+
   // normalize with specific norm
   inline real normalizelp(int p) {
     real norm = getLpNorm(p);
 
-    std::vector<FG_ELEMENT>& data = getElementVector();
-    for (size_t i = 0; i < data.size(); ++i) data[i] = data[i] / norm;
+    auto data = getData();
+    const auto scaling = static_cast<typename RealTypeOf<FG_ELEMENT>::type>(1. / norm);
+    for (IndexType i = 0; i < this->getNrLocalElements(); ++i) data[i] *= scaling;
 
     return norm;
   }
 
   // multiply with a constant
   inline void mul(real c) {
-    std::vector<FG_ELEMENT>& data = getElementVector();
-    for (size_t i = 0; i < data.size(); ++i) data[i] *= c;
+    auto data = getData();
+    for (IndexType i = 0; i < this->getNrLocalElements(); ++i) data[i] *= c;
   }
 
-  // write data to file using MPI-IO
-  void writePlotFile(const char* filename) const {
-    auto dim = getDimension();
-
-    // create subarray data type
-    IndexVector sizes = getGlobalSizes();
-    IndexVector subsizes = getUpperBounds() - getLowerBounds();
-    IndexVector starts = getLowerBounds();
-
-    // we store our data in fortran notation, with the
-    // first index in indexvectors being the first dimension.
-    std::vector<int> csizes(sizes.begin(), sizes.end());
-    std::vector<int> csubsizes(subsizes.begin(), subsizes.end());
-    std::vector<int> cstarts(starts.begin(), starts.end());
-
-    // create subarray view on data
-    MPI_Datatype mysubarray;
-    MPI_Type_create_subarray(static_cast<int>(getDimension()), &csizes[0], &csubsizes[0],
-                             &cstarts[0], MPI_ORDER_FORTRAN, getMPIDatatype(), &mysubarray);
-    MPI_Type_commit(&mysubarray);
-
-    // open file
-    MPI_File fh;
-    MPI_File_open(getCommunicator(), filename, MPI_MODE_WRONLY + MPI_MODE_CREATE, MPI_INFO_NULL,
-                  &fh);
-
-    MPI_Offset offset = 0;
-
+  /**
+   * @brief write the header of the binary plot file format to an open file (or, for .raw
+   * files, to a separate human-readable _header file)
+   *
+   * @param writeHeader whether the calling process writes the header (only one should)
+   * @return the offset of the data in the file, in bytes
+   */
+  static MPI_Offset writePlotFileHeader(MPI_File fh, const std::string& filename,
+                                        const IndexVector& sizes, bool writeHeader) {
+    auto dim = static_cast<DimType>(sizes.size());
     // .raw files can be read by paraview, in that case write the header separately
-    std::string fn = filename;
-    if (fn.find(".raw") != std::string::npos){
+    MPI_Offset offset = 0;
+    if (filename.find(".raw") != std::string::npos){
       // rank 0 write human-readable header
-      if (rank_ == 0) {
-        auto headername = fn + "_header";
+      if (writeHeader) {
+        auto headername = filename + "_header";
         std::ofstream ofs(headername);
 
         // first line: dimension
-        ofs << "dimensionality " << getDimension() << std::endl;
+        ofs << "dimensionality " << dim << std::endl;
 
         // grid points per dimension in the order
         // x_0, x_1, ... , x_d
@@ -1270,10 +1269,13 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       }
     }else{
       // rank 0 write dim and resolution (and data format?)
-      if (rank_ == 0) {
+      if (writeHeader) {
         MPI_File_write(fh, &dim, 1, MPI_UNSIGNED_CHAR, MPI_STATUS_IGNORE);
 
-        std::vector<int> res(sizes.begin(), sizes.end());
+        // always six resolution entries, unused ones are zero
+        assert(dim <= 6);
+        std::vector<int> res(6, 0);
+        std::copy(sizes.begin(), sizes.end(), res.begin());
         MPI_File_write(fh, &res[0], 6, MPI_INT, MPI_STATUS_IGNORE);
       }
 
@@ -1281,6 +1283,86 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       // 1*int + dim*int = (1+dim)*sizeof(int)
       offset = (1 + dim) * sizeof(int);
     }
+    return offset;
+  }
+
+  /**
+   * @brief write the header of a legacy-type VTK file (structured points) to an open file
+   *
+   * @param writeHeader whether the calling process writes the header (only one should)
+   * @return the offset of the data in the file, in bytes
+   */
+  static MPI_Offset writePlotFileVTKHeader(MPI_File fh, const IndexVector& sizes,
+                                           bool writeHeader) {
+    auto dim = static_cast<DimType>(sizes.size());
+    std::stringstream vtk_header;
+    // cf https://lorensen.github.io/VTKExamples/site/VTKFileFormats/ => structured points
+    vtk_header << "# vtk DataFile Version 2.0.\n"
+               << "This file contains the combination solution evaluated on a full grid\n"
+               << "BINARY\n"
+               << "DATASET STRUCTURED_POINTS\n";
+    if (dim == 3) { //TODO change for non-boundary grids using getGridSpacing
+      vtk_header << "DIMENSIONS " << sizes[0]  << " " << sizes[1]  << " " << sizes[2] << "\n"
+                 << "ORIGIN 0 0 0\n"
+                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " " << 1. / static_cast<double>(sizes[1]-1)  << " " << 1. / static_cast<double>(sizes[2]-1) << "\n";
+    } else if (dim == 2) {
+      vtk_header << "DIMENSIONS " << sizes[0]  << " " << sizes[1]  << " 1\n"
+                 << "ORIGIN 0 0 0\n"
+                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " " << 1. / static_cast<double>(sizes[1]-1)  << " 1\n";
+    } else if (dim == 1) {
+      vtk_header << "DIMENSIONS " << sizes[0]  << " 1 1\n"
+                 << "ORIGIN 0 0 0\n"
+                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " 1 1\n";
+    } else {
+      assert(false);
+    }
+    vtk_header << "POINT_DATA "
+               << std::accumulate(sizes.begin(), sizes.end(), 1, std::multiplies<IndexType>())
+               << "\n"
+               << "SCALARS quantity "
+               << (std::is_same<FG_ELEMENT, float>::value ? "float" : "double") << " 1\n"
+               << "LOOKUP_TABLE default\n";
+    // only real single and double precision values can be written to VTK
+    bool rightDataType =
+        std::is_same<FG_ELEMENT, float>::value || std::is_same<FG_ELEMENT, double>::value;
+    assert(rightDataType);
+    auto header_string = vtk_header.str();
+    auto header_size = header_string.size();
+
+    // rank 0 write header
+    if (writeHeader) {
+      MPI_File_write(fh, header_string.data(), static_cast<int>(header_size), MPI_CHAR, MPI_STATUS_IGNORE);
+    }
+
+    // file view offset (in bytes)
+    return header_size * sizeof(char);
+  }
+
+  // write data to file using MPI-IO
+  void writePlotFile(const char* filename) const {
+    // create subarray data type
+    IndexVector sizes = getGlobalSizes();
+    IndexVector subsizes = getUpperBounds() - getLowerBounds();
+    IndexVector starts = getLowerBounds();
+
+    // we store our data in fortran notation, with the
+    // first index in indexvectors being the first dimension.
+    std::vector<int> csizes(sizes.begin(), sizes.end());
+    std::vector<int> csubsizes(subsizes.begin(), subsizes.end());
+    std::vector<int> cstarts(starts.begin(), starts.end());
+
+    // create subarray view on data
+    MPI_Datatype mysubarray;
+    MPI_Type_create_subarray(static_cast<int>(getDimension()), &csizes[0], &csubsizes[0],
+                             &cstarts[0], MPI_ORDER_FORTRAN, getMPIDatatype(), &mysubarray);
+    MPI_Type_commit(&mysubarray);
+
+    // open file
+    MPI_File fh;
+    MPI_File_open(getCommunicator(), filename, MPI_MODE_WRONLY + MPI_MODE_CREATE, MPI_INFO_NULL,
+                  &fh);
+
+    MPI_Offset offset = writePlotFileHeader(fh, filename, sizes, rank_ == 0);
 
     MPI_File_set_view(fh, offset, getMPIDatatype(), mysubarray, "native", MPI_INFO_NULL);
 
@@ -1318,45 +1400,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     MPI_File_open(getCommunicator(), filename, MPI_MODE_WRONLY + MPI_MODE_CREATE, MPI_INFO_NULL,
                   &fh);
 
-    std::stringstream vtk_header;
-    // cf https://lorensen.github.io/VTKExamples/site/VTKFileFormats/ => structured points
-    vtk_header << "# vtk DataFile Version 2.0.\n"
-               << "This file contains the combination solution evaluated on a full grid\n"
-               << "BINARY\n"
-               << "DATASET STRUCTURED_POINTS\n";
-    if (dim == 3) { //TODO change for non-boundary grids using getGridSpacing
-      vtk_header << "DIMENSIONS " << sizes[0]  << " " << sizes[1]  << " " << sizes[2] << "\n"
-                 << "ORIGIN 0 0 0\n"
-                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " " << 1. / static_cast<double>(sizes[1]-1)  << " " << 1. / static_cast<double>(sizes[2]-1) << "\n";
-    } else if (dim == 2) {
-      vtk_header << "DIMENSIONS " << sizes[0]  << " " << sizes[1]  << " 1\n"
-                 << "ORIGIN 0 0 0\n"
-                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " " << 1. / static_cast<double>(sizes[1]-1)  << " 1\n";
-    } else if (dim == 1) {
-      vtk_header << "DIMENSIONS " << sizes[0]  << " 1 1\n"
-                 << "ORIGIN 0 0 0\n"
-                 << "SPACING " << 1. / static_cast<double>(sizes[0]-1)  << " 1 1\n";
-    } else {
-      assert(false);
-    }
-    vtk_header << "POINT_DATA "
-               << std::accumulate(sizes.begin(), sizes.end(), 1, std::multiplies<IndexType>())
-               << "\n"
-               << "SCALARS quantity double 1\n"
-               << "LOOKUP_TABLE default\n";
-    //TODO set the right data type from combidatatype, for now double by default
-    bool rightDataType = std::is_same<CombiDataType, double>::value;
-    assert(rightDataType);
-    auto header_string = vtk_header.str();
-    auto header_size = header_string.size();
-
-    // rank 0 write header
-    if (rank_ == 0) {
-      MPI_File_write(fh, header_string.data(), static_cast<int>(header_size), MPI_CHAR, MPI_STATUS_IGNORE);
-    }
-
-    // set file view to right offset (in bytes)
-    MPI_Offset offset = header_size * sizeof(char);
+    MPI_Offset offset = writePlotFileVTKHeader(fh, sizes, rank_ == 0);
     // external32 not supported in OpenMPI < 5. -> writes "native" endianness
     // might work with MPICH
     MPI_File_set_view(fh, offset, getMPIDatatype(), mysubarray, "external32", MPI_INFO_NULL);
@@ -1396,7 +1440,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     return mysubarray;
   }
 
-  std::vector<MPI_Datatype> getUpwardSubarrays() {
+  const std::vector<MPI_Datatype>& getUpwardSubarrays() {
     // initialize upwardSubarrays_ only once
     if (upwardSubarrays_.size() == 0) {
       upwardSubarrays_.resize(this->getDimension());
@@ -1433,7 +1477,28 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     return mysubarray;
   }
 
-  std::vector<MPI_Datatype> getDownwardSubarrays() {
+  /** the subarray views of all ranks' parts on a full grid, created only once */
+  const std::vector<MPI_Datatype>& getGatherSubarrays() {
+    if (gatherSubarrays_.empty()) {
+      std::vector<int> csizes(nrPoints_.begin(), nrPoints_.end());
+      for (RankType r = 0; r < this->getCommunicatorSize(); ++r) {
+        IndexVector subsizes = this->getUpperBounds(r) - this->getLowerBounds(r);
+        IndexVector starts = this->getLowerBounds(r);
+        std::vector<int> csubsizes(subsizes.begin(), subsizes.end());
+        std::vector<int> cstarts(starts.begin(), starts.end());
+
+        MPI_Datatype subarray;
+        MPI_Type_create_subarray(static_cast<int>(this->getDimension()), csizes.data(),
+                                 csubsizes.data(), cstarts.data(), MPI_ORDER_FORTRAN,
+                                 this->getMPIDatatype(), &subarray);
+        MPI_Type_commit(&subarray);
+        gatherSubarrays_.push_back(subarray);
+      }
+    }
+    return gatherSubarrays_;
+  }
+
+  const std::vector<MPI_Datatype>& getDownwardSubarrays() {
     // initialize downwardSubarrays_ only once
     if (downwardSubarrays_.size() == 0) {
       downwardSubarrays_.resize(this->getDimension());
@@ -1473,9 +1538,9 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   void writeUpperBoundaryToLowerBoundary(DimType d) {
     assert(hasBoundaryPoints_[d] == 2);
 
-    // create MPI datatypes
-    auto downSubarray = getDownwardSubarray(d);
-    auto upSubarray = getUpwardSubarray(d);
+    // cached MPI datatypes
+    const auto& downSubarray = getDownwardSubarrays()[d];
+    const auto& upSubarray = getUpwardSubarrays()[d];
 
     // if I have the lowest neighbor (i. e. I am the highest rank), I need to send my highest layer in d to them,
     // if I have the highest neighbor (i. e. I am the lowest rank), I can receive it
@@ -1486,16 +1551,15 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
         MPI_Sendrecv(this->getData(), 1, upSubarray, lower, TRANSFER_GHOST_LAYER_TAG,
                      this->getData(), 1, downSubarray, higher,
                      TRANSFER_GHOST_LAYER_TAG, this->getCommunicator(), MPI_STATUS_IGNORE);
-    MPI_Type_free(&downSubarray);
-    MPI_Type_free(&upSubarray);
+    assert(success == MPI_SUCCESS);
   }
 
   void writeLowerBoundaryToUpperBoundary(DimType d) {
     assert(hasBoundaryPoints_[d] == 2);
 
-    // create MPI datatypes
-    auto downSubarray = getDownwardSubarray(d);
-    auto upSubarray = getUpwardSubarray(d);
+    // cached MPI datatypes
+    const auto& downSubarray = getDownwardSubarrays()[d];
+    const auto& upSubarray = getUpwardSubarrays()[d];
 
     // if I have the highest neighbor (i. e. I am the lowest rank), I need to send my lowest layer in d to them,
     // if I have the lowest neighbor (i. e. I am the highest rank), I can receive it
@@ -1508,8 +1572,6 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
                      this->getData(), 1, upSubarray, lower,
                      TRANSFER_GHOST_LAYER_TAG, this->getCommunicator(), MPI_STATUS_IGNORE);
     assert(success == MPI_SUCCESS);
-    MPI_Type_free(&downSubarray);
-    MPI_Type_free(&upSubarray);
   }
 
   void exchangeBoundaryLayers(DimType d, std::vector<FG_ELEMENT>& recvbufferFromUp,
@@ -1520,9 +1582,9 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     auto numElements = std::accumulate(subarrayExtents.begin(), subarrayExtents.end(), 1,
                                        std::multiplies<IndexType>());
 
-    // create MPI datatypes
-    auto downSubarray = getDownwardSubarray(d);
-    auto upSubarray = getUpwardSubarray(d);
+    // cached MPI datatypes
+    const auto& downSubarray = getDownwardSubarrays()[d];
+    const auto& upSubarray = getUpwardSubarrays()[d];
 
     // if I have the highest neighbor (i. e. I am the lowest rank), I need to send my lowest layer
     // in d to them, if I have the lowest neighbor (i. e. I am the highest rank), I can receive it
@@ -1553,8 +1615,6 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
                            this->getMPIDatatype(), higher, TRANSFER_GHOST_LAYER_TAG,
                            this->getCommunicator(), MPI_STATUS_IGNORE);
     assert(success == MPI_SUCCESS);
-    MPI_Type_free(&downSubarray);
-    MPI_Type_free(&upSubarray);
   }
 
   // non-RVO dependent version of ghost layer exchange
@@ -1564,8 +1624,8 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     subarrayExtents.assign(this->getLocalSizes().begin(), this->getLocalSizes().end());
     subarrayExtents[d] = 1;
 
-    // create MPI datatype
-    auto subarray = getUpwardSubarray(d);
+    // the datatype is created once and cached
+    const auto& subarray = getUpwardSubarrays()[d];
 
     // if I have a higher neighbor, I need to send my highest layer in d to them,
     // if I have a lower neighbor, I can receive it
@@ -1610,7 +1670,6 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
                      recvbuffer.data(), numElements, this->getMPIDatatype(), lower,
                      TRANSFER_GHOST_LAYER_TAG, this->getCommunicator(), MPI_STATUS_IGNORE);
     assert(success == MPI_SUCCESS);
-    MPI_Type_free(&subarray);
   }
 
   std::vector<FG_ELEMENT> exchangeGhostLayerUpward(DimType d, std::vector<int>& subarrayExtents) {
@@ -1620,13 +1679,14 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   }
 
   void averageBoundaryValues(DimType d) {
+    const typename RealTypeOf<FG_ELEMENT>::type half = 0.5;
     std::vector<FG_ELEMENT> recvbufferFromUp, recvbufferFromDown;
     // exchanges just like in the ghost layer exchange, but across boundary
+    // (the exchange is blocking, so no further synchronization is needed)
     exchangeBoundaryLayers(d, recvbufferFromUp, recvbufferFromDown);
-    MPI_Barrier(this->getCommunicator());
     // get MPI datatypes
-    auto downSubarrays = getDownwardSubarrays();
-    auto upSubarrays = getUpwardSubarrays();
+    const auto& downSubarrays = getDownwardSubarrays();
+    const auto& upSubarrays = getUpwardSubarrays();
 
     // if both lower and higher are set, it's only me and I can just average
     // not strictly necessary but good to test the iterators
@@ -1642,7 +1702,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       while (!downIt.isAtEnd()) {
         assert(initialIndexDiff == upIt.getIndex() - downIt.getIndex());
         assert(upIt.getIndex() >= initialUpIndex);
-        auto avg = 0.5 * ((*upIt) + (*downIt));
+        FG_ELEMENT avg = half * ((*upIt) + (*downIt));
         *upIt = avg;
         *downIt = avg;
         ++downIt;
@@ -1655,7 +1715,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       SubarrayIterator downIt(downSubarrays[d], *this);
       auto upIt = recvbufferFromUp.begin();
       while (!downIt.isAtEnd()) {
-        auto avg = 0.5 * ((*upIt) + (*downIt));
+        FG_ELEMENT avg = half * ((*upIt) + (*downIt));
         *downIt = avg;
         ++downIt;
         ++upIt;
@@ -1665,7 +1725,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       SubarrayIterator upIt(upSubarrays[d], *this);
       auto downIt = recvbufferFromDown.begin();
       while (!upIt.isAtEnd()) {
-        auto avg = 0.5 * ((*upIt) + (*downIt));
+        FG_ELEMENT avg = half * ((*upIt) + (*downIt));
         *upIt = avg;
         ++downIt;
         ++upIt;
@@ -1770,7 +1830,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
         bool present = getLocalVectorIndex(corners[cornerNo], locAxisIndex);
         assert(present);
         auto index = getLocalLinearIndex(locAxisIndex);
-        values[cornerNo] = this->getElementVector()[index];
+        values[cornerNo] = this->getData()[index];
       }
     }
     MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()),
@@ -1783,6 +1843,114 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   }
 
  private:
+  /** the largest dimension evalCell can handle without compile-time dimension */
+  static constexpr DimType maxEvalDimension = 32;
+
+  /**
+   * @brief calls function with std::integral_constant<DimType, dim_> for the dimensions the
+   * evaluation kernel is specialized for, and with the constant 0 otherwise
+   */
+  template <typename Function>
+  inline void dispatchEvalDimension(Function&& function) const {
+    switch (dim_) {
+      case 1:
+        function(std::integral_constant<DimType, 1>());
+        break;
+      case 2:
+        function(std::integral_constant<DimType, 2>());
+        break;
+      case 3:
+        function(std::integral_constant<DimType, 3>());
+        break;
+      case 4:
+        function(std::integral_constant<DimType, 4>());
+        break;
+      case 5:
+        function(std::integral_constant<DimType, 5>());
+        break;
+      case 6:
+        function(std::integral_constant<DimType, 6>());
+        break;
+      default:
+        function(std::integral_constant<DimType, 0>());
+    }
+  }
+
+  /**
+   * @brief adds the local part of the multilinear interpolation on coords to value
+   *
+   * Computes the linear offsets and hat function weights of the lower and upper neighbor point
+   * once per dimension, and enumerates the 2^d corners of the cell by the bits of the corner
+   * number.
+   *
+   * @tparam D the dimension of the grid, or 0 if it is only known at run time
+   * @return whether any corner of the cell is on this process
+   */
+  template <DimType D>
+  bool evalCell(const std::vector<real>& coords, FG_ELEMENT& value) const {
+    static_assert(D <= maxEvalDimension, "dimension too large for the evaluation kernel");
+    constexpr DimType arraySize = D > 0 ? D : maxEvalDimension;
+    const DimType dim = D > 0 ? D : dim_;
+    assert(dim == dim_);
+    // the run time dimension has to fit into the arrays below
+    if (D == 0 && dim > maxEvalDimension) {
+      throw std::runtime_error("evalCell: dimension " + std::to_string(dim) +
+                               " is larger than maxEvalDimension");
+    }
+    assert(coords.size() == dim);
+
+    // per dimension: local linear offsets and weights of the lower / upper corner of the cell,
+    // and whether they are on this process
+    std::array<IndexType, 2 * arraySize> cornerOffsets;
+    std::array<real, 2 * arraySize> cornerWeights;
+    std::array<bool, 2 * arraySize> cornerIsLocal;
+    bool allCornersLocal = true;
+    for (DimType d = 0; d < dim; ++d) {
+      assert(coords[d] >= 0. && coords[d] <= 1.);
+      // index of the lower neighbor point, counted from coordinate 0
+      const real scaledCoord = coords[d] / gridSpacing_[d];
+      const auto lowerPoint = static_cast<IndexType>(std::floor(scaledCoord));
+      cornerWeights[2 * d + 1] = scaledCoord - static_cast<real>(lowerPoint);
+      cornerWeights[2 * d] = 1. - cornerWeights[2 * d + 1];
+      bool anyLocal = false;
+      for (int side = 0; side < 2; ++side) {
+        IndexType globalIndex = lowerPoint + side - (hasBoundaryPoints_[d] > 0 ? 0 : 1);
+        if (hasBoundaryPoints_[d] == 1) {
+          // periodic: the point past the last one is the first one
+          globalIndex = (globalIndex + nrPoints_[d]) % nrPoints_[d];
+        }
+        const IndexType localIndex = globalIndex - myPartitionsLowerBounds_[d];
+        const bool isLocal = globalIndex >= 0 && globalIndex < nrPoints_[d] && localIndex >= 0 &&
+                             localIndex < nrLocalPoints_[d];
+        cornerIsLocal[2 * d + side] = isLocal;
+        cornerOffsets[2 * d + side] = isLocal ? localIndex * localOffsets_[d] : 0;
+        anyLocal = anyLocal || isLocal;
+        allCornersLocal = allCornersLocal && isLocal;
+      }
+      if (!anyLocal) return false;
+    }
+
+    const size_t numCorners = static_cast<size_t>(1) << dim;
+    FG_ELEMENT sum = 0.;
+    for (size_t corner = 0; corner < numCorners; ++corner) {
+      IndexType linearIndex = 0;
+      real weight = 1.;
+      bool isLocal = true;
+      for (DimType d = 0; d < dim; ++d) {
+        const auto side = 2 * d + ((corner >> d) & 1);
+        isLocal = allCornersLocal || (isLocal && cornerIsLocal[side]);
+        linearIndex += cornerOffsets[side];
+        weight *= cornerWeights[side];
+      }
+      if (isLocal) {
+        sum += static_cast<typename RealTypeOf<FG_ELEMENT>::type>(weight) *
+               this->getData()[linearIndex];
+      }
+    }
+    value += sum;
+    return true;
+  }
+
   /** dimension of the full grid */
   DimType dim_;
 
@@ -1817,7 +1985,13 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   IndexVector myPartitionsUpperBounds_;
 
   /** the full grid vector, this contains the elements of the full grid */
-  std::vector<FG_ELEMENT> fullgridVector_;
+  GridVector<FG_ELEMENT> fullgridVector_;
+
+  /** if set, the (not owned) local data used instead of fullgridVector_ */
+  FG_ELEMENT* externalData_ = nullptr;
+
+  /** accounts for the size of fullgridVector_ in the MemoryTracker */
+  TrackedMemory fullgridVectorMemory_{MemoryCategory::fullGrids};
 
   /** Variables for the distributed Full Grid*/
   /** Cartesien MPI Communicator  */
@@ -1843,6 +2017,16 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
   std::vector<MPI_Datatype> downwardSubarrays_;
   std::vector<MPI_Datatype> upwardSubarrays_;
 
+  // the MPI Datatypes of all processes' parts in the gathered full grid
+  std::vector<MPI_Datatype> gatherSubarrays_;
+
+  // the arguments to the non-blocking gather, which have to stay valid until its completion
+  std::vector<int> gatherSendCounts_;
+  std::vector<int> gatherRecvCounts_;
+  std::vector<int> gatherDisplacements_;
+  std::vector<MPI_Datatype> gatherSendTypes_;
+  std::vector<MPI_Datatype> gatherRecvTypes_;
+
   /** number of local (in this grid cell) points per axis*/
   IndexVector nrLocalPoints_;
 
@@ -1966,7 +2150,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
       IndexType offset = localOffsets_[1] * i;
 
       for (IndexType j = 0; j < nrLocalPoints_[0]; ++j) {
-        os << fullgridVector_[offset + j] << "\t";
+        os << this->getData()[offset + j] << "\t";
       }
 
       os << std::endl;
@@ -1978,7 +2162,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
     assert(dim_ == 1);
 
     for (IndexType j = 0; j < nrLocalPoints_[0]; ++j) {
-      os << fullgridVector_[j] << "\t";
+      os << this->getData()[j] << "\t";
     }
 
     os << std::endl;
@@ -1998,7 +2182,7 @@ class SubarrayIterator : public SliceIterator<FG_ELEMENT> {
         IndexType offset = offsetZ + localOffsets_[1] * i;
 
         for (IndexType j = 0; j < nrLocalPoints_[0]; ++j) {
-          os << fullgridVector_[offset + j] << "\t";
+          os << this->getData()[offset + j] << "\t";
         }
 
         os << std::endl;
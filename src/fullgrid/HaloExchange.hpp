@@ -0,0 +1,236 @@
+#ifndef HALOEXCHANGE_HPP_
+#define HALOEXCHANGE_HPP_
+
+#include <cassert>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "mpi/MPITags.hpp"
+#include "utils/Config.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief reusable exchange of the ghost layers of a DistributedFullGrid with all its neighbors
+ *
+ * For every dimension, the outermost ghostWidth layers of the local part are sent to the lower
+ * and higher neighbor in the grid's cartesian communicator, and the neighbors' layers are
+ * received into contiguous buffers (in the same, first-dimension-fastest ordering as the grid,
+ * with extent ghostWidth in the exchanged dimension). All transfers are persistent requests that
+ * are started at once, so a solver can compute on the interior points between start() and
+ * finish():
+ *
+ *   HaloExchange<real> halo(dfg);
+ *   for (each time step) {
+ *     halo.start();
+ *     // update the points that do not need ghost values
+ *     halo.finish();
+ *     // update the points next to the process boundary, with halo.getLowerGhostLayer(d) ...
+ *   }
+ *
+ * The datatypes and requests are created once. The send requests are kept per data buffer of
+ * the grid, for up to two buffers, so a double-buffered time stepping that swaps the grid's
+ * data every step reuses them; only a third buffer replaces the least recently used set.
+ * Without neighbor in a direction (non-periodic process boundaries), the ghost layer is empty.
+ */
+template <typename FG_ELEMENT>
+class HaloExchange {
+ public:
+  explicit HaloExchange(DistributedFullGrid<FG_ELEMENT>& dfg, IndexType ghostWidth = 1)
+      : dfg_(dfg), ghostWidth_(ghostWidth) {
+    const auto dim = dfg_.getDimension();
+    assert(ghostWidth_ > 0);
+    lowerNeighbors_.resize(dim);
+    higherNeighbors_.resize(dim);
+    lowerLayers_.resize(dim);
+    upperLayers_.resize(dim);
+    lowerGhostLayers_.resize(dim);
+    upperGhostLayers_.resize(dim);
+    ghostLayerOffsets_.resize(dim);
+    recvRequests_.resize(2 * dim);
+
+    for (DimType d = 0; d < dim; ++d) {
+      assert(dfg_.getLocalSizes()[d] >= ghostWidth_);
+      // the cartesian directions in the communicator may be reversed, cf. DFG's InitMPI
+      auto d_reverse = reverseOrderingDFGPartitions ? dim - d - 1 : d;
+      MPI_Cart_shift(dfg_.getCommunicator(), static_cast<int>(d_reverse), 1, &lowerNeighbors_[d],
+                     &higherNeighbors_[d]);
+
+      lowerLayers_[d] = createLayerSubarray(d, 0);
+      upperLayers_[d] = createLayerSubarray(d, dfg_.getLocalSizes()[d] - ghostWidth_);
+
+      IndexVector extents = dfg_.getLocalSizes();
+      extents[d] = ghostWidth_;
+      ghostLayerOffsets_[d].resize(dim);
+      IndexType numElements = 1;
+      for (DimType j = 0; j < dim; ++j) {
+        ghostLayerOffsets_[d][j] = numElements;
+        numElements *= extents[j];
+      }
+      lowerGhostLayers_[d].resize(lowerNeighbors_[d] == MPI_PROC_NULL ? 0 : numElements);
+      upperGhostLayers_[d].resize(higherNeighbors_[d] == MPI_PROC_NULL ? 0 : numElements);
+
+      // the lower ghost layer is the lower neighbor's upper layer, sent upward
+      MPI_Recv_init(lowerGhostLayers_[d].data(), static_cast<int>(lowerGhostLayers_[d].size()),
+                    dfg_.getMPIDatatype(), lowerNeighbors_[d], getTag(d, true),
+                    dfg_.getCommunicator(), &recvRequests_[2 * d]);
+      MPI_Recv_init(upperGhostLayers_[d].data(), static_cast<int>(upperGhostLayers_[d].size()),
+                    dfg_.getMPIDatatype(), higherNeighbors_[d], getTag(d, false),
+                    dfg_.getCommunicator(), &recvRequests_[2 * d + 1]);
+    }
+  }
+
+  HaloExchange(const HaloExchange& other) = delete;
+  HaloExchange& operator=(const HaloExchange& other) = delete;
+
+  ~HaloExchange() {
+    if (active_) finish();
+    freeRequests(recvRequests_);
+    for (auto& sendRequests : sendRequestSets_) freeRequests(sendRequests.second);
+    for (auto& type : lowerLayers_) MPI_Type_free(&type);
+    for (auto& type : upperLayers_) MPI_Type_free(&type);
+  }
+
+  /** start sending the boundary layers and receiving the ghost layers in all dimensions */
+  void start() {
+    assert(!active_);
+    auto& sendRequests = getSendRequests();
+    MPI_Startall(static_cast<int>(recvRequests_.size()), recvRequests_.data());
+    MPI_Startall(static_cast<int>(sendRequests.size()), sendRequests.data());
+    active_ = true;
+  }
+
+  /** wait for the exchange; afterwards, the ghost layers are valid and the grid may be changed */
+  void finish() {
+    assert(active_);
+    MPI_Waitall(static_cast<int>(recvRequests_.size()), recvRequests_.data(),
+                MPI_STATUSES_IGNORE);
+    auto& sendRequests = sendRequestSets_[activeSendRequestSet_].second;
+    MPI_Waitall(static_cast<int>(sendRequests.size()), sendRequests.data(), MPI_STATUSES_IGNORE);
+    active_ = false;
+  }
+
+  /** start() and finish() */
+  void exchange() {
+    start();
+    finish();
+  }
+
+  inline bool isActive() const { return active_; }
+
+  inline IndexType getGhostWidth() const { return ghostWidth_; }
+
+  /**
+   * @brief the ghostWidth layers below the local part in dimension d, from the lower neighbor
+   * (index 0 in d is the point ghostWidth below the lowest local one); empty if there is no
+   * lower neighbor
+   */
+  inline const std::vector<FG_ELEMENT>& getLowerGhostLayer(DimType d) const {
+    assert(!active_);
+    return lowerGhostLayers_[d];
+  }
+
+  /** the ghostWidth layers above the local part in dimension d, from the higher neighbor */
+  inline const std::vector<FG_ELEMENT>& getUpperGhostLayer(DimType d) const {
+    assert(!active_);
+    return upperGhostLayers_[d];
+  }
+
+  /** the strides of the ghost layers in dimension d, to linearize local axis indices */
+  inline const IndexVector& getGhostLayerOffsets(DimType d) const { return ghostLayerOffsets_[d]; }
+
+  inline bool hasLowerNeighbor(DimType d) const { return lowerNeighbors_[d] != MPI_PROC_NULL; }
+
+  inline bool hasHigherNeighbor(DimType d) const { return higherNeighbors_[d] != MPI_PROC_NULL; }
+
+  /** the number of data buffers for which send requests are kept */
+  inline size_t getNumSendRequestSets() const { return sendRequestSets_.size(); }
+
+ private:
+  // two tags per dimension, counting down from TRANSFER_HALO_TAG
+  static inline int getTag(DimType d, bool upward) {
+    return TRANSFER_HALO_TAG - 2 * static_cast<int>(d) - (upward ? 0 : 1);
+  }
+
+  MPI_Datatype createLayerSubarray(DimType d, IndexType start) const {
+    std::vector<int> sizes(dfg_.getLocalSizes().begin(), dfg_.getLocalSizes().end());
+    std::vector<int> subsizes = sizes;
+    subsizes[d] = static_cast<int>(ghostWidth_);
+    std::vector<int> starts(dfg_.getDimension(), 0);
+    starts[d] = static_cast<int>(start);
+    MPI_Datatype subarray;
+    MPI_Type_create_subarray(static_cast<int>(dfg_.getDimension()), sizes.data(),
+                             subsizes.data(), starts.data(), MPI_ORDER_FORTRAN,
+                             dfg_.getMPIDatatype(), &subarray);
+    MPI_Type_commit(&subarray);
+    return subarray;
+  }
+
+  static void freeRequests(std::vector<MPI_Request>& requests) {
+    for (auto& request : requests) {
+      if (request != MPI_REQUEST_NULL) MPI_Request_free(&request);
+    }
+  }
+
+  // the send requests for the grid's current data, created at the first use of that buffer
+  std::vector<MPI_Request>& getSendRequests() {
+    const FG_ELEMENT* sendData = dfg_.getData();
+    for (size_t i = 0; i < sendRequestSets_.size(); ++i) {
+      if (sendRequestSets_[i].first == sendData) {
+        activeSendRequestSet_ = i;
+        return sendRequestSets_[i].second;
+      }
+    }
+    if (sendRequestSets_.size() < maxNumSendRequestSets) {
+      sendRequestSets_.emplace_back();
+      activeSendRequestSet_ = sendRequestSets_.size() - 1;
+    } else {
+      // replace the set that was not used last
+      activeSendRequestSet_ = 1 - activeSendRequestSet_;
+      freeRequests(sendRequestSets_[activeSendRequestSet_].second);
+    }
+    auto& sendRequestSet = sendRequestSets_[activeSendRequestSet_];
+    sendRequestSet.first = sendData;
+    const auto dim = dfg_.getDimension();
+    sendRequestSet.second.resize(2 * dim);
+    for (DimType d = 0; d < dim; ++d) {
+      MPI_Send_init(sendData, 1, upperLayers_[d], higherNeighbors_[d], getTag(d, true),
+                    dfg_.getCommunicator(), &sendRequestSet.second[2 * d]);
+      MPI_Send_init(sendData, 1, lowerLayers_[d], lowerNeighbors_[d], getTag(d, false),
+                    dfg_.getCommunicator(), &sendRequestSet.second[2 * d + 1]);
+    }
+    return sendRequestSet.second;
+  }
+
+  static constexpr size_t maxNumSendRequestSets = 2;
+
+  DistributedFullGrid<FG_ELEMENT>& dfg_;
+
+  IndexType ghostWidth_;
+
+  std::vector<int> lowerNeighbors_;
+  std::vector<int> higherNeighbors_;
+
+  // the subarrays of the local data to send
+  std::vector<MPI_Datatype> lowerLayers_;
+  std::vector<MPI_Datatype> upperLayers_;
+
+  std::vector<std::vector<FG_ELEMENT>> lowerGhostLayers_;
+  std::vector<std::vector<FG_ELEMENT>> upperGhostLayers_;
+  std::vector<IndexVector> ghostLayerOffsets_;
+
+  std::vector<MPI_Request> recvRequests_;
+
+  // the send requests per data buffer of the grid, and the one of the current exchange
+  std::vector<std::pair<const FG_ELEMENT*, std::vector<MPI_Request>>> sendRequestSets_;
+  size_t activeSendRequestSet_ = 0;
+
+  bool active_ = false;
+};
+
+}  // namespace combigrid
+
+#endif /* HALOEXCHANGE_HPP_ */
@@ -1,6 +1,7 @@
 #pragma once
 #include <cassert>
 
+#include "utils/GridAllocator.hpp"
 #include "utils/IndexVector.hpp"
 #include "utils/Types.hpp"
 
@@ -16,7 +17,7 @@ class SliceIterator {
   using reference = FG_ELEMENT&;
 
   SliceIterator(const std::vector<int>& subsizes, const std::vector<int>& starts,
-                const IndexVector& offsets, std::vector<FG_ELEMENT>* dataPointer)
+                const IndexVector& offsets, GridVector<FG_ELEMENT>* dataPointer)
       : currentLocalIndex_(starts),
         subsizes_(subsizes),
         starts_(starts),
@@ -135,7 +136,7 @@ class SliceIterator {
   std::vector<int> subsizes_;
   std::vector<int> starts_;
   IndexVector offsets_;
-  std::vector<FG_ELEMENT>* dataPointer_;
+  GridVector<FG_ELEMENT>* dataPointer_;
   IndexType linearEndIndex_ = -1;
 };
 
@@ -143,7 +144,7 @@ template <typename FG_ELEMENT>
 class LowestSliceIterator : public SliceIterator<FG_ELEMENT> {
  public:
   LowestSliceIterator(DimType dimOfZeroIndex, const std::vector<int>& subsizes,
-                      const IndexVector& offsets, std::vector<FG_ELEMENT>* dataPointer)
+                      const IndexVector& offsets, GridVector<FG_ELEMENT>* dataPointer)
       : SliceIterator<FG_ELEMENT>() {
     //always starts in lowest corner in all dimensions, i.e. starts_ = 0
     DimType dim = static_cast<DimType>(offsets.size());
@@ -0,0 +1,209 @@
+#ifndef STENCILSWEEP_HPP_
+#define STENCILSWEEP_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "fullgrid/HaloExchange.hpp"
+#include "utils/GridAllocator.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/** one neighbor of a linear stencil: the point offset grid points away in dimension d */
+template <typename FG_ELEMENT>
+struct StencilTap {
+  DimType d;
+  IndexType offset;
+  FG_ELEMENT weight;
+};
+
+/**
+ * @brief applies a constant-coefficient, axis-aligned linear stencil to a DistributedFullGrid
+ *
+ *   out[i] = centerWeight * in[i] + sum_taps weight * in[i + offset * e_d]
+ *
+ * The local part is split into the interior, where all neighbors are local and which is swept
+ * in unit-stride lines along the first dimension (vectorized, and threaded over the lines with
+ * OpenMP), and the boundary shell, where the neighbors are taken from the ghost layers of a
+ * HaloExchange with a ghost width of at least the largest offset. With apply(), the interior is
+ * computed while the ghost layers are exchanged.
+ *
+ * Points whose stencil leaves the global domain (non-periodic boundaries without neighbor) are
+ * copied unchanged, i.e. they act as Dirichlet boundary. in and out must not overlap.
+ */
+template <typename FG_ELEMENT>
+class StencilSweep {
+ public:
+  StencilSweep(const DistributedFullGrid<FG_ELEMENT>& dfg, FG_ELEMENT centerWeight,
+               std::vector<StencilTap<FG_ELEMENT>> taps)
+      : dfg_(dfg),
+        centerWeight_(centerWeight),
+        taps_(std::move(taps)),
+        localSizes_(dfg.getLocalSizes()),
+        localOffsets_(dfg.getLocalOffsets()) {
+    const auto dim = dfg_.getDimension();
+    IndexVector lowerWidth(dim, 0), upperWidth(dim, 0);
+    for (const auto& tap : taps_) {
+      assert(tap.d < dim);
+      lowerWidth[tap.d] = std::max(lowerWidth[tap.d], -tap.offset);
+      upperWidth[tap.d] = std::max(upperWidth[tap.d], tap.offset);
+      tapLinearOffsets_.push_back(tap.offset * localOffsets_[tap.d]);
+      maxOffset_ = std::max(maxOffset_, std::max(tap.offset, -tap.offset));
+    }
+    interiorLower_ = lowerWidth;
+    interiorUpper_.resize(dim);
+    numInteriorLines_ = 1;
+    for (DimType d = 0; d < dim; ++d) {
+      interiorUpper_[d] = std::max(interiorLower_[d], localSizes_[d] - upperWidth[d]);
+      if (d > 0) numInteriorLines_ *= interiorUpper_[d] - interiorLower_[d];
+    }
+    if (interiorUpper_[0] == interiorLower_[0]) numInteriorLines_ = 0;
+  }
+
+  /**
+   * @brief out = stencil(grid data): start the halo exchange, sweep the interior, then the
+   * boundary shell once the ghost layers have arrived
+   */
+  void apply(HaloExchange<FG_ELEMENT>& halo, GridVector<FG_ELEMENT>& out) const {
+    out.resize(dfg_.getNrLocalElements());
+    halo.start();
+    applyInterior(dfg_.getData(), out.data());
+    halo.finish();
+    applyBoundary(dfg_.getData(), halo, out.data());
+  }
+
+  /** the points whose neighbors are all local, does not need any ghost values */
+  void applyInterior(const FG_ELEMENT* in, FG_ELEMENT* out) const {
+    const IndexType begin = interiorLower_[0];
+    const IndexType end = interiorUpper_[0];
+    const auto numTaps = static_cast<IndexType>(taps_.size());
+    const FG_ELEMENT centerWeight = centerWeight_;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif  // _OPENMP
+    for (IndexType line = 0; line < numInteriorLines_; ++line) {
+      const IndexType lineOffset = getInteriorLineOffset(line);
+      const FG_ELEMENT* lineIn = in + lineOffset;
+      FG_ELEMENT* lineOut = out + lineOffset;
+#ifdef _OPENMP
+#pragma omp simd
+#endif  // _OPENMP
+      for (IndexType i = begin; i < end; ++i) {
+        lineOut[i] = centerWeight * lineIn[i];
+      }
+      for (IndexType t = 0; t < numTaps; ++t) {
+        const FG_ELEMENT weight = taps_[t].weight;
+        const FG_ELEMENT* tapIn = lineIn + tapLinearOffsets_[t];
+#ifdef _OPENMP
+#pragma omp simd
+#endif  // _OPENMP
+        for (IndexType i = begin; i < end; ++i) {
+          lineOut[i] += weight * tapIn[i];
+        }
+      }
+    }
+  }
+
+  /** all other points, with the ghost layers of halo (which has to be finished) */
+  void applyBoundary(const FG_ELEMENT* in, const HaloExchange<FG_ELEMENT>& halo,
+                     FG_ELEMENT* out) const {
+    assert(maxOffset_ <= halo.getGhostWidth());
+    const auto dim = dfg_.getDimension();
+    const IndexType numLines = dfg_.getNrLocalElements() / localSizes_[0];
+    IndexVector axisIndex(dim, 0);
+    for (IndexType line = 0; line < numLines; ++line) {
+      // the axis index in dimensions > 0, and whether the line is in the interior there
+      IndexType lineOffset = 0;
+      IndexType remainder = line;
+      bool interiorLine = true;
+      for (DimType d = 1; d < dim; ++d) {
+        axisIndex[d] = remainder % localSizes_[d];
+        remainder /= localSizes_[d];
+        lineOffset += axisIndex[d] * localOffsets_[d];
+        interiorLine =
+            interiorLine && axisIndex[d] >= interiorLower_[d] && axisIndex[d] < interiorUpper_[d];
+      }
+      if (interiorLine && numInteriorLines_ > 0) {
+        for (IndexType i = 0; i < interiorLower_[0]; ++i) {
+          axisIndex[0] = i;
+          out[lineOffset + i] = evaluatePoint(in, halo, axisIndex, lineOffset + i);
+        }
+        for (IndexType i = interiorUpper_[0]; i < localSizes_[0]; ++i) {
+          axisIndex[0] = i;
+          out[lineOffset + i] = evaluatePoint(in, halo, axisIndex, lineOffset + i);
+        }
+      } else {
+        for (IndexType i = 0; i < localSizes_[0]; ++i) {
+          axisIndex[0] = i;
+          out[lineOffset + i] = evaluatePoint(in, halo, axisIndex, lineOffset + i);
+        }
+      }
+    }
+  }
+
+  /** the number of values read and written per point, to estimate the memory traffic */
+  inline size_t getNumBytesPerPoint() const { return 2 * sizeof(FG_ELEMENT); }
+
+ private:
+  IndexType getInteriorLineOffset(IndexType line) const {
+    IndexType lineOffset = 0;
+    for (DimType d = 1; d < dfg_.getDimension(); ++d) {
+      const IndexType extent = interiorUpper_[d] - interiorLower_[d];
+      lineOffset += (interiorLower_[d] + line % extent) * localOffsets_[d];
+      line /= extent;
+    }
+    return lineOffset;
+  }
+
+  FG_ELEMENT evaluatePoint(const FG_ELEMENT* in, const HaloExchange<FG_ELEMENT>& halo,
+                           const IndexVector& axisIndex, IndexType li) const {
+    FG_ELEMENT value = centerWeight_ * in[li];
+    for (size_t t = 0; t < taps_.size(); ++t) {
+      const auto& tap = taps_[t];
+      const IndexType neighborIndex = axisIndex[tap.d] + tap.offset;
+      if (neighborIndex >= 0 && neighborIndex < localSizes_[tap.d]) {
+        value += tap.weight * in[li + tapLinearOffsets_[t]];
+        continue;
+      }
+      const bool lower = neighborIndex < 0;
+      const auto& ghostLayer =
+          lower ? halo.getLowerGhostLayer(tap.d) : halo.getUpperGhostLayer(tap.d);
+      if (ghostLayer.empty()) {
+        // no neighbor, at the global boundary
+        return in[li];
+      }
+      const auto& ghostOffsets = halo.getGhostLayerOffsets(tap.d);
+      IndexType gli = 0;
+      for (DimType j = 0; j < dfg_.getDimension(); ++j) {
+        if (j != tap.d) gli += axisIndex[j] * ghostOffsets[j];
+      }
+      gli += (lower ? neighborIndex + halo.getGhostWidth() : neighborIndex - localSizes_[tap.d]) *
+             ghostOffsets[tap.d];
+      assert(gli >= 0 && gli < static_cast<IndexType>(ghostLayer.size()));
+      value += tap.weight * ghostLayer[gli];
+    }
+    return value;
+  }
+
+  const DistributedFullGrid<FG_ELEMENT>& dfg_;
+
+  FG_ELEMENT centerWeight_;
+  std::vector<StencilTap<FG_ELEMENT>> taps_;
+  std::vector<IndexType> tapLinearOffsets_;
+  IndexType maxOffset_ = 0;
+
+  IndexVector localSizes_;
+  IndexVector localOffsets_;
+
+  // the local axis indices [lower, upper) of the interior in each dimension
+  IndexVector interiorLower_;
+  IndexVector interiorUpper_;
+  IndexType numInteriorLines_;
+};
+
+}  // namespace combigrid
+
+#endif /* STENCILSWEEP_HPP_ */
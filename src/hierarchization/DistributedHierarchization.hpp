@@ -3,7 +3,9 @@
 
 #include "boost/lexical_cast.hpp"
 #include "fullgrid/DistributedFullGrid.hpp"
+#include "utils/GridAllocator.hpp"
 #include "utils/IndexVector.hpp"
+#include "utils/MemoryTracker.hpp"
 #include "utils/PowerOfTwo.hpp"
 #include "utils/Stats.hpp"
 
@@ -53,6 +55,7 @@ class RemoteDataContainer {
     IndexType nrElements = std::accumulate(sizes.begin(), sizes.end(), 1, std::multiplies<IndexType>());
 #endif
     data_.resize(nrElements);
+    dataMemory_.track(data_);
   }
 
 #ifndef NDEBUG
@@ -86,9 +89,9 @@ class RemoteDataContainer {
     return &data_[idx];
   }
   /** the getters for the full grid vector */
-  inline std::vector<FG_ELEMENT>& getElementVector() { return data_; }
+  inline GridVector<FG_ELEMENT>& getElementVector() { return data_; }
 
-  inline const std::vector<FG_ELEMENT>& getElementVector() const { return data_; }
+  inline const GridVector<FG_ELEMENT>& getElementVector() const { return data_; }
 
   // return index of (d-1)-dimensional subgrid in the d-dimensional grid
   inline IndexType getKeyIndex() const { return index1d_; }
@@ -106,7 +109,9 @@ class RemoteDataContainer {
   IndexType index1d_;
 
   // data vector
-  std::vector<FG_ELEMENT> data_;
+  GridVector<FG_ELEMENT> data_;
+
+  TrackedMemory dataMemory_{MemoryCategory::communicationBuffers};
 };
 
 template <typename FG_ELEMENT>
@@ -313,7 +318,7 @@ void sendAndReceiveIndicesBlock(const std::map<RankType, std::set<IndexType>>& s
         }
 #endif
         MPI_Aint addr;
-        MPI_Get_address(&(dfg.getElementVector()[localLinearIndex]), &addr);
+        MPI_Get_address(dfg.getData() + localLinearIndex, &addr);
         auto d = MPI_Aint_diff(addr, dfgStartAddr);
         displacements.push_back(d);
       }
@@ -774,6 +779,8 @@ static IndexType getFirstIndexOfLevel1d(const DistributedFullGrid<FG_ELEMENT>& d
 template <typename FG_ELEMENT, bool periodic = false>
 inline void hierarchize_hat_boundary_kernel(FG_ELEMENT* data, LevelType lmax, int start,
                                              int stride, LevelType lmin = 0) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5;
   const int lmaxi = static_cast<int>(lmax);
   int ll = lmaxi - 1;
   int steps = (1 << (lmaxi - 1));
@@ -783,11 +790,11 @@ inline void hierarchize_hat_boundary_kernel(FG_ELEMENT* data, LevelType lmax, in
 
   for (; ll >= lmin; ll--) {
     int parOffsetStrided = parentOffset * stride;
-    FG_ELEMENT parentL = 0.5 * data[start + offset * stride - parOffsetStrided];
+    FG_ELEMENT parentL = half * data[start + offset * stride - parOffsetStrided];
 
     for (int ctr = 0; ctr < steps; ++ctr) {
       int centralIndex = start + offset * stride;
-      FG_ELEMENT parentR = 0.5 * data[centralIndex + parOffsetStrided];
+      FG_ELEMENT parentR = half * data[centralIndex + parOffsetStrided];
       FG_ELEMENT val1 = data[centralIndex];
       FG_ELEMENT val2 = val1 - parentL;
       FG_ELEMENT val3 = val2 - parentR;
@@ -820,6 +827,8 @@ template <typename FG_ELEMENT, bool periodic = false>
 inline void hierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, LevelType lmax,
                                                             int start, int stride,
                                                             LevelType lmin = 0) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5, quarter = 0.25;
   assert(start == 0); // could be used but currently is not
   assert(stride == 1);
   const int lmaxi = static_cast<int>(lmax);
@@ -831,21 +840,21 @@ inline void hierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, LevelTy
     // update f at even indices
     if (periodic) {
       // values at 0 and idxmax will be the same
-      data[0] = 0.25 * (data[0] + data[idxmax] + data[step_width] + data[idxmax - step_width]);
+      data[0] = quarter * (data[0] + data[idxmax] + data[step_width] + data[idxmax - step_width]);
       data[idxmax] = data[0];
     } else {
-      data[0] = 0.5 * (data[0] + data[step_width]);
-      data[idxmax] = 0.5 * (data[idxmax] + data[idxmax - step_width]);
+      data[0] = half * (data[0] + data[step_width]);
+      data[idxmax] = half * (data[idxmax] + data[idxmax - step_width]);
     }
     //todo iterate only "our" part
     for (int i = 2*step_width; i < idxmax; i += 2*step_width) {
       // todo reformulate more cache-efficient
-      data[i] = 0.25 * (data[i-step_width] + data[i+step_width]) + 0.5*data[i];
+      data[i] = quarter * (data[i-step_width] + data[i+step_width]) + half * data[i];
     }
     // update alpha / hierarchical surplus at odd indices
     for (int i = step_width; i < idxmax; i += 2*step_width) {
       // todo reformulate more cache-efficient
-      data[i] = -0.5 * (data[i-step_width] + data[i+step_width]) + data[i];
+      data[i] = -half * (data[i-step_width] + data[i+step_width]) + data[i];
     }
   }
 
@@ -867,6 +876,8 @@ inline void hierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, LevelTy
 template <typename FG_ELEMENT, bool periodic = false>
 inline void hierarchize_biorthogonal_boundary_kernel(FG_ELEMENT* data, LevelType lmax, int start,
                                              int stride, LevelType lmin = 0) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5, quarter = 0.25;
 
   assert(start == 0);
   assert(stride == 1);
@@ -887,22 +898,23 @@ inline void hierarchize_biorthogonal_boundary_kernel(FG_ELEMENT* data, LevelType
     // update alpha / hierarchical surplus at odd indices
     for (int i = step_width; i < idxmax; i += 2*step_width) {
       // todo reformulate more cache-efficient
-      data[i] = -0.5 * (data[i-step_width] + data[i+step_width]) + data[i];
+      data[i] = -half * (data[i-step_width] + data[i+step_width]) + data[i];
     }
     // update f at even indices
     if (periodic) {
       // values at 0 and idxmax will be the same
-      data[0] = 0.5 * (data[0] + data[idxmax]) + 0.25 * (data[step_width] + data[idxmax - step_width]);
+      data[0] = half * (data[0] + data[idxmax]) +
+                quarter * (data[step_width] + data[idxmax - step_width]);
       data[idxmax] = data[0];
     } else {
       // mass will build up at the boundary; corresponds to 0-neumann-condition
-      data[0] = data[0] + 0.5 * data[step_width];
-      data[idxmax] = data[idxmax] + 0.5 * data[idxmax - step_width];
+      data[0] = data[0] + half * data[step_width];
+      data[idxmax] = data[idxmax] + half * data[idxmax - step_width];
     }
     //todo iterate only "our" part
     for (int i = 2*step_width; i < idxmax; i += 2*step_width) {
       // todo reformulate more cache-efficient
-      data[i] = 0.25 * (data[i-step_width] + data[i+step_width]) + data[i];
+      data[i] = quarter * (data[i-step_width] + data[i+step_width]) + data[i];
     }
   }
 }
@@ -910,6 +922,8 @@ inline void hierarchize_biorthogonal_boundary_kernel(FG_ELEMENT* data, LevelType
 template <typename FG_ELEMENT, bool periodic = false>
 inline void dehierarchize_hat_boundary_kernel(FG_ELEMENT* data, LevelType lmax, int start,
                                                int stride, LevelType lmin = 0) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5;
   const int lmaxi = static_cast<int>(lmax);
   const int lmini = static_cast<int>(lmin);
   int steps = 1 << (lmini);
@@ -919,11 +933,11 @@ inline void dehierarchize_hat_boundary_kernel(FG_ELEMENT* data, LevelType lmax,
 
   for (LevelType ll = lmin + 1; ll <= lmax; ++ll) {
     int parOffsetStrided = parentOffset * stride;
-    FG_ELEMENT parentL = 0.5 * data[start + offset * stride - parOffsetStrided];
+    FG_ELEMENT parentL = half * data[start + offset * stride - parOffsetStrided];
 
     for (int ctr = 0; ctr < steps; ++ctr) {
       int centralIndex = start + offset * stride;
-      FG_ELEMENT parentR = 0.5 * data[centralIndex + parOffsetStrided];
+      FG_ELEMENT parentR = half * data[centralIndex + parOffsetStrided];
       FG_ELEMENT val1 = data[centralIndex];
       FG_ELEMENT val2 = val1 + parentL;
       FG_ELEMENT val3 = val2 + parentR;
@@ -945,6 +959,8 @@ inline void dehierarchize_hat_boundary_kernel(FG_ELEMENT* data, LevelType lmax,
 template <typename FG_ELEMENT, bool periodic = false>
 inline void dehierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, LevelType lmax,
                                                           int start, int stride, LevelType lmin) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5, two = 2.;
   const int lmaxi = static_cast<int>(lmax);
   int idxmax = powerOfTwo[lmaxi];
   // auto length = idxmax + 1;
@@ -954,20 +970,20 @@ inline void dehierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, Level
     // update alpha / hierarchical surplus at odd indices
     for (int i = step_width; i < idxmax; i += 2 * step_width) {
       // todo reformulate more cache-efficient
-      data[i] = 0.5 * (data[i - step_width] + data[i + step_width]) + data[i];
+      data[i] = half * (data[i - step_width] + data[i + step_width]) + data[i];
     }
     // update f at even indices
     for (int i = 2 * step_width; i < idxmax; i += 2 * step_width) {
       // todo reformulate more cache-efficient
-      data[i] = -0.5 * (data[i - step_width] + data[i + step_width]) + 2. * data[i];
+      data[i] = -half * (data[i - step_width] + data[i + step_width]) + two * data[i];
     }
     if (periodic) {
       // values at 0 and idxmax will be the same
-      data[0] = (data[0] + data[idxmax]) - 0.5 * (data[step_width] + data[idxmax - step_width]);
+      data[0] = (data[0] + data[idxmax]) - half * (data[step_width] + data[idxmax - step_width]);
       data[idxmax] = data[0];
     } else {
-      data[0] = 2. * data[0] - data[step_width];
-      data[idxmax] = 2. * data[idxmax] - data[idxmax - step_width];
+      data[0] = two * data[0] - data[step_width];
+      data[idxmax] = two * data[idxmax] - data[idxmax - step_width];
     }
   }
 
@@ -980,6 +996,8 @@ inline void dehierarchize_full_weighting_boundary_kernel(FG_ELEMENT* data, Level
 template <typename FG_ELEMENT, bool periodic = false>
 inline void dehierarchize_biorthogonal_boundary_kernel(FG_ELEMENT* data, LevelType lmax, int start,
                                                         int stride, LevelType lmin) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5, quarter = 0.25;
   assert(start == 0);
   assert(stride == 1);
   const int lmaxi = static_cast<int>(lmax);
@@ -1000,20 +1018,20 @@ inline void dehierarchize_biorthogonal_boundary_kernel(FG_ELEMENT* data, LevelTy
     // update f at even indices
     if (periodic) {
       data[0] =
-          -0.25 * (data[step_width] + data[idxmax - step_width]) + 0.5 * (data[0] + data[idxmax]);
+          -quarter * (data[step_width] + data[idxmax - step_width]) + half * (data[0] + data[idxmax]);
       data[idxmax] = data[0];
     } else {
-      data[0] = data[0] - 0.5 * data[step_width];
-      data[idxmax] = data[idxmax] - 0.5 * data[idxmax - step_width];
+      data[0] = data[0] - half * data[step_width];
+      data[idxmax] = data[idxmax] - half * data[idxmax - step_width];
     }
     for (int i = 2 * step_width; i < idxmax; i += 2 * step_width) {
       // todo reformulate more cache-efficient
-      data[i] = -0.25 * (data[i - step_width] + data[i + step_width]) + data[i];
+      data[i] = -quarter * (data[i - step_width] + data[i + step_width]) + data[i];
     }
     // update alpha / hierarchical surplus at odd indices
     for (int i = step_width; i < idxmax; i += 2 * step_width) {
       // todo reformulate more cache-efficient
-      data[i] = 0.5 * (data[i - step_width] + data[i + step_width]) + data[i];
+      data[i] = half * (data[i - step_width] + data[i + step_width]) + data[i];
     }
   }
 }
@@ -1043,7 +1061,7 @@ void hierarchizeWithBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
   bool oneSidedBoundary = dfg.returnBoundaryFlags()[dim] == 1;
   tmp.resize(dfg.getGlobalSizes()[dim] + (oneSidedBoundary ? 1 : 0),
              std::numeric_limits<double>::quiet_NaN());
-  std::vector<FG_ELEMENT>& ldata = dfg.getElementVector();
+  FG_ELEMENT* ldata = dfg.getData();
   lldiv_t divresult;
   IndexType start;
   IndexType gstart = dfg.getLowerBounds()[dim];
@@ -1101,6 +1119,8 @@ void hierarchizeWithBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
 template <typename FG_ELEMENT>
 void hierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
                            std::vector<RemoteDataContainer<FG_ELEMENT>>& remoteData, DimType dim) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5;
   assert(dfg.returnBoundaryFlags()[dim] == 0);
 
   LevelType lmax = dfg.getLevels()[dim];
@@ -1112,7 +1132,7 @@ void hierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
 
   // loop over poles
   std::vector<FG_ELEMENT> tmp(dfg.getGlobalSizes()[dim], std::numeric_limits<double>::quiet_NaN());
-  std::vector<FG_ELEMENT>& ldata = dfg.getElementVector();
+  FG_ELEMENT* ldata = dfg.getData();
   lldiv_t divresult;
   IndexType start;
   IndexType gstart = dfg.getLowerBounds()[dim];
@@ -1167,8 +1187,8 @@ void hierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
           }
 
           // do calculation
-          FG_ELEMENT buf = -0.5 * left;
-          tmp[idx] -= 0.5 * right;
+          FG_ELEMENT buf = -half * left;
+          tmp[idx] -= half * right;
           tmp[idx] += buf;
         }
       }
@@ -1204,7 +1224,7 @@ void dehierarchizeWithBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
   bool oneSidedBoundary = dfg.returnBoundaryFlags()[dim] == 1;
   tmp.resize(dfg.getGlobalSizes()[dim] + (oneSidedBoundary ? 1 : 0),
              std::numeric_limits<double>::quiet_NaN());
-  std::vector<FG_ELEMENT>& ldata = dfg.getElementVector();
+  FG_ELEMENT* ldata = dfg.getData();
   lldiv_t divresult;
   IndexType start;
   IndexType gstart = dfg.getLowerBounds()[dim];
@@ -1258,6 +1278,8 @@ template <typename FG_ELEMENT>
 void dehierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
                              std::vector<RemoteDataContainer<FG_ELEMENT>>& remoteData,
                              DimType dim) {
+  typedef typename RealTypeOf<FG_ELEMENT>::type Real;
+  const Real half = 0.5;
   assert(dfg.returnBoundaryFlags()[dim] == 0);
 
   auto lmax = dfg.getLevels()[dim];
@@ -1270,7 +1292,7 @@ void dehierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
   // loop over poles
   static std::vector<FG_ELEMENT> tmp;
   tmp.resize(dfg.getGlobalSizes()[dim], std::numeric_limits<double>::quiet_NaN());
-  std::vector<FG_ELEMENT>& ldata = dfg.getElementVector();
+  FG_ELEMENT* ldata = dfg.getData();
   lldiv_t divresult;
   IndexType start;
   IndexType gstart = dfg.getLowerBounds()[dim];
@@ -1322,8 +1344,8 @@ void dehierarchizeNoBoundary(DistributedFullGrid<FG_ELEMENT>& dfg,
         }
 
         // do calculation
-        FG_ELEMENT buf = 0.5 * left;
-        tmp[idx] += 0.5 * right;
+        FG_ELEMENT buf = half * left;
+        tmp[idx] += half * right;
         tmp[idx] += buf;
       }
     }
@@ -1346,14 +1368,19 @@ class DistributedHierarchization {
     // hierarchize all dimensions, with special treatment for 0
     for (DimType dim = 0; dim < dfg.getDimension(); ++dim) {
       if (!dims[dim]) continue;
+      STATS_SCOPED_EVENT("hierarchize dimension");
 
       // exchange data
       std::vector<RemoteDataContainer<FG_ELEMENT>> remoteData;
-      if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
-          dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) != nullptr) {
-        exchangeData1d(dfg, dim, remoteData, lmin[dim]);
-      } else {
-        exchangeAllData1d(dfg, dim, remoteData);
+      {
+        STATS_SCOPED_EVENT("hierarchize exchange");
+        if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
+            dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) !=
+                nullptr) {
+          exchangeData1d(dfg, dim, remoteData, lmin[dim]);
+        } else {
+          exchangeAllData1d(dfg, dim, remoteData);
+        }
       }
 
       if (dfg.returnBoundaryFlags()[dim] > 0) {
@@ -1428,14 +1455,19 @@ class DistributedHierarchization {
     // dehierarchize all dimensions, with special treatment for 0
     for (DimType dim = 0; dim < dfg.getDimension(); ++dim) {
       if (!dims[dim]) continue;
+      STATS_SCOPED_EVENT("dehierarchize dimension");
 
       // exchange data
       std::vector<RemoteDataContainer<FG_ELEMENT>> remoteData;
-      if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
-          dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) != nullptr) {
-        exchangeData1dDehierarchization(dfg, dim, remoteData, lmin[dim]);
-      } else {
-        exchangeAllData1d(dfg, dim, remoteData);
+      {
+        STATS_SCOPED_EVENT("dehierarchize exchange");
+        if (dynamic_cast<HierarchicalHatBasisFunction*>(hierarchicalBases[dim]) != nullptr ||
+            dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(hierarchicalBases[dim]) !=
+                nullptr) {
+          exchangeData1dDehierarchization(dfg, dim, remoteData, lmin[dim]);
+        } else {
+          exchangeAllData1d(dfg, dim, remoteData);
+        }
       }
 
       if (dfg.returnBoundaryFlags()[dim] > 0) {
@@ -344,6 +344,67 @@ class CombiParameters {
     return forwardDecomposition_;
   }
 
+  /**
+   * In lean mode, the sparse grids are added to without Kahan summation, and the extra
+   * sparse grids for the third level combination hold their subspace data only temporarily
+   * (or not at all, if the data is exchanged in place), which reduces the sparse grid memory
+   * to roughly a third.
+   */
+  inline void setLeanSparseGrids(bool leanSparseGrids) { leanSparseGrids_ = leanSparseGrids; }
+
+  inline bool isLeanSparseGrids() const { return leanSparseGrids_; }
+
+  /**
+   * Memory budget (in bytes, per process) for writing the combined solution to file with
+   * parallelEvalUniform. If set, the output grid is not created as a whole, but evaluated on
+   * the sparse grid and written in slabs of this size, if possible; the norms on a reference
+   * grid are then evaluated on the sparse grid, too. 0 (the default) means that the full output
+   * and reference grids are created.
+   */
+  inline void setEvalMemoryBudget(size_t evalMemoryBudget) { evalMemoryBudget_ = evalMemoryBudget; }
+
+  inline size_t getEvalMemoryBudget() const { return evalMemoryBudget_; }
+
+  /**
+   * If set, the workers keep in-memory checkpoints of the full grids of the neighboring process
+   * group, taken after every combination (cf. BuddyCheckpoint), from which a replacement group
+   * can restore the tasks with ProcessManager::restoreFromCheckpoints.
+   */
+  inline void setBuddyCheckpointing(bool buddyCheckpointing) {
+    buddyCheckpointing_ = buddyCheckpointing;
+  }
+
+  inline bool isBuddyCheckpointing() const { return buddyCheckpointing_; }
+
+  /**
+   * Partial combination: the subspaces up to a level sum of coarseLevelSum are combined in every
+   * combination, the finer ones only in every fineCombinationInterval-th one (starting with the
+   * first) and in the last one. In between, the component grids keep their own hierarchical
+   * surpluses in the fine subspaces, which are neither reduced nor extracted, so the global
+   * reduce only carries the coarse subspaces. An interval of 1 (the default) combines all
+   * subspaces every time. This applies to ProcessGroupWorker::combineUniform; the third level
+   * combination also extracts only the coarse subspaces, but still exchanges the whole sparse
+   * grids (with the fine subspaces zero), so its volume is not reduced. The pipelined
+   * combination cannot be combined with it.
+   */
+  inline void setPartialCombination(LevelType coarseLevelSum, IndexType fineCombinationInterval) {
+    assert(fineCombinationInterval > 0);
+    partialCombinationCoarseLevelSum_ = coarseLevelSum;
+    partialCombinationInterval_ = fineCombinationInterval;
+  }
+
+  inline LevelType getPartialCombinationCoarseLevelSum() const {
+    return partialCombinationCoarseLevelSum_;
+  }
+
+  inline IndexType getPartialCombinationInterval() const { return partialCombinationInterval_; }
+
+  // whether only the coarse subspaces are combined in the combination with this number
+  inline bool isPartialCombination(IndexType combination) const {
+    return partialCombinationInterval_ > 1 && combination % partialCombinationInterval_ != 0 &&
+           combination != numberOfCombinations_ - 1;
+  }
+
  private:
   DimType dim_;
 
@@ -407,6 +468,16 @@ class CombiParameters {
 
   size_t thirdLevelPG_;
 
+  bool leanSparseGrids_ = false;
+
+  size_t evalMemoryBudget_ = 0;
+
+  bool buddyCheckpointing_ = false;
+
+  LevelType partialCombinationCoarseLevelSum_ = 0;
+
+  IndexType partialCombinationInterval_ = 1;
+
   // serialize
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version);
@@ -432,6 +503,11 @@ void CombiParameters::serialize(Archive& ar, const unsigned int version) {
   ar& thirdLevelHost_;
   ar& thirdLevelPort_;
   ar& thirdLevelPG_;
+  ar& leanSparseGrids_;
+  ar& evalMemoryBudget_;
+  ar& buddyCheckpointing_;
+  ar& partialCombinationCoarseLevelSum_;
+  ar& partialCombinationInterval_;
 }
 
 
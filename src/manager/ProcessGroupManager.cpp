@@ -162,8 +162,10 @@ bool ProcessGroupManager::combineThirdLevelFileBasedReadReduce(
   return waiting;
 }
 
-void recvDsguFromWorker(std::vector<CombiDataType>& dsguData, RankType r, CommunicatorType comm) {
-  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>());
+void recvDsguFromWorker(std::vector<SparseGridDataType>& dsguData, RankType r,
+                        CommunicatorType comm) {
+  MPI_Datatype dataType =
+      getMPIDatatype(abstraction::getabstractionDataType<SparseGridDataType>());
   auto dsguSize = dsguData.size();
   if (dsguSize == 0) {
     throw std::runtime_error("dsguData is empty");
@@ -178,8 +180,10 @@ void recvDsguFromWorker(std::vector<CombiDataType>& dsguData, RankType r, Commun
            TRANSFER_DSGU_DATA_TAG, comm, MPI_STATUS_IGNORE);
 }
 
-void sendDsguToWorker(std::vector<CombiDataType>& dsguData, RankType r, CommunicatorType comm) {
-  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>());
+void sendDsguToWorker(std::vector<SparseGridDataType>& dsguData, RankType r,
+                      CommunicatorType comm) {
+  MPI_Datatype dataType =
+      getMPIDatatype(abstraction::getabstractionDataType<SparseGridDataType>());
   auto dsguSize = dsguData.size();
   if (dsguSize == 0) {
     throw std::runtime_error("dsguData is empty");
@@ -206,7 +210,7 @@ bool ProcessGroupManager::pretendCombineThirdLevelForWorkers(CombiParameters& pa
 
   // exchange dsgus
   IndexType numGrids = params.getNumGrids();
-  std::vector<CombiDataType> dsguData;
+  std::vector<SparseGridDataType> dsguData;
   for (IndexType g = 0; g < numGrids; g++) {
     for (RankType p = 0; p < (RankType)theMPISystem()->getNumProcs(); p++) {
       // we assume here that all dsgus have the same size otherwise size collection must change
@@ -371,7 +375,7 @@ void ProcessGroupManager::exchangeDsgus(const ThirdLevelUtils& thirdLevel, Combi
 
   // exchange dsgus
   IndexType numGrids = params.getNumGrids();
-  std::vector<CombiDataType> dsguData;
+  std::vector<SparseGridDataType> dsguData;
   for (IndexType g = 0; g < numGrids; g++) {
     for (RankType p = 0; p < (RankType)theMPISystem()->getNumProcs(); p++) {
       // we assume here that all dsgus have the same size otherwise size collection must change
@@ -556,6 +560,27 @@ bool ProcessGroupManager::recompute(Task* t) {
   return true;
 }
 
+void ProcessGroupManager::sendCheckpoint(size_t taskID, RankType destGroup) {
+  assert(status_ == PROCESS_GROUP_WAIT);
+  sendSignalToProcessGroup(SEND_CHECKPOINT);
+  std::array<size_t, 2> request = {taskID, static_cast<size_t>(destGroup)};
+  MPI_Send(request.data(), 2,
+           abstraction::getMPIDatatype(abstraction::getabstractionDataType<size_t>()),
+           pgroupRootID_, TRANSFER_CHECKPOINT_LAYOUT_TAG, theMPISystem()->getGlobalComm());
+  setProcessGroupBusyAndReceive();
+}
+
+bool ProcessGroupManager::restoreFromCheckpoint(Task* t) {
+  assert(status_ == PROCESS_GROUP_WAIT);
+  sendSignalToProcessGroup(RESTORE_FROM_CHECKPOINT);
+  Task::send(&t, pgroupRootID_, theMPISystem()->getGlobalComm());
+  int restored = 0;
+  MPI_Recv(&restored, 1, MPI_INT, pgroupRootID_, TRANSFER_CHECKPOINT_LAYOUT_TAG,
+           theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+  setProcessGroupBusyAndReceive();
+  return restored != 0;
+}
+
 void sendLevelVector(const LevelVector& leval, RankType pgroupRootID) {
   std::vector<int> tmp(leval.begin(), leval.end());
   MPI_Send(&tmp[0], static_cast<int>(tmp.size()), MPI_INT, pgroupRootID, TRANSFER_LEVAL_TAG,
@@ -604,15 +629,9 @@ void ProcessGroupManager::doDiagnostics(size_t taskID) {
 }
 
 std::vector<double> receiveThreeNorms(RankType pgroupRootID) {
-  std::vector<double> norms;
-  for (int i = 0; i < 3; ++i) {
-    double recvbuf;
-
-    MPI_Recv(&recvbuf, 1, MPI_DOUBLE, pgroupRootID, TRANSFER_NORM_TAG,
-             theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
-
-    norms.push_back(recvbuf);
-  }
+  std::vector<double> norms(3);
+  MPI_Recv(norms.data(), 3, MPI_DOUBLE, pgroupRootID, TRANSFER_NORM_TAG,
+           theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
   return norms;
 }
 
@@ -653,6 +672,62 @@ void ProcessGroupManager::getLpNorms(int p, std::map<size_t, double>& norms) {
   this->setProcessGroupBusyAndReceive();
 }
 
+NormBundle ProcessGroupManager::evalNormBundle(const LevelVector& leval, NormBundleType bundle) {
+  sendSignalToProcessGroup(EVAL_NORM_BUNDLE);
+  sendLevelVector(leval, pgroupRootID_);
+  MPI_Send(&bundle, 1, MPI_INT, pgroupRootID_, TRANSFER_NORM_TAG, theMPISystem()->getGlobalComm());
+
+  const auto numTasks = (bundle & TASK_NORMS) ? this->getTaskContainer().size() : 0;
+  size_t numNorms = 3 * numTasks;
+  for (auto levalNorms : {COMBINED_NORMS, ANALYTICAL_NORMS, ERROR_NORMS}) {
+    if (bundle & levalNorms) numNorms += 3;
+  }
+  std::vector<double> recvbuf(numNorms);
+  MPI_Recv(recvbuf.data(), static_cast<int>(numNorms), MPI_DOUBLE, pgroupRootID_,
+           TRANSFER_NORM_TAG, theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+
+  NormBundle norms;
+  auto next = recvbuf.begin();
+  for (size_t j = 0; j < numTasks; ++j, next += 3) {
+    std::copy(next, next + 3, norms.taskNorms[this->getTaskContainer()[j]->getID()].begin());
+  }
+  if (bundle & COMBINED_NORMS) {
+    std::copy(next, next + 3, norms.combined.begin());
+    next += 3;
+  }
+  if (bundle & ANALYTICAL_NORMS) {
+    std::copy(next, next + 3, norms.analytical.begin());
+    next += 3;
+  }
+  if (bundle & ERROR_NORMS) {
+    std::copy(next, next + 3, norms.error.begin());
+  }
+
+  this->setProcessGroupBusyAndReceive();
+  return norms;
+}
+
+MemoryReport ProcessGroupManager::getMemoryReport() {
+  this->sendSignalToProcessGroup(GET_MEMORY_REPORT);
+
+  constexpr auto numCategories = MemoryTracker::numCategories;
+  // [current_0, peak_0, ...] summed, then the same maximized
+  std::vector<uint64_t> recvbuf(4 * numCategories);
+  MPI_Recv(recvbuf.data(), static_cast<int>(recvbuf.size()), MPI_UINT64_T, pgroupRootID_,
+           TRANSFER_MEMORY_REPORT_TAG, theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+
+  MemoryReport report;
+  for (size_t c = 0; c < numCategories; ++c) {
+    report.currentBytesSum[c] = recvbuf[2 * c];
+    report.peakBytesSum[c] = recvbuf[2 * c + 1];
+    report.currentBytesMax[c] = recvbuf[2 * numCategories + 2 * c];
+    report.peakBytesMax[c] = recvbuf[2 * numCategories + 2 * c + 1];
+  }
+
+  this->setProcessGroupBusyAndReceive();
+  return report;
+}
+
 std::vector<double> ProcessGroupManager::evalAnalyticalOnDFG(const LevelVector& leval) {
   sendSignalToProcessGroup(EVAL_ANALYTICAL_NORM);
   sendLevelVector(leval, pgroupRootID_);
@@ -13,6 +13,7 @@
 #include "mpi_fault_simulator/MPI-FT.h"
 #include "task/Task.hpp"
 #include "third_level/ThirdLevelUtils.hpp"
+#include "utils/MemoryTracker.hpp"
 #include "utils/Types.hpp"
 
 namespace combigrid {
@@ -93,6 +94,20 @@ class ProcessGroupManager {
 
   bool recompute(Task*);
 
+  /**
+   * @brief send the buddy checkpoint of a task held by this group to the group with master
+   * rank destGroup (cf. BuddyCheckpoint), to be received with restoreFromCheckpoint
+   */
+  void sendCheckpoint(size_t taskID, RankType destGroup);
+
+  /**
+   * @brief re-add a task to this group, restoring its state from the buddy checkpoint and
+   * running it once; the task is recomputed from the combined solution if there is none
+   *
+   * @return whether the task could be restored from the checkpoint
+   */
+  bool restoreFromCheckpoint(Task* t);
+
   bool recoverCommunicators();
 
   bool parallelEval(const LevelVector& leval, std::string& filename);
@@ -109,6 +124,12 @@ class ProcessGroupManager {
 
   std::vector<double> evalErrorOnDFG(const LevelVector& leval);
 
+  // all requested norms (cf. NormBundleType) with a single signal and a single reply
+  NormBundle evalNormBundle(const LevelVector& leval, NormBundleType bundle);
+
+  // current and peak bytes per memory category, summed and maximized over the group's ranks
+  MemoryReport getMemoryReport();
+
   void interpolateValues(const std::vector<real>& interpolationCoordsSerial,
                          std::vector<CombiDataType>& values, MPI_Request* request = nullptr,
                          std::string filenamePrefix = "");
@@ -211,6 +232,14 @@ class ProcessGroupManager {
   friend class ProcessManager;
   inline void setMasterRank(int pGroupRootID);
   inline int getMasterRank();
+
+  /* the status as last received, without testing for a new one */
+  inline bool isBusy() const { return status_ == PROCESS_GROUP_BUSY; }
+
+  /* the outstanding status receive, to be completed by the ProcessManager
+   * together with those of the other groups (not available with ENABLE_FT)
+   */
+  inline MPI_Request& getStatusRequest() { return statusRequest_; }
 };
 
 typedef std::shared_ptr<ProcessGroupManager> ProcessGroupManagerID;
@@ -83,12 +83,27 @@ const SignalType COMBINE_READ_DSGS_AND_REDUCE = 45;
 const SignalType INTERPOLATE_VALUES_AND_SEND_BACK = 46;
 const SignalType INTERPOLATE_VALUES_AND_WRITE_SINGLE_FILE = 47;
 
+const SignalType GET_MEMORY_REPORT = 48;
+
+const SignalType EVAL_NORM_BUNDLE = 49;
+
+/** Signals for restoring a task from the buddy checkpoint (cf. BuddyCheckpoint) */
+const SignalType SEND_CHECKPOINT = 50;
+const SignalType RESTORE_FROM_CHECKPOINT = 51;
+
 typedef int NormalizationType;
 const NormalizationType NO_NORMALIZATION = 0;
 const NormalizationType L1_NORMALIZATION = 1;
 const NormalizationType L2_NORMALIZATION = 2;
 const NormalizationType EV_NORMALIZATION = 3;
 
+// the norms to evaluate with EVAL_NORM_BUNDLE, can be combined with |
+typedef int NormBundleType;
+const NormBundleType TASK_NORMS = 1;        // maximum, 1 and 2 norm of each task's grid
+const NormBundleType COMBINED_NORMS = 2;    // same for the combined solution on leval
+const NormBundleType ANALYTICAL_NORMS = 4;  // ... for the analytical solution on leval
+const NormBundleType ERROR_NORMS = 8;       // ... for the difference of the two on leval
+
 typedef int FaultSimulationType;
 const FaultSimulationType RANDOM_FAIL = 0;
 const FaultSimulationType GROUPS_FAIL = 1;
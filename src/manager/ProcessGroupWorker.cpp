@@ -7,6 +7,7 @@
 #include "hierarchization/DistributedHierarchization.hpp"
 #include "manager/CombiParameters.hpp"
 #include "manager/ProcessGroupSignals.hpp"
+#include "mpi/MPICartesianUtils.hpp"
 #include "mpi/MPIUtils.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 #include "loadmodel/LearningLoadModel.hpp"
@@ -14,9 +15,12 @@
 #include "io/H5InputOutput.hpp"
 
 #include <algorithm>
+#include <array>
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <iostream>
+#include <numeric>
 #include <random>
 #include <string>
 #include <thread>
@@ -24,6 +28,74 @@
 
 namespace combigrid {
 
+// number of points evaluated at once in the norm computation and output on the sparse grid
+constexpr IndexType sparseGridEvaluationChunkSize = 1 << 14;
+
+/**
+ * @brief sets the coordinates of consecutive points of a uniform grid of level leval, starting
+ * at the point with linear index firstLinearIndex (first dimension fastest, cf.
+ * DistributedFullGrid::getCoordsGlobal); as many points as coords has entries
+ */
+void getCoordsOfUniformGridPoints(IndexType firstLinearIndex, const IndexVector& numPoints,
+                                  const LevelVector& leval,
+                                  const std::vector<BoundaryType>& boundary,
+                                  std::vector<std::vector<real>>& coords) {
+  const auto dim = static_cast<DimType>(leval.size());
+  for (size_t i = 0; i < coords.size(); ++i) {
+    auto globalLinearIndex = firstLinearIndex + static_cast<IndexType>(i);
+    coords[i].resize(dim);
+    for (DimType d = 0; d < dim; ++d) {
+      const auto index1d = globalLinearIndex % numPoints[d];
+      globalLinearIndex /= numPoints[d];
+      coords[i][d] =
+          static_cast<real>(index1d + (boundary[d] > 0 ? 0 : 1)) * oneOverPowOfTwo[leval[d]];
+    }
+  }
+}
+
+/**
+ * @brief sums the (sparse) contributions of all processes in the group to values at the group's
+ * master; values on the other processes remain untouched
+ */
+template <typename FG_ELEMENT>
+void sumContributionsAtMaster(const std::vector<size_t>& contributingIndices,
+                              const std::vector<FG_ELEMENT>& contributions,
+                              std::vector<FG_ELEMENT>& values) {
+  const auto& localComm = theMPISystem()->getLocalComm();
+  const auto masterRank = theMPISystem()->getMasterRank();
+  const auto valueType =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+  const auto indexType = abstraction::getMPIDatatype(abstraction::getabstractionDataType<size_t>());
+  int numContributions = static_cast<int>(contributingIndices.size());
+  std::vector<int> numContributionsPerRank(theMPISystem()->getNumProcs());
+  MPI_Gather(&numContributions, 1, MPI_INT, numContributionsPerRank.data(), 1, MPI_INT, masterRank,
+             localComm);
+  std::vector<int> displacements(numContributionsPerRank.size(), 0);
+  std::partial_sum(numContributionsPerRank.begin(), numContributionsPerRank.end() - 1,
+                   displacements.begin() + 1);
+  const auto numGathered =
+      static_cast<size_t>(displacements.back() + numContributionsPerRank.back());
+  std::vector<size_t> gatheredIndices;
+  std::vector<FG_ELEMENT> gatheredContributions;
+  MASTER_EXCLUSIVE_SECTION {
+    gatheredIndices.resize(numGathered);
+    gatheredContributions.resize(numGathered);
+  }
+  MPI_Gatherv(contributingIndices.data(), numContributions, indexType, gatheredIndices.data(),
+              numContributionsPerRank.data(), displacements.data(), indexType, masterRank,
+              localComm);
+  MPI_Gatherv(contributions.data(), numContributions, valueType, gatheredContributions.data(),
+              numContributionsPerRank.data(), displacements.data(), valueType, masterRank,
+              localComm);
+
+  MASTER_EXCLUSIVE_SECTION {
+    std::fill(values.begin(), values.end(), 0.);
+    for (size_t k = 0; k < numGathered; ++k) {
+      values[gatheredIndices[k]] += gatheredContributions[k];
+    }
+  }
+}
+
 std::string receiveStringFromManagerAndBroadcastToGroup() {
   std::string stringToReceive;
   MASTER_EXCLUSIVE_SECTION {
@@ -35,14 +107,27 @@ std::string receiveStringFromManagerAndBroadcastToGroup() {
   return stringToReceive;
 }
 
-void sendNormsToManager(const std::vector<double> lpnorms) {
-  // get Lp norm on every worker; reduce through dfg function
-  for (int p = 0; p < lpnorms.size(); ++p) {
-    // send from master to manager
-    MASTER_EXCLUSIVE_SECTION {
-      MPI_Send(&lpnorms[p], 1, MPI_DOUBLE, theMPISystem()->getManagerRank(), TRANSFER_NORM_TAG,
-               theMPISystem()->getGlobalComm());
-    }
+void sendNormsToManager(const std::vector<double>& lpnorms) {
+  // send from master to manager, all norms in one message
+  MASTER_EXCLUSIVE_SECTION {
+    MPI_Send(lpnorms.data(), static_cast<int>(lpnorms.size()), MPI_DOUBLE,
+             theMPISystem()->getManagerRank(), TRANSFER_NORM_TAG, theMPISystem()->getGlobalComm());
+  }
+}
+
+void reduceAndSendMemoryReportToManager() {
+  // sum and maximum over the process group, concatenated
+  auto report = MemoryTracker::getReport();
+  std::vector<uint64_t> reduced(2 * report.size());
+  MPI_Reduce(report.data(), reduced.data(), static_cast<int>(report.size()), MPI_UINT64_T, MPI_SUM,
+             theMPISystem()->getMasterRank(), theMPISystem()->getLocalComm());
+  MPI_Reduce(report.data(), reduced.data() + report.size(), static_cast<int>(report.size()),
+             MPI_UINT64_T, MPI_MAX, theMPISystem()->getMasterRank(),
+             theMPISystem()->getLocalComm());
+  MASTER_EXCLUSIVE_SECTION {
+    MPI_Send(reduced.data(), static_cast<int>(reduced.size()), MPI_UINT64_T,
+             theMPISystem()->getManagerRank(), TRANSFER_MEMORY_REPORT_TAG,
+             theMPISystem()->getGlobalComm());
   }
 }
 
@@ -374,6 +459,12 @@ SignalType ProcessGroupWorker::wait() {
       processDuration(*currentTask_, e, theMPISystem()->getNumProcs());
 
     } break;
+    case SEND_CHECKPOINT: {  // send a task's checkpoint to the group replacing its owner
+      sendCheckpoint();
+    } break;
+    case RESTORE_FROM_CHECKPOINT: {  // receive a task and restore it from the buddy checkpoint
+      restoreFromCheckpoint();
+    } break;
     case RECOVER_COMM: {  // start recovery in case of faults
       theMPISystem()->recoverCommunicators(true);
       return signal;
@@ -437,6 +528,19 @@ SignalType ProcessGroupWorker::wait() {
       sendNormsToManager(lpnorm);
       Stats::stopEvent("eval error norm");
     } break;
+    case EVAL_NORM_BUNDLE: {  // evaluate all requested norms at once and send
+      Stats::startEvent("eval norm bundle");
+      auto leval = receiveLevalAndBroadcast();
+      NormBundleType bundle;
+      MASTER_EXCLUSIVE_SECTION {
+        MPI_Recv(&bundle, 1, MPI_INT, theMPISystem()->getManagerRank(), TRANSFER_NORM_TAG,
+                 theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+      }
+      MPI_Bcast(&bundle, 1, MPI_INT, theMPISystem()->getMasterRank(),
+                theMPISystem()->getLocalComm());
+      sendNormsToManager(evalNormBundle(leval, bundle));
+      Stats::stopEvent("eval norm bundle");
+    } break;
     case INTERPOLATE_VALUES: {  // interpolate values on given coordinates
       Stats::startEvent("interpolate values");
       auto values =
@@ -481,6 +585,11 @@ SignalType ProcessGroupWorker::wait() {
           receiveStringFromManagerAndBroadcastToGroup());
       Stats::stopEvent("write interpolated values");
     } break;
+    case GET_MEMORY_REPORT: {  // reduce tracked memory over the group and send
+      Stats::startEvent("get memory report");
+      reduceAndSendMemoryReportToManager();
+      Stats::stopEvent("get memory report");
+    } break;
     case RESCHEDULE_ADD_TASK: {
       assert(currentTask_ == nullptr);
 
@@ -681,6 +790,7 @@ void ProcessGroupWorker::exit() {
     if (chdir("../ginstance")) {
     };
   }
+  buddyCheckpoint_.complete();
   deleteTasks();
 }
 
@@ -717,11 +827,12 @@ void reduceSparseGridCoefficients(LevelVector& lmax, LevelVector& lmin,
   }
 }
 
-void registerAllSubspacesInDSGU(DistributedSparseGridUniform<CombiDataType>& dsgu,
+void registerAllSubspacesInDSGU(DistributedSparseGridUniform<SparseGridDataType>& dsgu,
                                 const CombiParameters& combiParameters) {
+  const auto allLevelVectors = dsgu.getAllLevelVectors();
   // the last level vector should have the highest level sum
-  const auto highestLevelSum = levelSum(dsgu.getAllLevelVectors().back());
-  for (const auto& level : dsgu.getAllLevelVectors()) {
+  const auto highestLevelSum = levelSum(allLevelVectors.back());
+  for (const auto& level : allLevelVectors) {
     if (levelSum(level) == highestLevelSum) {
       const auto& boundary = combiParameters.getBoundary();
       auto dfgDecomposition = combigrid::downsampleDecomposition(
@@ -765,21 +876,39 @@ void ProcessGroupWorker::initCombinedUniDSGVector() {
   // get all subspaces in the (optimized) combischeme, create dsgs
   combinedUniDSGVector_.resize(static_cast<size_t>(combiParameters_.getNumGrids()));
   for (auto& uniDSG : combinedUniDSGVector_) {
-    uniDSG = std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>(
-        new DistributedSparseGridUniform<CombiDataType>(combiParameters_.getDim(), lmax, lmin,
-                                                        theMPISystem()->getLocalComm()));
+    uniDSG = std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>(
+        new DistributedSparseGridUniform<SparseGridDataType>(combiParameters_.getDim(), lmax,
+                                                             lmin, theMPISystem()->getLocalComm()));
     // // this registers all possible subspaces in the DSGU
     // // can be used to test the memory consumption of the "filled" DSGU
     // registerAllSubspacesInDSGU(*uniDSG, combiParameters_);
   }
 
-  // register dsgs in all dfgs
+  // with a uniform decomposition, the subspace sizes follow from the component grid levels;
+  // otherwise, register dsgs in all dfgs
+  const bool computeSubspaceSizes = !combiParameters_.getDecomposition().empty();
+  SparseGridPartition partition;
+  std::vector<LevelVector> localLevels;
+  if (computeSubspaceSizes) {
+    partition = getSparseGridPartition();
+    for (Task* t : tasks_) localLevels.push_back(t->getLevelVector());
+  }
   Stats::startEvent("register dsgus");
   for (size_t g = 0; g < combinedUniDSGVector_.size(); ++g) {
-    for (Task* t : tasks_) {
-      DistributedFullGrid<CombiDataType>& dfg = t->getDistributedFullGrid(static_cast<int>(g));
-      // set subspace sizes locally
-      combinedUniDSGVector_[g]->registerDistributedFullGrid(dfg);
+    if (computeSubspaceSizes) {
+      combinedUniDSGVector_[g]->registerCombinationLevels(localLevels, partition);
+    }
+#ifdef NDEBUG
+    if (!computeSubspaceSizes)
+#endif  // NDEBUG
+    {
+      // (in debug builds, this also checks the computed sizes)
+      for (Task* t : tasks_) {
+        // set subspace sizes locally
+        t->visitDistributedFullGrid(
+            [&](auto& dfg) { combinedUniDSGVector_[g]->registerDistributedFullGrid(dfg); },
+            static_cast<int>(g));
+      }
     }
     // // we may clear the levels_ member of the sparse grids here to save memory
     // // but only if we need no new full grids initialized from the sparse grids!
@@ -787,37 +916,74 @@ void ProcessGroupWorker::initCombinedUniDSGVector() {
     // combinedUniDSGVector_[(size_t) g]->resetLevels();
 
     // create the kahan buffer now, so it has only the subspaces present on the grids in this
-    // process group
+    // process group (unless the sparse grids are lean, then there is no kahan buffer)
+    combinedUniDSGVector_[g]->setKahanSummation(!combiParameters_.isLeanSparseGrids());
     combinedUniDSGVector_[g]->createKahanBuffer();
   }
   Stats::stopEvent("register dsgus");
 
-  // global reduce of subspace sizes
-  CommunicatorType globalReduceComm = theMPISystem()->getGlobalReduceComm();
-  for (auto& uniDSG : combinedUniDSGVector_) {
-    uniDSG->reduceSubspaceSizes(globalReduceComm);
+  // without the scheme's levels (e.g. in the worker-only mode), the other groups' grids are
+  // not known here
+  if (computeSubspaceSizes && combiParameters_.getNumLevels() > 0) {
+    // the sizes of all component grids in the scheme, which the global reduce of the sizes
+    // would yield, without communication
+    Stats::startEvent("compute subspace sizes");
+    std::vector<LevelVector> allLevels;
+    for (const auto& idAndLevel : combiParameters_.getLevelsDict()) {
+      allLevels.push_back(idAndLevel.second);
+    }
+    for (auto& uniDSG : combinedUniDSGVector_) {
+      uniDSG->registerCombinationLevels(allLevels, partition);
+    }
+    Stats::stopEvent("compute subspace sizes");
+  } else {
+    // global reduce of subspace sizes
+    CommunicatorType globalReduceComm = theMPISystem()->getGlobalReduceComm();
+    for (auto& uniDSG : combinedUniDSGVector_) {
+      uniDSG->reduceSubspaceSizes(globalReduceComm);
+    }
   }
 }
 
-void ProcessGroupWorker::hierarchizeFullGrids() {
+template <typename FG_ELEMENT>
+void ProcessGroupWorker::hierarchizeFullGrid(DistributedFullGrid<FG_ELEMENT>& dfg) const {
+  bool anyNotBoundary =
+      std::any_of(combiParameters_.getBoundary().begin(), combiParameters_.getBoundary().end(),
+                  [](BoundaryType b) { return b == 0; });
+  if (anyNotBoundary) {
+    LevelVector zeroLMin = LevelVector(combiParameters_.getDim(), 0);
+    DistributedHierarchization::hierarchize<FG_ELEMENT>(
+        dfg, combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
+        zeroLMin);
+  } else {
+    DistributedHierarchization::hierarchize<FG_ELEMENT>(
+        dfg, combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
+        combiParameters_.getLMin());
+  }
+}
+
+template <typename FG_ELEMENT>
+void ProcessGroupWorker::dehierarchizeFullGrid(DistributedFullGrid<FG_ELEMENT>& dfg) const {
   bool anyNotBoundary =
       std::any_of(combiParameters_.getBoundary().begin(), combiParameters_.getBoundary().end(),
                   [](BoundaryType b) { return b == 0; });
+  if (anyNotBoundary) {
+    LevelVector zeroLMin = LevelVector(combiParameters_.getDim(), 0);
+    DistributedHierarchization::dehierarchizeDFG(dfg, combiParameters_.getHierarchizationDims(),
+                                                 combiParameters_.getHierarchicalBases(), zeroLMin);
+  } else {
+    DistributedHierarchization::dehierarchizeDFG(dfg, combiParameters_.getHierarchizationDims(),
+                                                 combiParameters_.getHierarchicalBases(),
+                                                 combiParameters_.getLMin());
+  }
+}
+
+void ProcessGroupWorker::hierarchizeFullGrids() {
   for (Task* t : tasks_) {
     for (IndexType g = 0; g < combiParameters_.getNumGrids(); g++) {
-      DistributedFullGrid<CombiDataType>& dfg = t->getDistributedFullGrid(static_cast<int>(g));
-
-      // hierarchize dfg
-      if (anyNotBoundary) {
-        LevelVector zeroLMin = LevelVector(combiParameters_.getDim(), 0);
-        DistributedHierarchization::hierarchize<CombiDataType>(
-            dfg, combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
-            zeroLMin);
-      } else {
-        DistributedHierarchization::hierarchize<CombiDataType>(
-            dfg, combiParameters_.getHierarchizationDims(), combiParameters_.getHierarchicalBases(),
-            combiParameters_.getLMin());
-      }
+      STATS_SCOPED_EVENT("hierarchize grid");
+      t->visitDistributedFullGrid([this](auto& dfg) { hierarchizeFullGrid(dfg); },
+                                  static_cast<int>(g));
     }
   }
 }
@@ -827,12 +993,20 @@ void ProcessGroupWorker::addFullGridsToUniformSG() {
          "Initialize dsgu first with "
          "initCombinedUniDSGVector()");
   auto numGrids = combiParameters_.getNumGrids();
+  std::vector<std::vector<bool>> subspacesToCombine(numGrids);
+  for (IndexType g = 0; g < numGrids; g++) {
+    subspacesToCombine[g] = getSubspacesToCombine(g);
+  }
   for (Task* t : tasks_) {
     for (IndexType g = 0; g < numGrids; g++) {
-      DistributedFullGrid<CombiDataType>& dfg = t->getDistributedFullGrid(static_cast<int>(g));
-
       // lokales reduce auf sg ->
-      combinedUniDSGVector_[g]->addDistributedFullGrid(dfg, t->getCoefficient());
+      STATS_SCOPED_EVENT("add grid to sparse grid");
+      t->visitDistributedFullGrid(
+          [&](auto& dfg) {
+            combinedUniDSGVector_[g]->addDistributedFullGrid(dfg, t->getCoefficient(),
+                                                             subspacesToCombine[g]);
+          },
+          static_cast<int>(g));
     }
   }
 }
@@ -842,11 +1016,24 @@ void ProcessGroupWorker::reduceUniformSG() {
   auto numGrids = combiParameters_.getNumGrids();
 
   for (IndexType g = 0; g < numGrids; g++) {
-    CombiCom::distributedGlobalReduce(*combinedUniDSGVector_[g]);
+    CombiCom::distributedGlobalReduce(*combinedUniDSGVector_[g], getSubspacesToCombine(g));
     assert(CombiCom::sumAndCheckSubspaceSizes(*combinedUniDSGVector_[g]));
   }
 }
 
+std::vector<bool> ProcessGroupWorker::getSubspacesToCombine(IndexType g) const {
+  if (!combiParameters_.isPartialCombination(currentCombi_)) {
+    return {};
+  }
+  const auto& dsg = *combinedUniDSGVector_[g];
+  const auto coarseLevelSum = combiParameters_.getPartialCombinationCoarseLevelSum();
+  std::vector<bool> subspacesToCombine(dsg.getNumSubspaces());
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    subspacesToCombine[i] = levelSum(dsg.getLevelVector(i)) <= coarseLevelSum;
+  }
+  return subspacesToCombine;
+}
+
 void ProcessGroupWorker::combineLocalAndGlobal() {
   assert(combinedUniDSGVector_.size() > 0 && "Initialize dsgu first with "
                                              "initCombinedUniDSGVector()");
@@ -872,6 +1059,154 @@ void ProcessGroupWorker::combineUniform() {
   integrateCombinedSolution();
 }
 
+void ProcessGroupWorker::runAndCombinePipelined(size_t chunkSize) {
+  assert(combinedUniDSGVector_.size() > 0 && "Initialize dsgu first with "
+                                             "initCombinedUniDSGVector()");
+  assert(!ENABLE_FT);
+  // the chunks follow the data layout, not the subspace selection
+  if (combiParameters_.getPartialCombinationInterval() > 1) {
+    throw std::runtime_error("pipelined combination cannot be used with partial combination");
+  }
+  if (chunkSize == 0) {
+    throw std::runtime_error("pipelined combination needs a positive chunk size");
+  }
+  const auto numGrids = static_cast<int>(combiParameters_.getNumGrids());
+
+  zeroDsgsData();
+
+  // the reduce chunks each task contributes to (and needs back), per grid, and the position of
+  // the last task contributing to each chunk (-1 if none of this group's tasks does)
+  std::vector<std::vector<std::vector<size_t>>> chunksOfTask(
+      tasks_.size(), std::vector<std::vector<size_t>>(numGrids));
+  std::vector<std::vector<int>> lastContributor(numGrids);
+  std::vector<std::vector<MPI_Request>> requests(numGrids);
+  for (int g = 0; g < numGrids; g++) {
+    const auto& dsg = *combinedUniDSGVector_[g];
+    const auto numChunks = CombiCom::getNumGlobalReduceChunks(dsg, chunkSize);
+    lastContributor[g].assign(numChunks, -1);
+    requests[g].assign(numChunks, MPI_REQUEST_NULL);
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      std::vector<bool> isContributing(numChunks, false);
+      const auto taskLevel =
+          tasks_[i]->visitDistributedFullGrid([](auto& dfg) { return dfg.getLevels(); }, g);
+      forEachLevelInDownSet(taskLevel, [&](const LevelVector& level) {
+        const auto sIndex = dsg.getIndex(level);
+        if (sIndex > -1 && dsg.getDataSize(sIndex) > 0) {
+          const auto offset = static_cast<size_t>(dsg.getData(sIndex) - dsg.getRawData());
+          const auto last = (offset + dsg.getDataSize(sIndex) - 1) / chunkSize;
+          for (auto c = offset / chunkSize; c <= last; ++c) isContributing[c] = true;
+        }
+      });
+      for (size_t c = 0; c < numChunks; ++c) {
+        if (isContributing[c]) {
+          chunksOfTask[i][g].push_back(c);
+          lastContributor[g][c] = static_cast<int>(i);
+        }
+      }
+    }
+  }
+
+  // start the chunks whose contributions are complete, in the same order on all groups: grid by
+  // grid, and the chunks of each grid backwards
+  int nextGrid = 0;
+  size_t numChunksStartedOfGrid = 0;
+  auto startCompleteChunks = [&](int numTasksAdded) {
+    while (nextGrid < numGrids) {
+      const auto c = requests[nextGrid].size() - 1 - numChunksStartedOfGrid;
+      if (lastContributor[nextGrid][c] >= numTasksAdded) break;
+      requests[nextGrid][c] =
+          CombiCom::distributedGlobalReduceChunk(*combinedUniDSGVector_[nextGrid], c, chunkSize);
+      if (++numChunksStartedOfGrid == requests[nextGrid].size()) {
+        ++nextGrid;
+        numChunksStartedOfGrid = 0;
+      }
+    }
+  };
+  // let MPI progress the reduce while computing
+  auto testAllChunks = [&requests]() {
+    for (auto& gridRequests : requests) {
+      int flag;
+      MPI_Testall(static_cast<int>(gridRequests.size()), gridRequests.data(), &flag,
+                  MPI_STATUSES_IGNORE);
+    }
+  };
+
+  for (auto task : tasks_) {
+    task->setFinished(false);
+  }
+  status_ = PROCESS_GROUP_BUSY;
+  for (size_t i = 0; i < tasks_.size(); ++i) {
+    currentTask_ = tasks_[i];
+    Stats::startEvent("run");
+    currentTask_->run(theMPISystem()->getLocalComm());
+    Stats::stopEvent("run");
+
+    Stats::startEvent("hierarchize");
+    for (int g = 0; g < numGrids; g++) {
+      STATS_SCOPED_EVENT("hierarchize grid");
+      currentTask_->visitDistributedFullGrid([this](auto& dfg) { hierarchizeFullGrid(dfg); }, g);
+    }
+    Stats::stopEvent("hierarchize");
+
+    Stats::startEvent("local reduce");
+    for (int g = 0; g < numGrids; g++) {
+      STATS_SCOPED_EVENT("add grid to sparse grid");
+      currentTask_->visitDistributedFullGrid(
+          [&](auto& dfg) {
+            combinedUniDSGVector_[g]->addDistributedFullGrid(dfg, currentTask_->getCoefficient());
+          },
+          g);
+    }
+    Stats::stopEvent("local reduce");
+
+    Stats::startEvent("global reduce");
+    startCompleteChunks(static_cast<int>(i + 1));
+    testAllChunks();
+    Stats::stopEvent("global reduce");
+  }
+  currentTask_ = nullptr;
+  status_ = PROCESS_GROUP_WAIT;
+
+  Stats::startEvent("global reduce");
+  startCompleteChunks(static_cast<int>(tasks_.size()));
+  assert(nextGrid == numGrids);
+  Stats::stopEvent("global reduce");
+
+  for (int g = 0; g < numGrids; g++) {
+    for (size_t i = 0; i < tasks_.size(); ++i) {
+      Stats::startEvent("global reduce");
+      for (const auto& c : chunksOfTask[i][g]) {
+        MPI_Wait(&requests[g][c], MPI_STATUS_IGNORE);
+      }
+      Stats::stopEvent("global reduce");
+
+      tasks_[i]->visitDistributedFullGrid(
+          [&](auto& dfg) {
+            {
+              STATS_SCOPED_EVENT("extract grid from sparse grid");
+              dfg.extractFromUniformSG(*combinedUniDSGVector_[g]);
+            }
+            Stats::startEvent("dehierarchize");
+            dehierarchizeFullGrid(dfg);
+            Stats::stopEvent("dehierarchize");
+          },
+          g);
+      testAllChunks();
+    }
+  }
+  // the chunks no task of this group needs
+  Stats::startEvent("global reduce");
+  for (auto& gridRequests : requests) {
+    MPI_Waitall(static_cast<int>(gridRequests.size()), gridRequests.data(), MPI_STATUSES_IGNORE);
+  }
+  Stats::stopEvent("global reduce");
+  currentCombi_++;
+
+  if (combiParameters_.isBuddyCheckpointing()) {
+    buddyCheckpoint_.post(tasks_, numGrids, theMPISystem()->getGlobalReduceComm());
+  }
+}
+
 void ProcessGroupWorker::parallelEval() {
   if (uniformDecomposition)
     parallelEvalUniform(receiveStringFromManagerAndBroadcastToGroup(), receiveLevalAndBroadcast());
@@ -895,8 +1230,13 @@ inline std::ostream& operator<<(std::ostream& os, const std::vector<bool>& l) {
   return os;
 }
 
-void ProcessGroupWorker::fillDFGFromDSGU(DistributedFullGrid<CombiDataType>& dfg,
+template <typename FG_ELEMENT>
+void ProcessGroupWorker::fillDFGFromDSGU(DistributedFullGrid<FG_ELEMENT>& dfg,
                                          IndexType g) const {
+  if (isSparseGridPartiallyCombined()) {
+    throw std::runtime_error(
+        "fillDFGFromDSGU: the sparse grid is only partially combined, do a full combination first");
+  }
   // fill dfg with hierarchical coefficients from distributed sparse grid
   dfg.extractFromUniformSG(*combinedUniDSGVector_[g]);
 
@@ -921,7 +1261,7 @@ void ProcessGroupWorker::fillDFGFromDSGU(Task* t) const {
           .getNumGrids());  // we assume here that every task has the same number of grids
   for (int g = 0; g < numGrids; g++) {
     assert(combinedUniDSGVector_[g] != nullptr);
-    this->fillDFGFromDSGU(t->getDistributedFullGrid(g), g);
+    t->visitDistributedFullGrid([&](auto& dfg) { this->fillDFGFromDSGU(dfg, g); }, g);
   }
 }
 
@@ -936,6 +1276,17 @@ void ProcessGroupWorker::parallelEvalUniform(std::string filename, LevelVector l
   const auto dim = static_cast<DimType>(leval.size());
 
   for (IndexType g = 0; g < numGrids; g++) {  // loop over all grids and plot them
+    if (useSparseGridEvaluation()) {
+      bool writeVTK = endsWith(filename, ".vtk");
+      std::string fn = filename;
+      auto pos = fn.find(".");
+      if (!writeVTK && pos != std::string::npos) {
+        // if filename contains ".", insert grid number before that
+        fn.insert(pos, "_" + std::to_string(g));
+      }
+      writeUniformFromSparseGrid(fn, leval, g, writeVTK);
+      continue;
+    }
     // create dfg
     bool forwardDecomposition = combiParameters_.getForwardDecomposition();
     auto levalDecomposition = combigrid::downsampleDecomposition(
@@ -966,83 +1317,342 @@ std::vector<double> ProcessGroupWorker::getLpNorms(int p) const {
   std::vector<double> lpnorms;
   lpnorms.reserve(tasks_.size());
   for (const auto& t : tasks_) {
-    auto lpnorm = t->getDistributedFullGrid().getLpNorm(p);
+    auto lpnorm = t->visitDistributedFullGrid([p](auto& dfg) { return dfg.getLpNorm(p); });
     lpnorms.push_back(lpnorm);
   }
   return lpnorms;
 }
 
 std::vector<double> ProcessGroupWorker::parallelEvalNorm(LevelVector leval) const {
-  const auto dim = static_cast<DimType>(leval.size());
-  bool forwardDecomposition = combiParameters_.getForwardDecomposition();
-  auto levalDecomposition = combigrid::downsampleDecomposition(combiParameters_.getDecomposition(),
-                                                               combiParameters_.getLMax(), leval,
-                                                               combiParameters_.getBoundary());
+  return evalNormBundle(leval, COMBINED_NORMS);
+}
 
-  DistributedFullGrid<CombiDataType> dfg(
-      dim, leval, theMPISystem()->getLocalComm(), combiParameters_.getBoundary(),
-      combiParameters_.getParallelization(), forwardDecomposition, levalDecomposition);
+std::vector<double> ProcessGroupWorker::evalAnalyticalOnDFG(LevelVector leval) const {
+  return evalNormBundle(leval, ANALYTICAL_NORMS);
+}
+
+std::vector<double> ProcessGroupWorker::evalErrorOnDFG(LevelVector leval) const {
+  return evalNormBundle(leval, ERROR_NORMS);
+}
 
-  this->fillDFGFromDSGU(dfg, 0);
+std::vector<double> ProcessGroupWorker::evalNormBundle(const LevelVector& leval,
+                                                       NormBundleType bundle) const {
+  // one accumulator per set of norms, all of them are reduced at once
+  const size_t numTaskNorms = (bundle & TASK_NORMS) ? tasks_.size() : 0;
+  std::vector<LpNormAccumulator> accumulators(numTaskNorms);
+  std::vector<real> innerNodalBasisFunctionIntegrals;
+  for (size_t i = 0; i < numTaskNorms; ++i) {
+    tasks_[i]->visitDistributedFullGrid([&](auto& dfg) {
+      dfg.accumulateLpNorms(accumulators[i]);
+      innerNodalBasisFunctionIntegrals.push_back(dfg.getInnerNodalBasisFunctionIntegral());
+    });
+  }
+  real levalInnerNodalBasisFunctionIntegral = 1.;
+  for (const auto& l : leval) {
+    levalInnerNodalBasisFunctionIntegral *= oneOverPowOfTwo[l];
+  }
+  for (auto levalNorms : {COMBINED_NORMS, ANALYTICAL_NORMS, ERROR_NORMS}) {
+    if (bundle & levalNorms) {
+      accumulators.emplace_back();
+      innerNodalBasisFunctionIntegrals.push_back(levalInnerNodalBasisFunctionIntegral);
+    }
+  }
+  if (accumulators.size() > numTaskNorms) {
+    auto next = accumulators.begin() + static_cast<std::ptrdiff_t>(numTaskNorms);
+    LpNormAccumulator* combined = (bundle & COMBINED_NORMS) ? &*(next++) : nullptr;
+    LpNormAccumulator* analytical = (bundle & ANALYTICAL_NORMS) ? &*(next++) : nullptr;
+    LpNormAccumulator* error = (bundle & ERROR_NORMS) ? &*(next++) : nullptr;
+    accumulateNormsOnUniformGrid(leval, combined, analytical, error);
+  }
 
-  std::vector<double> lpnorms;
-  for (int p = 0; p < 3; ++p) {
-    lpnorms.push_back(dfg.getLpNorm(p));
+  LpNormAccumulator::allreduce(accumulators, theMPISystem()->getLocalComm());
+  std::vector<double> norms;
+  norms.reserve(3 * accumulators.size());
+  for (size_t i = 0; i < accumulators.size(); ++i) {
+    auto lpNorms = accumulators[i].getNorms(innerNodalBasisFunctionIntegrals[i]);
+    norms.insert(norms.end(), lpNorms.begin(), lpNorms.end());
   }
-  return lpnorms;
+  return norms;
 }
 
-std::vector<double> ProcessGroupWorker::evalAnalyticalOnDFG(LevelVector leval) const {
-  const auto dim = static_cast<DimType>(leval.size());
-  bool forwardDecomposition = combiParameters_.getForwardDecomposition();
-  auto levalDecomposition = combigrid::downsampleDecomposition(combiParameters_.getDecomposition(),
-                                                               combiParameters_.getLMax(), leval,
-                                                               combiParameters_.getBoundary());
-
-  DistributedFullGrid<CombiDataType> dfg(
-      dim, leval, theMPISystem()->getLocalComm(), combiParameters_.getBoundary(),
-      combiParameters_.getParallelization(), forwardDecomposition, levalDecomposition);
+SparseGridPartition ProcessGroupWorker::getSparseGridPartition() const {
+  const auto dim = combiParameters_.getDim();
+  const auto& lmax = combiParameters_.getLMax();
+  const auto& boundary = combiParameters_.getBoundary();
+  const auto& decomposition = combiParameters_.getDecomposition();
+  assert(decomposition.size() == dim);
+  bool anyNotBoundary = std::any_of(boundary.begin(), boundary.end(),
+                                    [](BoundaryType b) { return b == 0; });
+
+  SparseGridPartition partition{lmax, boundary, IndexVector(dim), IndexVector(dim),
+                                LevelVector(dim, 0)};
+  MPICartesianUtils cartesianUtils(theMPISystem()->getLocalComm());
+  std::vector<int> partitionCoords;
+  cartesianUtils.getPartitionCoordsOfRank(theMPISystem()->getLocalRank(), partitionCoords);
+  for (DimType d = 0; d < dim; ++d) {
+    const auto& decomposition1d = decomposition[d];
+    const auto c = static_cast<size_t>(partitionCoords[d]);
+    partition.lowerBounds[d] = decomposition1d[c];
+    partition.upperBounds[d] = (c + 1 < decomposition1d.size())
+                                   ? decomposition1d[c + 1]
+                                   : combigrid::getNumDofNodal(lmax[d], boundary[d]);
+    // cf. hierarchizeFullGrids
+    if (!combiParameters_.getHierarchizationDims()[d]) {
+      partition.nodalLevel[d] = lmax[d];
+    } else if (!anyNotBoundary) {
+      partition.nodalLevel[d] = combiParameters_.getLMin()[d];
+    }
+  }
+  return partition;
+}
 
-  // interpolate Task's analyticalSolution
-  for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
-    std::vector<double> coords(leval.size());
-    dfg.getCoordsLocal(li, coords);
+bool ProcessGroupWorker::isSparseGridPartiallyCombined() const {
+  // after a partial combination, the fine subspaces do not hold the combined solution
+  return currentCombi_ > 0 && combiParameters_.isPartialCombination(currentCombi_ - 1);
+}
 
-    dfg.getData()[li] = tasks_[0]->analyticalSolution(coords, 0);
+bool ProcessGroupWorker::canEvalOnSparseGrid() const {
+  // without a given decomposition, the component grids are partitioned independently, so the
+  // local subspace data cannot be attributed to a part of the domain
+  if (combiParameters_.getDecomposition().empty() || combinedUniDSGVector_.empty() ||
+      !combinedUniDSGVector_[0]->isSubspaceDataCreated() || isSparseGridPartiallyCombined()) {
+    return false;
+  }
+  // the surpluses are evaluated with hats
+  for (DimType d = 0; d < combiParameters_.getDim(); ++d) {
+    if (!combiParameters_.getHierarchizationDims()[d]) continue;
+    auto basis = combiParameters_.getHierarchicalBases()[d];
+    if (dynamic_cast<HierarchicalHatBasisFunction*>(basis) == nullptr &&
+        dynamic_cast<HierarchicalHatPeriodicBasisFunction*>(basis) == nullptr) {
+      return false;
+    }
   }
+  return true;
+}
 
-  std::vector<double> lpnorms;
-  for (int p = 0; p < 3; ++p) {
-    lpnorms.push_back(dfg.getLpNorm(p));
-  }
-  return lpnorms;
+bool ProcessGroupWorker::useSparseGridEvaluation() const {
+  return combiParameters_.getEvalMemoryBudget() > 0 && canEvalOnSparseGrid();
 }
 
-std::vector<double> ProcessGroupWorker::evalErrorOnDFG(LevelVector leval) const {
-  const auto dim = static_cast<DimType>(leval.size());
-  bool forwardDecomposition = combiParameters_.getForwardDecomposition();
-  auto levalDecomposition = combigrid::downsampleDecomposition(combiParameters_.getDecomposition(),
-                                                               combiParameters_.getLMax(), leval,
-                                                               combiParameters_.getBoundary());
+std::vector<SparseGridDataType> ProcessGroupWorker::evalOnSparseGrid(
+    const std::vector<std::vector<real>>& interpolationCoords, IndexType g) const {
+  if (!canEvalOnSparseGrid()) {
+    throw std::runtime_error("evalOnSparseGrid: the sparse grid cannot be evaluated directly");
+  }
+  std::vector<size_t> contributingIndices;
+  std::vector<SparseGridDataType> contributions;
+  combinedUniDSGVector_[g]->evalLocalContributions(interpolationCoords, getSparseGridPartition(),
+                                                   contributingIndices, contributions);
+  std::vector<SparseGridDataType> values(interpolationCoords.size(), 0.);
+  sumContributionsAtMaster(contributingIndices, contributions, values);
+  MPI_Bcast(values.data(), static_cast<int>(values.size()),
+            abstraction::getMPIDatatype(abstraction::getabstractionDataType<SparseGridDataType>()),
+            theMPISystem()->getMasterRank(), theMPISystem()->getLocalComm());
+  return values;
+}
 
-  DistributedFullGrid<CombiDataType> dfg(
-      dim, leval, theMPISystem()->getLocalComm(), combiParameters_.getBoundary(),
-      combiParameters_.getParallelization(), forwardDecomposition, levalDecomposition);
+void ProcessGroupWorker::accumulateNormsOnUniformGrid(const LevelVector& leval,
+                                                      LpNormAccumulator* combined,
+                                                      LpNormAccumulator* analytical,
+                                                      LpNormAccumulator* error) const {
+  const bool needCombined = combined != nullptr || error != nullptr;
+  const bool needAnalytical = analytical != nullptr || error != nullptr;
+  // the values are accumulated in the sparse grid's precision
+  auto accumulate = [&](SparseGridDataType value, const std::vector<real>& coords,
+                        real hatFunctionIntegral) {
+    if (combined != nullptr) combined->add(std::abs(value), hatFunctionIntegral);
+    if (needAnalytical) {
+      SparseGridDataType analyticalValue = tasks_[0]->analyticalSolution(coords, 0);
+      if (analytical != nullptr) analytical->add(std::abs(analyticalValue), hatFunctionIntegral);
+      if (error != nullptr) error->add(std::abs(value - analyticalValue), hatFunctionIntegral);
+    }
+  };
+  const auto dim = static_cast<DimType>(leval.size());
+  const auto& boundary = combiParameters_.getBoundary();
 
-  this->fillDFGFromDSGU(dfg, 0);
-  // interpolate Task's analyticalSolution
-  for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
-    std::vector<double> coords(leval.size());
-    dfg.getCoordsLocal(li, coords);
+  if (needCombined && !useSparseGridEvaluation()) {
+    // create the reference grid and evaluate on the local points
+    bool forwardDecomposition = combiParameters_.getForwardDecomposition();
+    auto levalDecomposition = combigrid::downsampleDecomposition(
+        combiParameters_.getDecomposition(), combiParameters_.getLMax(), leval, boundary);
+    DistributedFullGrid<CombiDataType> dfg(
+        dim, leval, theMPISystem()->getLocalComm(), boundary,
+        combiParameters_.getParallelization(), forwardDecomposition, levalDecomposition);
+    this->fillDFGFromDSGU(dfg, 0);
+    const auto data = dfg.getData();
+    dfg.forEachLocalPointWithCoords(
+        [&](IndexType li, const std::vector<real>& coords, real hatFunctionIntegral) {
+          accumulate(data[li], coords, hatFunctionIntegral);
+        });
+    return;
+  }
 
-    dfg.getData()[li] -= tasks_[0]->analyticalSolution(coords, 0);
+  const auto& localComm = theMPISystem()->getLocalComm();
+  const auto localRank = theMPISystem()->getLocalRank();
+  const auto numProcs = theMPISystem()->getNumProcs();
+  const auto valueType =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<SparseGridDataType>());
+
+  // the points of the reference grid are evaluated chunk-wise, so only one chunk of values is
+  // held at a time; the chunks are summed up (if the combined solution is needed) and
+  // accumulated at alternating processes
+  IndexVector numPoints(dim);
+  IndexType numPointsTotal = 1;
+  for (DimType d = 0; d < dim; ++d) {
+    numPoints[d] = combigrid::getNumDofNodal(leval[d], boundary[d]);
+    numPointsTotal *= numPoints[d];
+  }
+  const auto chunkSize = std::min(numPointsTotal, sparseGridEvaluationChunkSize);
+  std::vector<std::vector<real>> chunkCoords(chunkSize, std::vector<real>(dim));
+  std::vector<size_t> contributingIndices;
+  std::vector<SparseGridDataType> contributions;
+  std::vector<SparseGridDataType> chunkValues(chunkSize, 0.);
+  SparseGridPartition partition;
+  if (needCombined) {
+    partition = getSparseGridPartition();
+  }
+
+  IndexType chunkNumber = 0;
+  for (IndexType chunkStart = 0; chunkStart < numPointsTotal; chunkStart += chunkSize) {
+    const auto numInChunk = std::min(chunkSize, numPointsTotal - chunkStart);
+    const auto root = static_cast<RankType>(chunkNumber % numProcs);
+    ++chunkNumber;
+    if (!needCombined && localRank != root) continue;
+
+    chunkCoords.resize(numInChunk);
+    getCoordsOfUniformGridPoints(chunkStart, numPoints, leval, boundary, chunkCoords);
+    if (needCombined) {
+      contributingIndices.clear();
+      contributions.clear();
+      combinedUniDSGVector_[0]->evalLocalContributions(chunkCoords, partition,
+                                                       contributingIndices, contributions);
+      std::fill(chunkValues.begin(), chunkValues.end(), 0.);
+      for (size_t k = 0; k < contributingIndices.size(); ++k) {
+        chunkValues[contributingIndices[k]] += contributions[k];
+      }
+      if (localRank == root) {
+        MPI_Reduce(MPI_IN_PLACE, chunkValues.data(), static_cast<int>(numInChunk), valueType,
+                   MPI_SUM, root, localComm);
+      } else {
+        MPI_Reduce(chunkValues.data(), nullptr, static_cast<int>(numInChunk), valueType, MPI_SUM,
+                   root, localComm);
+        continue;
+      }
+    }
+    for (IndexType i = 0; i < numInChunk; ++i) {
+      // cf. DistributedFullGrid::getLpNorm
+      unsigned int numBoundaryDims = 0;
+      for (DimType d = 0; d < dim; ++d) {
+        if (boundary[d] == 2 && (chunkCoords[i][d] == 0. || chunkCoords[i][d] == 1.)) {
+          ++numBoundaryDims;
+        }
+      }
+      accumulate(chunkValues[i], chunkCoords[i], oneOverPowOfTwo[numBoundaryDims]);
+    }
   }
+}
 
-  std::vector<double> lpnorms;
-  for (int p = 0; p < 3; ++p) {
-    lpnorms.push_back(dfg.getLpNorm(p));
+void ProcessGroupWorker::writeUniformFromSparseGrid(const std::string& filename,
+                                                    const LevelVector& leval, IndexType g,
+                                                    bool writeVTK) const {
+  if (!canEvalOnSparseGrid()) {
+    throw std::runtime_error(
+        "writeUniformFromSparseGrid: the sparse grid cannot be evaluated directly");
   }
-  return lpnorms;
+  const auto dim = static_cast<DimType>(leval.size());
+  const auto& boundary = combiParameters_.getBoundary();
+  const auto partition = getSparseGridPartition();
+  const auto& localComm = theMPISystem()->getLocalComm();
+  const auto localRank = theMPISystem()->getLocalRank();
+  const auto numProcs = static_cast<IndexType>(theMPISystem()->getNumProcs());
+  // the values are summed up in the sparse grid's precision, but written like the output grid's
+  const auto sumType =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<SparseGridDataType>());
+  const auto valueType =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>());
+
+  IndexVector numPoints(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    numPoints[d] = combigrid::getNumDofNodal(leval[d], boundary[d]);
+  }
+  // the output grid is evaluated in slabs of whole planes orthogonal to the last dimension,
+  // which are contiguous in the (Fortran-ordered) file; per slab point, each process holds
+  // the slab value and its share of the summed values and the two write buffers
+  const IndexType numPointsPerPlane =
+      std::accumulate(numPoints.begin(), numPoints.end() - 1, IndexType(1),
+                      std::multiplies<IndexType>());
+  const IndexType numPlanes = numPoints.back();
+  const auto bytesPerPlane =
+      static_cast<size_t>(numPointsPerPlane) *
+      (sizeof(SparseGridDataType) * (numProcs + 1) + sizeof(CombiDataType) * 2) / numProcs;
+  const auto numPlanesPerSlab = std::min(
+      numPlanes,
+      std::max(IndexType(1),
+               static_cast<IndexType>(combiParameters_.getEvalMemoryBudget() / bytesPerPlane)));
+
+  // open file and write header, cf. DistributedFullGrid::writePlotFile(VTK)
+  MPI_File fh;
+  MPI_File_open(localComm, filename.c_str(), MPI_MODE_WRONLY + MPI_MODE_CREATE, MPI_INFO_NULL,
+                &fh);
+  MPI_Offset offset = 0;
+  if (writeVTK) {
+    assert(dim < 4);  // vtk supports only up to 3D
+    offset = DistributedFullGrid<CombiDataType>::writePlotFileVTKHeader(fh, numPoints,
+                                                                        localRank == 0);
+    MPI_File_set_view(fh, offset, valueType, valueType, "external32", MPI_INFO_NULL);
+  } else {
+    offset = DistributedFullGrid<CombiDataType>::writePlotFileHeader(fh, filename, numPoints,
+                                                                     localRank == 0);
+    MPI_File_set_view(fh, offset, valueType, valueType, "native", MPI_INFO_NULL);
+  }
+
+  std::vector<std::vector<real>> chunkCoords;
+  std::vector<size_t> contributingIndices;
+  std::vector<SparseGridDataType> contributions;
+  std::vector<SparseGridDataType> slabValues;
+  std::vector<SparseGridDataType> summedValues;
+  std::vector<int> numValuesPerRank(numProcs);
+  // while one buffer is written to file, the next slab is evaluated into the other one
+  std::array<std::vector<CombiDataType>, 2> writeBuffers;
+  std::array<MPI_Request, 2> writeRequests = {MPI_REQUEST_NULL, MPI_REQUEST_NULL};
+  size_t slabNumber = 0;
+  for (IndexType firstPlane = 0; firstPlane < numPlanes; firstPlane += numPlanesPerSlab) {
+    const auto slabStart = firstPlane * numPointsPerPlane;
+    const auto slabSize = std::min(numPlanesPerSlab, numPlanes - firstPlane) * numPointsPerPlane;
+    slabValues.assign(slabSize, 0.);
+    for (IndexType chunkStart = 0; chunkStart < slabSize;
+         chunkStart += sparseGridEvaluationChunkSize) {
+      chunkCoords.resize(std::min(sparseGridEvaluationChunkSize, slabSize - chunkStart));
+      getCoordsOfUniformGridPoints(slabStart + chunkStart, numPoints, leval, boundary,
+                                   chunkCoords);
+      contributingIndices.clear();
+      contributions.clear();
+      combinedUniDSGVector_[g]->evalLocalContributions(chunkCoords, partition,
+                                                       contributingIndices, contributions);
+      for (size_t k = 0; k < contributingIndices.size(); ++k) {
+        slabValues[chunkStart + contributingIndices[k]] += contributions[k];
+      }
+    }
+
+    // sum up the slab and scatter it evenly across the group
+    IndexType myOffsetInSlab = 0;
+    for (IndexType r = 0; r < numProcs; ++r) {
+      numValuesPerRank[r] = static_cast<int>(slabSize / numProcs + (r < slabSize % numProcs));
+      if (r < localRank) myOffsetInSlab += numValuesPerRank[r];
+    }
+    auto& writeBuffer = writeBuffers[slabNumber % 2];
+    auto& writeRequest = writeRequests[slabNumber % 2];
+    MPI_Wait(&writeRequest, MPI_STATUS_IGNORE);
+    summedValues.resize(numValuesPerRank[localRank]);
+    MPI_Reduce_scatter(slabValues.data(), summedValues.data(), numValuesPerRank.data(), sumType,
+                       MPI_SUM, localComm);
+    writeBuffer.assign(summedValues.begin(), summedValues.end());
+    MPI_File_iwrite_at(fh, slabStart + myOffsetInSlab, writeBuffer.data(),
+                       numValuesPerRank[localRank], valueType, &writeRequest);
+    ++slabNumber;
+  }
+  MPI_Waitall(2, writeRequests.data(), MPI_STATUSES_IGNORE);
+  MPI_File_close(&fh);
 }
 
 void ProcessGroupWorker::doDiagnostics() {
@@ -1058,10 +1668,15 @@ void ProcessGroupWorker::doDiagnostics() {
             abstraction::getMPIDatatype(abstraction::getabstractionDataType<decltype(taskID)>()),
             theMPISystem()->getMasterRank(), theMPISystem()->getLocalComm());
 
+  if (isSparseGridPartiallyCombined()) {
+    throw std::runtime_error(
+        "doDiagnostics: the sparse grid is only partially combined, do a full combination first");
+  }
+
   // call diagnostics on that Task
   for (auto task : tasks_) {
     if (task->getID() == taskID) {
-      std::vector<DistributedSparseGridUniform<CombiDataType>*> dsgsToPassToTask;
+      std::vector<DistributedSparseGridUniform<SparseGridDataType>*> dsgsToPassToTask;
       for (auto& dsgPtr : combinedUniDSGVector_) {
         dsgsToPassToTask.push_back(dsgPtr.get());
       }
@@ -1077,33 +1692,58 @@ std::vector<CombiDataType> ProcessGroupWorker::interpolateValues(const
   assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
   auto numCoordinates = interpolationCoords.size();
 
-  // call interpolation function on tasks and reduce with combination coefficient
+  // call interpolation function on tasks and reduce with combination coefficient;
+  // each process only evaluates the coordinates in its part of the domain
   std::vector<CombiDataType> values(numCoordinates, 0.);
   std::vector<CombiDataType> kahanTrailingTerm(numCoordinates, 0.);
+  std::vector<bool> isContributing(numCoordinates, false);
+  std::vector<size_t> contributingIndices;
+  std::vector<CombiDataType> contributions;
 
   for (Task* t : tasks_) {
     const auto coeff = t->getCoefficient();
-    for (size_t i = 0; i < numCoordinates; ++i) {
-      auto localValue = t->getDistributedFullGrid().evalLocal(interpolationCoords[i]);
-      auto summand = localValue * coeff;
+    contributingIndices.clear();
+    contributions.clear();
+    t->visitDistributedFullGrid([&](auto& dfg) {
+      // single precision tasks contribute in CombiDataType
+      std::vector<std::remove_reference_t<decltype(*dfg.getData())>> taskContributions;
+      dfg.evalLocalContributions(interpolationCoords, contributingIndices, taskContributions);
+      contributions.assign(taskContributions.begin(), taskContributions.end());
+    });
+    for (size_t k = 0; k < contributingIndices.size(); ++k) {
+      const auto i = contributingIndices[k];
+      auto summand = contributions[k] * coeff;
       // cf. https://en.wikipedia.org/wiki/Kahan_summation_algorithm
       volatile auto y = summand - kahanTrailingTerm[i];
       volatile auto t = values[i] + y;
       kahanTrailingTerm[i] = (t - values[i]) - y;
       values[i] = t;
+      isContributing[i] = true;
     }
   }
-  // reduce interpolated values within process group
-  MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numCoordinates),
-                abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>()),
-                MPI_SUM, theMPISystem()->getLocalComm());
-  //TODO is it necessary to correct for the kahan terms across process groups too?
-  // need to reduce across process groups too
-  // these do not strictly need to be allreduce (could be reduce), but it is easier to maintain that
-  // way (all processes end up with valid values)
-  MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numCoordinates),
-                abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>()),
-                MPI_SUM, theMPISystem()->getGlobalReduceComm());
+
+  // gather only the contributed values at the group's master, instead of reducing all values
+  contributingIndices.clear();
+  contributions.clear();
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    if (isContributing[i]) {
+      contributingIndices.push_back(i);
+      contributions.push_back(values[i]);
+    }
+  }
+  sumContributionsAtMaster(contributingIndices, contributions, values);
+  const auto valueType =
+      abstraction::getMPIDatatype(abstraction::getabstractionDataType<CombiDataType>());
+  MASTER_EXCLUSIVE_SECTION {
+    //TODO is it necessary to correct for the kahan terms across process groups too?
+    // need to reduce across process groups too (the global reduce comm of the masters contains
+    // only masters)
+    MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(numCoordinates), valueType,
+                  MPI_SUM, theMPISystem()->getGlobalReduceComm());
+  }
+  // all processes end up with valid values
+  MPI_Bcast(values.data(), static_cast<int>(numCoordinates), valueType,
+            theMPISystem()->getMasterRank(), theMPISystem()->getLocalComm());
 
   // hope for RVO or change
   return values;
@@ -1114,7 +1754,10 @@ void ProcessGroupWorker::writeInterpolatedValuesPerGrid(
   assert(combiParameters_.getNumGrids() == 1 && "interpolate only implemented for 1 species!");
   // call interpolation function on tasks and write out task-wise
   for (size_t i = 0; i < tasks_.size(); ++i) {
-    auto taskVals = tasks_[i]->getDistributedFullGrid().getInterpolatedValues(interpolationCoords);
+    auto taskVals = tasks_[i]->visitDistributedFullGrid([&](auto& dfg) {
+      auto values = dfg.getInterpolatedValues(interpolationCoords);
+      return std::vector<CombiDataType>(values.begin(), values.end());
+    });
     // cycle through ranks to write
     if (i % (theMPISystem()->getNumProcs()) == theMPISystem()->getLocalRank()) {
       std::string saveFilePath =
@@ -1264,34 +1907,83 @@ void ProcessGroupWorker::updateCombiParameters() {
 
 void ProcessGroupWorker::integrateCombinedSolution() {
   auto numGrids = static_cast<int>(combiParameters_.getNumGrids());
+  // in a partial combination, the fine subspaces keep the grids' own surpluses
+  std::vector<std::vector<bool>> subspacesToCombine(numGrids);
+  for (int g = 0; g < numGrids; g++) {
+    subspacesToCombine[g] = getSubspacesToCombine(g);
+  }
   for (Task* taskToUpdate : tasks_) {
     for (int g = 0; g < numGrids; g++) {
       // fill dfg with hierarchical coefficients from distributed sparse grid
-      taskToUpdate->getDistributedFullGrid(g).extractFromUniformSG(*combinedUniDSGVector_[g]);
+      STATS_SCOPED_EVENT("extract grid from sparse grid");
+      taskToUpdate->visitDistributedFullGrid(
+          [&](auto& dfg) {
+            dfg.extractFromUniformSG(*combinedUniDSGVector_[g], subspacesToCombine[g]);
+          },
+          g);
     }
   }
 
-  bool anyNotBoundary =
-      std::any_of(combiParameters_.getBoundary().begin(), combiParameters_.getBoundary().end(),
-                  [](BoundaryType b) { return b == 0; });
-
   Stats::startEvent("dehierarchize");
   for (Task* taskToUpdate : tasks_) {
     for (int g = 0; g < numGrids; g++) {
-      if (anyNotBoundary) {
-        LevelVector zeroLMin = LevelVector(combiParameters_.getDim(), 0);
-        DistributedHierarchization::dehierarchizeDFG(taskToUpdate->getDistributedFullGrid(g),
-                                                     combiParameters_.getHierarchizationDims(),
-                                                     combiParameters_.getHierarchicalBases(), zeroLMin);
-      } else {
-        DistributedHierarchization::dehierarchizeDFG(
-            taskToUpdate->getDistributedFullGrid(g), combiParameters_.getHierarchizationDims(),
-            combiParameters_.getHierarchicalBases(), combiParameters_.getLMin());
-      }
+      taskToUpdate->visitDistributedFullGrid([this](auto& dfg) { dehierarchizeFullGrid(dfg); },
+                                             g);
     }
   }
   Stats::stopEvent("dehierarchize");
   currentCombi_++;
+
+  if (combiParameters_.isBuddyCheckpointing()) {
+    buddyCheckpoint_.post(tasks_, numGrids, theMPISystem()->getGlobalReduceComm());
+  }
+}
+
+void ProcessGroupWorker::sendCheckpoint() {
+  // the task ID and the number of the group that restores it
+  std::array<size_t, 2> request;
+  MASTER_EXCLUSIVE_SECTION {
+    MPI_Recv(request.data(), 2,
+             abstraction::getMPIDatatype(abstraction::getabstractionDataType<size_t>()),
+             theMPISystem()->getManagerRank(), TRANSFER_CHECKPOINT_LAYOUT_TAG,
+             theMPISystem()->getGlobalComm(), MPI_STATUS_IGNORE);
+  }
+  MPI_Bcast(request.data(), 2,
+            abstraction::getMPIDatatype(abstraction::getabstractionDataType<size_t>()),
+            theMPISystem()->getMasterRank(), theMPISystem()->getLocalComm());
+
+  Stats::startEvent("checkpoint send");
+  buddyCheckpoint_.sendTo(request[0], static_cast<RankType>(request[1]),
+                          theMPISystem()->getGlobalReduceComm());
+  Stats::stopEvent("checkpoint send");
+}
+
+void ProcessGroupWorker::restoreFromCheckpoint() {
+  receiveAndInitializeTaskAndFaults();
+  currentTask_->setZero();
+
+  // the next group holds our checkpoints
+  const auto numGroups = static_cast<RankType>(theMPISystem()->getNumGroups());
+  const auto buddy = (theMPISystem()->getGlobalReduceRank() + 1) % numGroups;
+  Stats::startEvent("checkpoint restore");
+  int restored = BuddyCheckpoint::receiveInto(*currentTask_,
+                                              static_cast<int>(combiParameters_.getNumGrids()),
+                                              buddy, theMPISystem()->getGlobalReduceComm());
+  Stats::stopEvent("checkpoint restore");
+  MPI_Allreduce(MPI_IN_PLACE, &restored, 1, MPI_INT, MPI_LAND, theMPISystem()->getLocalComm());
+  MASTER_EXCLUSIVE_SECTION {
+    MPI_Send(&restored, 1, MPI_INT, theMPISystem()->getManagerRank(),
+             TRANSFER_CHECKPOINT_LAYOUT_TAG, theMPISystem()->getGlobalComm());
+  }
+
+  if (!restored && !isGENE) {
+    fillDFGFromDSGU(currentTask_);
+  }
+  // the checkpoint is from the last combination, the other groups have advanced since
+  Stats::Event e = Stats::Event();
+  currentTask_->run(theMPISystem()->getLocalComm());
+  e.end = std::chrono::high_resolution_clock::now();
+  processDuration(*currentTask_, e, theMPISystem()->getNumProcs());
 }
 
 void ProcessGroupWorker::combineThirdLevel() {
@@ -1316,6 +2008,21 @@ void ProcessGroupWorker::combineThirdLevel() {
            "sent in a single MPI Call (not "
            "supported yet) try a more coarse"
            "decomposition");
+    if (extraUniDSGVector_.size() > 0 && combiParameters_.isLeanSparseGrids()) {
+      // lean: exchange the subspaces of the extra dsg in place, from / to the uniDsg
+      const auto& partialSizes = dsgToUse->getSubspaceDataSizes();
+      Stats::startEvent("send dsg data");
+      sendDsgDataPartial(uniDsg, partialSizes, manager, managerComm);
+      Stats::stopEvent("send dsg data");
+
+      Stats::startEvent("recv dsg data");
+      recvDsgDataPartial(uniDsg, partialSizes, manager, managerComm);
+      Stats::stopEvent("recv dsg data");
+
+      auto request = asyncBcastDsgData(uniDsg, globalReduceRank, globalReduceComm);
+      requests.push_back(request);
+      continue;
+    }
     // if we have an extra dsg for third level exchange, we use it
     if (extraUniDSGVector_.size() > 0) {
       dsgToUse->copyDataFrom(*uniDsg);
@@ -1423,11 +2130,13 @@ void ProcessGroupWorker::setExtraSparseGrid(bool initializeSizes) {
     // create new vector for extra sparse grids (that will be only on this process group)
     extraUniDSGVector_.resize(combinedUniDSGVector_.size());
     for (auto& extraUniDSG : extraUniDSGVector_) {
-      extraUniDSG = std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>(
-          new DistributedSparseGridUniform<CombiDataType>(
+      extraUniDSG = std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>(
+          new DistributedSparseGridUniform<SparseGridDataType>(
               combinedUniDSGVector_[0]->getDim(), combinedUniDSGVector_[0]->getAllLevelVectors(),
               theMPISystem()->getOutputGroupComm()));
+      extraUniDSG->setMemoryCategory(MemoryCategory::thirdLevelSparseGrids);
       // create Kahan buffer now (at zero size), because summation is not needed on this sparse grid
+      extraUniDSG->setKahanSummation(!combiParameters_.isLeanSparseGrids());
       extraUniDSG->createKahanBuffer();
       if (initializeSizes) {
         for (size_t i = 0; i < extraUniDSG->getNumSubspaces(); ++i) {
@@ -1615,6 +2324,8 @@ void ProcessGroupWorker::waitForThirdLevelCombiResult(bool fromOutputGroup) {
 void ProcessGroupWorker::zeroDsgsData() {
   for (auto& dsg : combinedUniDSGVector_)
     dsg->setZero();
+  // lean extra dsgs only hold data while they are written / read
+  if (combiParameters_.isLeanSparseGrids()) return;
   for (auto& dsg : extraUniDSGVector_)
     dsg->setZero();
 }
@@ -1629,6 +2340,9 @@ void ProcessGroupWorker::deleteDsgsData() {
 
 void ProcessGroupWorker::writeVTKPlotFileOfTask(Task& task) {
 #ifdef USE_VTK
+  if (task.isSinglePrecision()) {
+    throw std::runtime_error("writeVTKPlotFileOfTask: not implemented for single precision tasks");
+  }
   IndexType numGrids = combiParameters_.getNumGrids();
   for (IndexType g = 0; g < numGrids; g++) {
     DistributedFullGrid<CombiDataType>& dfg = task.getDistributedFullGrid(static_cast<int>(g));
@@ -1651,9 +2365,11 @@ void ProcessGroupWorker::writeDSGsToDisk(std::string filenamePrefix) {
     auto dsgToUse = uniDsg;
     if (extraUniDSGVector_.size() > 0) {
       dsgToUse = extraUniDSGVector_[i].get();
+      if (combiParameters_.isLeanSparseGrids()) dsgToUse->createSubspaceData();
       dsgToUse->copyDataFrom(*uniDsg);
     }
     dsgToUse->writeOneFile(filename);
+    if (dsgToUse != uniDsg && combiParameters_.isLeanSparseGrids()) dsgToUse->deleteSubspaceData();
   }
 }
 
@@ -1663,12 +2379,14 @@ void ProcessGroupWorker::readDSGsFromDisk(std::string filenamePrefix, bool alway
     auto dsgToUse = uniDsg;
     if (extraUniDSGVector_.size() > 0 && !alwaysReadFullDSG) {
       dsgToUse = extraUniDSGVector_[i].get();
+      if (combiParameters_.isLeanSparseGrids()) dsgToUse->createSubspaceData();
     }
     dsgToUse->readOneFile(filenamePrefix + "_" + std::to_string(i));
     if (extraUniDSGVector_.size() > 0) {
       // copy partial data from extraDSG back to uniDSG
       uniDsg->copyDataFrom(*dsgToUse);
     }
+    if (dsgToUse != uniDsg && combiParameters_.isLeanSparseGrids()) dsgToUse->deleteSubspaceData();
   }
 }
 
@@ -1679,12 +2397,18 @@ void ProcessGroupWorker::readDSGsFromDiskAndReduce(std::string filenamePrefixToR
     auto dsgToUse = uniDsg;
     if (extraUniDSGVector_.size() > 0 && !alwaysReadFullDSG) {
       dsgToUse = extraUniDSGVector_[i].get();
+      if (combiParameters_.isLeanSparseGrids()) {
+        // the reduction adds to the current values
+        dsgToUse->createSubspaceData();
+        dsgToUse->copyDataFrom(*uniDsg);
+      }
     }
     dsgToUse->readOneFileAndReduce(filenamePrefixToRead + "_" + std::to_string(i));
     if (extraUniDSGVector_.size() > 0) {
       // copy partial data from extraDSG back to uniDSG
       uniDsg->copyDataFrom(*dsgToUse);
     }
+    if (dsgToUse != uniDsg && combiParameters_.isLeanSparseGrids()) dsgToUse->deleteSubspaceData();
   }
 }
 
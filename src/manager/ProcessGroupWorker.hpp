@@ -2,12 +2,15 @@
 #define PROCESSGROUPWORKER_HPP_
 
 #include <chrono>
+#include "combicom/CombiCom.hpp"
+#include "fault_tolerance/BuddyCheckpoint.hpp"
 #include "fullgrid/FullGrid.hpp"
 #include "manager/CombiParameters.hpp"
 #include "manager/ProcessGroupSignals.hpp"
 #include "mpi/MPISystem.hpp"
 #include "mpi_fault_simulator/MPI-FT.h"
 #include "task/Task.hpp"
+#include "utils/LpNormAccumulator.hpp"
 #include "loadmodel/LearningLoadModel.hpp"
 #include "vtk/DFGPlotFileWriter.hpp"
 
@@ -63,6 +66,21 @@ class ProcessGroupWorker {
   /** combine on sparse grid with uniform decomposition of domain */
   void combineUniform();
 
+  /**
+   * @brief runAllTasks and combineUniform as a pipeline instead of phases
+   *
+   * Each task is hierarchized and added to the sparse grids as soon as its run finishes. A chunk
+   * of the (non-blocking) global reduce is started as soon as the last task contributing to it
+   * is added, so fast groups start reducing while slow ones still compute. Each task's grids are
+   * extracted and dehierarchized as soon as the chunks they need are reduced, while the other
+   * chunks are still in flight. The chunks are started from the end of the sparse grid data
+   * (the finest subspaces, which have the fewest contributors) in the same order on all groups.
+   * Throws if a partial combination is set (cf. CombiParameters::setPartialCombination).
+   *
+   * @param chunkSize the number of sparse grid elements per reduce chunk, the same on all groups
+   */
+  void runAndCombinePipelined(size_t chunkSize = CombiCom::globalReduceChunkSize);
+
   void combineLocalAndGlobal();
 
   void deleteTasks();
@@ -79,7 +97,7 @@ class ProcessGroupWorker {
   /** calculate the Lp Norm for each individual task */
   std::vector<double> getLpNorms(int p) const;
 
-  /** evaluate norms on (newly created) reference grid */
+  /** evaluate norms on reference grid (directly on the sparse grid, if useSparseGridEvaluation) */
   std::vector<double> parallelEvalNorm(LevelVector leval) const;
 
   /** evaluate norms of Task's analytical solution on reference grid */
@@ -88,6 +106,43 @@ class ProcessGroupWorker {
   /** evaluate norms of combi solution error on reference grid  */
   std::vector<double> evalErrorOnDFG(LevelVector leval) const;
 
+  /**
+   * @brief evaluate the requested norms (cf. NormBundleType) in a single pass per grid and with a
+   * single reduction
+   *
+   * @return maximum, 1 and 2 norm of each task's grid (if requested), then of the combined
+   * solution, the analytical solution and the error on the reference grid of level leval (if
+   * requested), in this order
+   */
+  std::vector<double> evalNormBundle(const LevelVector& leval, NormBundleType bundle) const;
+
+  /** whether the combined solution can be evaluated directly on the sparse grid (requires a
+   * decomposition in the combi parameters, hat basis functions, and that the last combination
+   * was not partial) */
+  bool canEvalOnSparseGrid() const;
+
+  /** whether the last combination was partial (cf. CombiParameters::setPartialCombination), so
+   * the sparse grid does not hold the combined solution and cannot be evaluated or extracted */
+  bool isSparseGridPartiallyCombined() const;
+
+  /**
+   * whether the output and norms on a uniform grid are evaluated on the sparse grid instead of a
+   * full grid filled with fillDFGFromDSGU: only if requested by an eval memory budget (cf.
+   * CombiParameters::setEvalMemoryBudget) and possible. Every process evaluates its surpluses
+   * at all points then, which saves the full grid's memory but does not scale with the number
+   * of processes like the full grid does.
+   */
+  bool useSparseGridEvaluation() const;
+
+  /** the part of the sparse grid's points that this process holds */
+  SparseGridPartition getSparseGridPartition() const;
+
+  /** evaluate the combined solution at the coordinates directly from the hierarchical surpluses
+   * in the sparse grid, without a full grid; collective in the process group, every process
+   * gets all values */
+  std::vector<SparseGridDataType> evalOnSparseGrid(
+      const std::vector<std::vector<real>>& interpolationCoords, IndexType g = 0) const;
+
   /** interpolate values on all tasks' component grids */
   std::vector<CombiDataType> interpolateValues(
       const std::vector<std::vector<real>>& interpolationCoordinates) const;
@@ -159,11 +214,11 @@ class ProcessGroupWorker {
   /** receives reduced sizes from tl pgroup and updates the dsgs */
   void waitForThirdLevelSizeUpdate();
 
-  std::vector<std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>> & getCombinedUniDSGVector(){
+  std::vector<std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>> & getCombinedUniDSGVector(){
     return combinedUniDSGVector_;
   }
 
-  std::vector<std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>> & getExtraUniDSGVector(){
+  std::vector<std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>> & getExtraUniDSGVector(){
     return extraUniDSGVector_;
   }
 
@@ -204,12 +259,12 @@ class ProcessGroupWorker {
   /**
    * Vector containing all distributed sparse grids
    */
-  std::vector<std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>> combinedUniDSGVector_;
+  std::vector<std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>> combinedUniDSGVector_;
 
   /**
    * Vector containing the third level extra distributed sparse grids
    */
-  std::vector<std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>> extraUniDSGVector_;
+  std::vector<std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>> extraUniDSGVector_;
 
   CombiParameters combiParameters_;
 
@@ -223,10 +278,22 @@ class ProcessGroupWorker {
   std::chrono::high_resolution_clock::time_point
       startTimeIteration_;  /// starting time of process computation
 
+  BuddyCheckpoint buddyCheckpoint_;  /// checkpoints of this and the previous group's grids
+
   // std::ofstream betasFile_;
 
   void receiveAndInitializeTaskAndFaults(bool mayAlreadyExist = true);
 
+  /** send the checkpoint of the task requested by the manager to its replacement group */
+  void sendCheckpoint();
+
+  /**
+   * @brief receive a task and restore its state from the buddy group's checkpoint, then catch
+   * up with the other groups by running it; the manager is told whether there was a checkpoint
+   * (otherwise, the task is recomputed from the combined solution)
+   */
+  void restoreFromCheckpoint();
+
   /** deallocates all data elements stored in the dsgs */
   void deleteDsgsData();
 
@@ -238,19 +305,57 @@ class ProcessGroupWorker {
 
   void processDuration(const Task& t, const Stats::Event e, unsigned int numProcs);
 
+  /** (de)hierarchize one full grid with the bases and lmin of the combi parameters */
+  template <typename FG_ELEMENT>
+  void hierarchizeFullGrid(DistributedFullGrid<FG_ELEMENT>& dfg) const;
+
+  template <typename FG_ELEMENT>
+  void dehierarchizeFullGrid(DistributedFullGrid<FG_ELEMENT>& dfg) const;
+
+  /**
+   * @brief the subspaces of the sparse grid g to combine in the current combination, which are
+   * only the coarse ones in a partial combination (cf. CombiParameters::setPartialCombination);
+   * empty means all
+   */
+  std::vector<bool> getSubspacesToCombine(IndexType g) const;
+
   /** helper functions for parallelEval and norm calculations*/
   LevelVector receiveLevalAndBroadcast();
 
   /**
-   * @brief copy the sparse grid data into the full grid and dehierarchize
+   * @brief copy the sparse grid data into the full grid and dehierarchize; throws if the
+   * sparse grid is only partially combined (cf. isSparseGridPartiallyCombined)
    *
    * @param dfg the distributed full grid to fill
    * @param g the dimension index (in the case that there are multiple different full grids per
    * task)
    */
-  void fillDFGFromDSGU(DistributedFullGrid<CombiDataType>& dfg, IndexType g = 0) const;
+  template <typename FG_ELEMENT>
+  void fillDFGFromDSGU(DistributedFullGrid<FG_ELEMENT>& dfg, IndexType g = 0) const;
 
   void fillDFGFromDSGU(Task* t) const;
+
+  /**
+   * @brief add the values of the combined solution, the first task's analytical solution and/or
+   * their difference on the points of a reference grid of level leval to the accumulators (if
+   * not nullptr), in a single pass over the points
+   *
+   * If useSparseGridEvaluation(), the combined solution is evaluated directly on the sparse grid,
+   * without creating the reference grid; the analytical solution alone needs no grid at all.
+   */
+  void accumulateNormsOnUniformGrid(const LevelVector& leval, LpNormAccumulator* combined,
+                                    LpNormAccumulator* analytical, LpNormAccumulator* error) const;
+
+  /**
+   * @brief write the combined solution on a uniform grid of level leval to file (in the formats
+   * of DistributedFullGrid::writePlotFile(VTK)), evaluated directly on the sparse grid
+   *
+   * The output grid is never held as a whole: it is evaluated in slabs along the last
+   * dimension, sized by the eval memory budget in the CombiParameters, and each slab is written
+   * with non-blocking MPI-IO while the next one is evaluated.
+   */
+  void writeUniformFromSparseGrid(const std::string& filename, const LevelVector& leval,
+                                  IndexType g, bool writeVTK) const;
 };
 
 inline Task* ProcessGroupWorker::getCurrentTask() {
@@ -91,16 +91,7 @@ bool ProcessManager::runnext() {
 void ProcessManager::exit() {
   // wait until all process groups are in wait state
   // after sending the exit signal checking the status might not be possible
-  size_t numWaiting = 0;
-
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
-
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT)
-        ++numWaiting;
-    }
-  }
+  waitForAllGroupsToWait();
 
   // send exit signal to each group
   for (size_t i = 0; i < pgroups_.size(); ++i) {
@@ -111,17 +102,7 @@ void ProcessManager::exit() {
 
 void ProcessManager::initDsgus() {
   Stats::startEvent("manager init dsgus");
-  // wait until all process groups are in wait state
-  // after sending the exit signal checking the status might not be possible
-  size_t numWaiting = 0;
-
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
-
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
-    }
-  }
+  waitForAllGroupsToWait();
 
   // tell groups to init Dsgus
   for (size_t i = 0; i < pgroups_.size(); ++i) {
@@ -186,15 +167,7 @@ void ProcessManager::redistribute(std::vector<size_t>& taskID) {
     g->addTask(t);
   }
 
-  size_t numWaiting = 0;
-
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
-
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
-    }
-  }
+  waitForAllGroupsToWait();
 
   std::cout << "Redistribute finished" << std::endl;
 }
@@ -227,14 +200,7 @@ void ProcessManager::reInitializeGroup(std::vector<ProcessGroupManagerID>& recov
     removeTasks.clear();
   }
 
-  size_t numWaiting = 0;
-
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
-    }
-  }
+  waitForAllGroupsToWait();
 
   std::cout << "Reinitialization finished" << std::endl;
 }
@@ -266,17 +232,43 @@ void ProcessManager::recompute(std::vector<size_t>& taskID, bool failedRecovery,
     }
   }
 
-  size_t numWaiting = 0;
+  waitForAllGroupsToWait();
 
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
+  std::cout << "Recompute finished" << std::endl;
+}
 
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
+std::vector<size_t> ProcessManager::restoreFromCheckpoints(
+    std::vector<ProcessGroupManagerID>& recoveredGroups) {
+  assert(params_.isBuddyCheckpointing());
+  const auto numGroups = static_cast<RankType>(theMPISystem()->getNumGroups());
+  std::vector<size_t> notRestored;
+  for (auto g : recoveredGroups) {
+    // group g keeps its checkpoints in group g+1
+    const RankType buddyRank = (g->getMasterRank() + 1) % numGroups;
+    auto buddy = std::find_if(pgroups_.begin(), pgroups_.end(), [buddyRank](const auto& pg) {
+      return pg->getMasterRank() == buddyRank;
+    });
+    const bool buddyAvailable =
+        buddy != pgroups_.end() && *buddy != g &&
+        std::find(recoveredGroups.begin(), recoveredGroups.end(), *buddy) == recoveredGroups.end();
+
+    if (!buddyAvailable) {
+      // the checkpoints were lost with the buddy
+      for (Task* t : g->getTaskContainer()) notRestored.push_back(t->getID());
+      continue;
+    }
+
+    g->resetTasksWorker();
+    for (Task* t : g->getTaskContainer()) {
+      waitForPG(g);
+      waitForPG(*buddy);
+      (*buddy)->sendCheckpoint(t->getID(), g->getMasterRank());
+      if (!g->restoreFromCheckpoint(t)) notRestored.push_back(t->getID());
     }
   }
 
-  std::cout << "Recompute finished" << std::endl;
+  waitForAllGroupsToWait();
+  return notRestored;
 }
 
 bool ProcessManager::recoverCommunicators(std::vector<ProcessGroupManagerID> failedGroups) {
@@ -326,9 +318,8 @@ void ProcessManager::recover(int i, int nsteps) {  // outdated
   getGroupFaultIDs(faultsID, groupFaults);
 
   /* call optimization code to find new coefficients */
-  const std::string prob_name = "interpolation based optimization";
   std::vector<size_t> redistributeFaultsID, recomputeFaultsID;
-  recomputeOptimumCoefficients(prob_name, faultsID, redistributeFaultsID, recomputeFaultsID);
+  recomputeOptimumCoefficients(faultsID, redistributeFaultsID, recomputeFaultsID);
   // time does not need to be updated in gene but maybe in other applications
   /*  for ( auto id : redistributeFaultsID ) {
       GeneTask* tmp = static_cast<GeneTask*>(getTask(id));
@@ -396,16 +387,43 @@ bool ProcessManager::waitForPG(ProcessGroupManagerID pg) {
 }
 
 void ProcessManager::waitForAllGroupsToWait() const {
-// wait until all process groups are in wait state
-  size_t numWaiting = 0;
+  // wait until no process group is busy anymore
+  while (waitForStatusUpdates([](const ProcessGroupManagerID&) { return true; },
+                              [](const ProcessGroupManagerID&) {}) > 0) {
+  }
+}
 
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
+size_t ProcessManager::waitForStatusUpdates(
+    const std::function<bool(const ProcessGroupManagerID&)>& isSelected,
+    const std::function<void(const ProcessGroupManagerID&)>& onStatus) const {
+  std::vector<ProcessGroupManagerID> busyGroups;
+  for (const auto& g : pgroups_) {
+    if (isSelected(g) && g->isBusy()) busyGroups.push_back(g);
+  }
+  if (busyGroups.empty()) return 0;
 
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
-    }
+  if (ENABLE_FT) {
+    // the simulated FT requests cannot be completed together, wait for the first busy group
+    busyGroups[0]->waitStatus();
+    onStatus(busyGroups[0]);
+    return 1;
   }
+
+  std::vector<MPI_Request> requests;
+  requests.reserve(busyGroups.size());
+  for (const auto& g : busyGroups) requests.push_back(g->getStatusRequest());
+  std::vector<int> completedIndices(requests.size());
+  int numCompleted = 0;
+  MPI_Waitsome(static_cast<int>(requests.size()), requests.data(), &numCompleted,
+               completedIndices.data(), MPI_STATUSES_IGNORE);
+  assert(numCompleted != MPI_UNDEFINED && numCompleted > 0);
+  for (int i = 0; i < numCompleted; ++i) {
+    const auto& g = busyGroups[completedIndices[i]];
+    // the status has been received into the group, invalidate its copy of the request
+    g->getStatusRequest() = MPI_REQUEST_NULL;
+    onStatus(g);
+  }
+  return static_cast<size_t>(numCompleted);
 }
 
 void ProcessManager::parallelEval(const LevelVector& leval, std::string& filename, size_t groupID) {
@@ -465,6 +483,15 @@ double ProcessManager::getLpNorm(int p) {
   return norm;
 }
 
+std::vector<MemoryReport> ProcessManager::getMemoryReports() {
+  std::vector<MemoryReport> reports;
+  reports.reserve(pgroups_.size());
+  for (const auto& pg : pgroups_) {
+    reports.push_back(pg->getMemoryReport());
+  }
+  return reports;
+}
+
 std::vector<double> ProcessManager::parallelEvalNorm(const LevelVector& leval, size_t groupID) {
   auto g = pgroups_[groupID];
   return g->parallelEvalNorm(leval);
@@ -480,6 +507,23 @@ std::vector<double> ProcessManager::evalErrorOnDFG(const LevelVector& leval, siz
   return g->evalErrorOnDFG(leval);
 }
 
+NormBundle ProcessManager::evalNormBundle(const LevelVector& leval, NormBundleType bundle,
+                                          size_t groupID) {
+  NormBundle norms;
+  for (size_t i = 0; i < pgroups_.size(); ++i) {
+    auto groupBundle = (i == groupID) ? bundle : (bundle & TASK_NORMS);
+    if (groupBundle == 0) continue;
+    auto groupNorms = pgroups_[i]->evalNormBundle(leval, groupBundle);
+    norms.taskNorms.insert(groupNorms.taskNorms.begin(), groupNorms.taskNorms.end());
+    if (i == groupID) {
+      norms.combined = groupNorms.combined;
+      norms.analytical = groupNorms.analytical;
+      norms.error = groupNorms.error;
+    }
+  }
+  return norms;
+}
+
 void ProcessManager::setupThirdLevel() {
   Stats::startEvent("manager connect third level");
   std::string hostnameInfo = "manager = " + boost::asio::ip::host_name();
@@ -1,11 +1,12 @@
 #ifndef PROCESSMANAGER_HPP_
 #define PROCESSMANAGER_HPP_
 
+#include <functional>
 #include <vector>
 #include <numeric>
 
 #include "combischeme/CombiMinMaxScheme.hpp"
-#include "fault_tolerance/LPOptimizationInterpolation.hpp"
+#include "fault_tolerance/FaultTolerantCoefficients.hpp"
 #include "manager/ProcessGroupManager.hpp"
 #include "manager/ProcessGroupSignals.hpp"
 #include "loadmodel/LoadModel.hpp"
@@ -111,7 +112,7 @@ class ProcessManager {
   /* Generates no_faults random faults from the combischeme */
   inline void createRandomFaults(std::vector<size_t>& faultIds, int no_faults);
 
-  inline void recomputeOptimumCoefficients(std::string prob_name, std::vector<size_t>& faultsID,
+  inline void recomputeOptimumCoefficients(std::vector<size_t>& faultsID,
                                            std::vector<size_t>& redistributefaultsID,
                                            std::vector<size_t>& recomputeFaultsID);
 
@@ -141,6 +142,16 @@ class ProcessManager {
 
   std::vector<double> evalErrorOnDFG(const LevelVector& leval, size_t groupID = 0);
 
+  // the requested norms (cf. NormBundleType) with one signal per process group; the task norms
+  // are collected from all groups, the norms on leval are evaluated by group groupID
+  NormBundle evalNormBundle(const LevelVector& leval,
+                            NormBundleType bundle = TASK_NORMS | COMBINED_NORMS |
+                                                    ANALYTICAL_NORMS | ERROR_NORMS,
+                            size_t groupID = 0);
+
+  // memory report of every process group, indexed like the groups
+  std::vector<MemoryReport> getMemoryReports();
+
   std::vector<CombiDataType> interpolateValues(
       const std::vector<std::vector<real>>& interpolationCoords);
 
@@ -163,6 +174,19 @@ class ProcessManager {
   void recompute(std::vector<size_t>& taskID, bool failedRecovery,
                  std::vector<ProcessGroupManagerID>& recoveredGroups);
 
+  /**
+   * @brief restore the tasks of the recovered groups from the in-memory checkpoints in their
+   * buddy groups (requires CombiParameters::setBuddyCheckpointing), as an alternative to
+   * reInitializeGroup and recompute that keeps the combination coefficients
+   *
+   * The restored tasks are run once to catch up with the other groups; tasks that are
+   * missing from the checkpoint are recomputed from the combined solution instead. Groups
+   * whose buddy group was recovered as well are left untouched, as their checkpoints are lost;
+   * they have to be handled by reInitializeGroup or recompute.
+   * @return the IDs of the tasks that could not be restored from a checkpoint
+   */
+  std::vector<size_t> restoreFromCheckpoints(std::vector<ProcessGroupManagerID>& recoveredGroups);
+
   void recover(int i, int nsteps);
 
   bool recoverCommunicators(std::vector<ProcessGroupManagerID> failedGroups);
@@ -207,10 +231,21 @@ class ProcessManager {
 
   ProcessGroupManagerID& thirdLevelPGroup_;
 
-  // periodically checks status of all process groups. returns until at least
-  // one group is in WAIT state
+  // blocks until at least one group is in WAIT state and returns it
   inline ProcessGroupManagerID wait();
   inline ProcessGroupManagerID waitAvoid(std::vector<ProcessGroupManagerID>& avoidGroups);
+
+  /**
+   * @brief blocks (in MPI_Waitsome, without polling) until at least one of the busy process
+   * groups for which isSelected is true has sent its status, then calls onStatus for every
+   * group whose status has arrived
+   *
+   * @return the number of groups whose status has arrived, 0 if none of the selected groups
+   * is busy
+   */
+  size_t waitForStatusUpdates(
+      const std::function<bool(const ProcessGroupManagerID&)>& isSelected,
+      const std::function<void(const ProcessGroupManagerID&)>& onStatus) const;
   bool waitAllFinished();
   bool waitForPG(ProcessGroupManagerID pg);
 
@@ -236,35 +271,30 @@ inline void ProcessManager::addTask(Task* t) {
 }
 
 inline ProcessGroupManagerID ProcessManager::wait() {
-  while (true) {
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      StatusType status = pgroups_[i]->getStatus();
-      //      std::cout << status << " is the status of : "<< i << "\n";
-      assert(status >= 0);  // check for invalid values
-      assert(status <= 2);
-      if (status == PROCESS_GROUP_WAIT) {
-        return pgroups_[i];
-      }
-    }
-  }
+  std::vector<ProcessGroupManagerID> avoidNoGroups;
+  return waitAvoid(avoidNoGroups);
 }
 
 inline ProcessGroupManagerID ProcessManager::waitAvoid(
     std::vector<ProcessGroupManagerID>& avoidGroups) {
-  while (true) {
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (std::find(avoidGroups.begin(), avoidGroups.end(), pgroups_[i]) ==
-          avoidGroups.end()) {  // ignore tasks that are recomputed
-        StatusType status = pgroups_[i]->getStatus();
-        //      std::cout << status << " is the status of : "<< i << "\n";
-        assert(status >= 0);  // check for invalid values
-        assert(status <= 2);
-        if (status == PROCESS_GROUP_WAIT) {
-          return pgroups_[i];
-        }
-      }
+  auto isSelected = [&avoidGroups](const ProcessGroupManagerID& g) {
+    return std::find(avoidGroups.begin(), avoidGroups.end(), g) == avoidGroups.end();
+  };
+  for (const auto& g : pgroups_) {
+    if (isSelected(g) && g->getStatus() == PROCESS_GROUP_WAIT) return g;
+  }
+  // sleep until the first of the busy groups reports back
+  ProcessGroupManagerID waitingGroup = nullptr;
+  auto setIfWaiting = [&waitingGroup](const ProcessGroupManagerID& g) {
+    if (waitingGroup == nullptr && g->getStatus() == PROCESS_GROUP_WAIT) waitingGroup = g;
+  };
+  while (waitingGroup == nullptr) {
+    auto numUpdated = waitForStatusUpdates(isSelected, setIfWaiting);
+    if (numUpdated == 0 && waitingGroup == nullptr) {
+      throw std::runtime_error("ProcessManager: no process group can become available");
     }
   }
+  return waitingGroup;
 }
 
 template <typename FG_ELEMENT>
@@ -299,17 +329,7 @@ void ProcessManager::combine() {
 
 void ProcessManager::combineLocalAndGlobal() {
   Stats::startEvent("manager combine local");
-  // wait until all process groups are in wait state
-  // after sending the exit signal checking the status might not be possible
-  size_t numWaiting = 0;
-
-  while (numWaiting != pgroups_.size()) {
-    numWaiting = 0;
-
-    for (size_t i = 0; i < pgroups_.size(); ++i) {
-      if (pgroups_[i]->getStatus() == PROCESS_GROUP_WAIT) ++numWaiting;
-    }
-  }
+  waitForAllGroupsToWait();
 
   // tell groups to combine local and global
   for (size_t i = 0; i < pgroups_.size(); ++i) {
@@ -459,7 +479,7 @@ size_t ProcessManager::pretendCombineThirdLevelForBroker(
 
   Stats::startEvent("manager exchange data with remote");
   for (const auto& dsguSize : numDofsToCommunicate) {
-    std::vector<CombiDataType> dsguData(dsguSize, 0.);
+    std::vector<SparseGridDataType> dsguData(dsguSize, 0.);
     // combine
     if (instruction == "send_first") {
       // if sending first, initialize with random
@@ -644,10 +664,9 @@ inline void ProcessManager::createRandomFaults(std::vector<size_t>& faultIds, in
 
 /**
  * Recompute coefficients for the combination technique based on given grid faults using
- * an optimization scheme
+ * an optimization scheme (cf. FaultTolerantCoefficients)
  */
-inline void ProcessManager::recomputeOptimumCoefficients(std::string prob_name,
-                                                         std::vector<size_t>& faultsID,
+inline void ProcessManager::recomputeOptimumCoefficients(std::vector<size_t>& faultsID,
                                                          std::vector<size_t>& redistributeFaultsID,
                                                          std::vector<size_t>& recomputeFaultsID) {
   CombigridDict given_dict = params_.getCombiDict();
@@ -656,18 +675,11 @@ inline void ProcessManager::recomputeOptimumCoefficients(std::string prob_name,
   LevelVectorList faultLevelVectors;
   for (auto id : faultsID) faultLevelVectors.push_back(IDsToLevels[id]);
 
-  LevelVectorList lvlminmax;
-  lvlminmax.push_back(params_.getLMin());
-  lvlminmax.push_back(params_.getLMax());
-  LP_OPT_INTERP opt_interp(lvlminmax, static_cast<int>(params_.getDim()), GLP_MAX, given_dict,
-                           faultLevelVectors);
-  if (opt_interp.getNumFaults() != 0) {
-    opt_interp.init_opti_prob(prob_name);
-    opt_interp.set_constr_matrix();
-    opt_interp.solve_opti_problem();
-
-    LevelVectorList recomputeLevelVectors;
-    CombigridDict new_dict = opt_interp.get_results(recomputeLevelVectors);
+  // the downset is reconstructed from the current coefficients, so faults handled in previous
+  // recoveries stay compensated for
+  FaultTolerantCoefficients ftCoefficients(given_dict, params_.getLMin());
+  if (ftCoefficients.addFaults(faultLevelVectors)) {
+    CombigridDict new_dict = ftCoefficients.getCombiDict();
 
     LevelVectorList newLevels;
     std::vector<real> newCoeffs;
@@ -694,19 +706,19 @@ inline void ProcessManager::recomputeOptimumCoefficients(std::string prob_name,
 
     assert(roundedSum == 1);
     params_.setLevelsCoeffs(newTaskIDs, newLevels, newCoeffs);
+  }
 
-    std::map<LevelVector, size_t> LevelsToIDs = params_.getLevelsToIDs();
-    for (auto l : recomputeLevelVectors) {
-      recomputeFaultsID.push_back(LevelsToIDs[l]);
-    }
+  std::map<LevelVector, size_t> LevelsToIDs = params_.getLevelsToIDs();
+  for (const auto& l : ftCoefficients.getLevelsToRecompute()) {
+    recomputeFaultsID.push_back(LevelsToIDs[l]);
+  }
 
-    std::sort(faultsID.begin(), faultsID.end());
-    std::sort(recomputeFaultsID.begin(), recomputeFaultsID.end());
+  std::sort(faultsID.begin(), faultsID.end());
+  std::sort(recomputeFaultsID.begin(), recomputeFaultsID.end());
 
-    std::set_difference(faultsID.begin(), faultsID.end(), recomputeFaultsID.begin(),
-                        recomputeFaultsID.end(),
-                        std::inserter(redistributeFaultsID, redistributeFaultsID.begin()));
-  }
+  std::set_difference(faultsID.begin(), faultsID.end(), recomputeFaultsID.begin(),
+                      recomputeFaultsID.end(),
+                      std::inserter(redistributeFaultsID, redistributeFaultsID.begin()));
 }
 
 inline Task* ProcessManager::getTask(size_t taskID) {
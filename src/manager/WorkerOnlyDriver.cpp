@@ -0,0 +1,178 @@
+#include "manager/WorkerOnlyDriver.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+#include "mpi/MPISystem.hpp"
+#include "utils/Stats.hpp"
+
+namespace combigrid {
+
+TaskAssignment getTaskAssignment(const std::vector<LevelVector>& levels,
+                                 const std::vector<real>& coeffs, size_t processGroupNumber,
+                                 size_t numberOfGroups,
+                                 const std::vector<size_t>& processGroupNumbers,
+                                 LoadModel* loadModel) {
+  assert(levels.size() == coeffs.size());
+  assert(processGroupNumber < numberOfGroups);
+  std::vector<size_t> groupOfTask(levels.size());
+  if (!processGroupNumbers.empty()) {
+    if (processGroupNumbers.size() != levels.size()) {
+      throw std::runtime_error("getTaskAssignment: need one process group number per task");
+    }
+    groupOfTask = processGroupNumbers;
+  } else if (loadModel != nullptr) {
+    std::vector<real> loads(levels.size());
+    for (size_t i = 0; i < levels.size(); ++i) {
+      loads[i] = loadModel->eval(levels[i]);
+    }
+    // sort by decreasing load; the stable sort makes the order the same on every rank
+    std::vector<size_t> order(levels.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(),
+                     [&loads](size_t a, size_t b) { return loads[a] > loads[b]; });
+    std::vector<real> groupLoads(numberOfGroups, 0.);
+    for (const auto& i : order) {
+      auto leastLoaded = std::distance(groupLoads.begin(),
+                                       std::min_element(groupLoads.begin(), groupLoads.end()));
+      groupOfTask[i] = static_cast<size_t>(leastLoaded);
+      groupLoads[leastLoaded] += loads[i];
+    }
+  } else {
+    for (size_t i = 0; i < levels.size(); ++i) {
+      groupOfTask[i] = i % numberOfGroups;
+    }
+  }
+
+  TaskAssignment assignment;
+  for (size_t i = 0; i < levels.size(); ++i) {
+    if (groupOfTask[i] == processGroupNumber) {
+      assignment.levels.push_back(levels[i]);
+      assignment.coeffs.push_back(coeffs[i]);
+      assignment.taskNumbers.push_back(i);
+    }
+  }
+  return assignment;
+}
+
+WorkerOnlyDriver::WorkerOnlyDriver(const CombiParameters& params) {
+  if (theMPISystem()->isWorldManager()) {
+    throw std::runtime_error("WorkerOnlyDriver: MPISystem has to be initialized without manager");
+  }
+  worker_.setCombiParameters(params);
+}
+
+void WorkerOnlyDriver::setFileBasedCombination(unsigned int systemNumber,
+                                               unsigned int numberOfSystems,
+                                               const std::string& filePrefix) {
+  if (numberOfSystems > 2 || systemNumber >= numberOfSystems) {
+    throw std::runtime_error("WorkerOnlyDriver: file-based combination supports up to two systems");
+  }
+  fileBasedCombination_ = true;
+  systemNumber_ = systemNumber;
+  numberOfSystems_ = numberOfSystems;
+  combinationFilePrefix_ = filePrefix;
+}
+
+void WorkerOnlyDriver::setPipelinedCombination(bool pipelined, size_t chunkSize) {
+  if (pipelined && worker_.getCombiParameters().getPartialCombinationInterval() > 1) {
+    throw std::runtime_error(
+        "WorkerOnlyDriver: pipelined combination cannot be used with partial combination");
+  }
+  if (pipelined && chunkSize == 0) {
+    throw std::runtime_error("WorkerOnlyDriver: pipelined combination needs a positive chunk size");
+  }
+  pipelinedCombination_ = pipelined;
+  pipelinedChunkSize_ = chunkSize;
+}
+
+void WorkerOnlyDriver::setStatsOutput(const std::string& filePrefix) {
+  statsFilePrefix_ = filePrefix;
+}
+
+void WorkerOnlyDriver::setInterpolation(const std::vector<std::vector<real>>& interpolationCoords,
+                                        const std::string& filenamePrefix) {
+  interpolationCoords_ = interpolationCoords;
+  interpolationFilePrefix_ = filenamePrefix;
+}
+
+void WorkerOnlyDriver::runStep() {
+  worker_.runAllTasks();
+  if (!interpolationCoords_.empty()) {
+    Stats::startEvent("worker-only interpolate");
+    worker_.writeInterpolatedValuesSingleFile(interpolationCoords_, interpolationFilePrefix_);
+    Stats::stopEvent("worker-only interpolate");
+  }
+  if (afterRunHook_) afterRunHook_(*this, numberOfRunSteps_);
+  ++numberOfRunSteps_;
+}
+
+void WorkerOnlyDriver::combineStep() {
+  auto combinationNumber = static_cast<size_t>(worker_.getCurrentNumberOfCombinations());
+  Stats::startEvent("worker-only combine");
+  if (!fileBasedCombination_) {
+    worker_.combineUniform();
+  } else {
+    std::string stepSuffix = "_step" + std::to_string(combinationNumber);
+    std::string writeSparseGridFile =
+        combinationFilePrefix_ + "_" + std::to_string(systemNumber_) + stepSuffix;
+    std::string writeSparseGridFileToken = writeSparseGridFile + "_token.txt";
+    worker_.combineLocalAndGlobal();
+    OUTPUT_GROUP_EXCLUSIVE_SECTION {
+      worker_.combineThirdLevelFileBasedWrite(writeSparseGridFile, writeSparseGridFileToken);
+      if (numberOfSystems_ > 1) {
+        std::string readSparseGridFile = combinationFilePrefix_ + "_" +
+                                         std::to_string((systemNumber_ + 1) % numberOfSystems_) +
+                                         stepSuffix;
+        worker_.combineThirdLevelFileBasedReadReduce(readSparseGridFile,
+                                                     readSparseGridFile + "_token.txt");
+      } else {
+        worker_.combineThirdLevelFileBasedReadReduce(writeSparseGridFile, writeSparseGridFileToken,
+                                                     true);
+      }
+    }
+    else {
+      worker_.waitForThirdLevelCombiResult(true);
+    }
+  }
+  Stats::stopEvent("worker-only combine");
+  finishCombineStep(combinationNumber);
+}
+
+void WorkerOnlyDriver::runAndCombineStep() {
+  if (fileBasedCombination_ || !interpolationCoords_.empty() || afterRunHook_) {
+    throw std::runtime_error(
+        "WorkerOnlyDriver: pipelined combination only without file-based combination, "
+        "interpolation and after-run hook");
+  }
+  auto combinationNumber = static_cast<size_t>(worker_.getCurrentNumberOfCombinations());
+  Stats::startEvent("worker-only run and combine");
+  worker_.runAndCombinePipelined(pipelinedChunkSize_);
+  Stats::stopEvent("worker-only run and combine");
+  ++numberOfRunSteps_;
+  finishCombineStep(combinationNumber);
+}
+
+void WorkerOnlyDriver::finishCombineStep(size_t combinationNumber) {
+  if (!statsFilePrefix_.empty()) {
+    Stats::writePartial(statsFilePrefix_ + "_group" +
+                            std::to_string(theMPISystem()->getProcessGroupNumber()) + ".json",
+                        theMPISystem()->getLocalComm());
+  }
+  if (afterCombineHook_) afterCombineHook_(*this, combinationNumber);
+}
+
+void WorkerOnlyDriver::run(size_t numberOfCombinations) {
+  for (size_t i = 0; i < numberOfCombinations; ++i) {
+    if (pipelinedCombination_) {
+      runAndCombineStep();
+    } else {
+      runStep();
+      combineStep();
+    }
+  }
+}
+
+void WorkerOnlyDriver::exit() { worker_.exit(); }
+
+}  // namespace combigrid
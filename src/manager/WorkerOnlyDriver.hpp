@@ -0,0 +1,169 @@
+#ifndef WORKERONLYDRIVER_HPP_
+#define WORKERONLYDRIVER_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "loadmodel/LoadModel.hpp"
+#include "manager/CombiParameters.hpp"
+#include "manager/ProcessGroupWorker.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief the component grids of a combination scheme that one process group computes
+ */
+struct TaskAssignment {
+  std::vector<LevelVector> levels;
+  std::vector<real> coeffs;
+  std::vector<size_t> taskNumbers;  // position of the task in the whole scheme
+};
+
+/**
+ * @brief assign the component grids of a combination scheme to process groups, without a manager
+ *
+ * Every rank computes the same assignment and keeps only the part of its own group.
+ * If processGroupNumbers is given (e.g. from a scheme file, cf. CombiMinMaxSchemeFromFile), it
+ * is used as static assignment. Otherwise, if a load model is given, the tasks are assigned by
+ * decreasing load to the group with the lowest accumulated load so far (longest processing time
+ * first); else, they are assigned round-robin.
+ */
+TaskAssignment getTaskAssignment(const std::vector<LevelVector>& levels,
+                                 const std::vector<real>& coeffs, size_t processGroupNumber,
+                                 size_t numberOfGroups,
+                                 const std::vector<size_t>& processGroupNumbers = {},
+                                 LoadModel* loadModel = nullptr);
+
+/**
+ * @brief drives the combination technique with worker processes only
+ *
+ * All ranks are workers (cf. MPISystem::initWorldReusable with withWorldManager = false); every
+ * step is a collective call on all of them, so there are no signals from a manager rank and no
+ * round trips to it. The driver owns the ProcessGroupWorker, which can be accessed for anything
+ * not covered here (e.g. reading subspace sizes or evaluating norms).
+ *
+ * Usage:
+ *   WorkerOnlyDriver driver(params);
+ *   driver.initializeTasks<TaskType>(getTaskAssignment(...), taskArguments...);
+ *   driver.run(numberOfCombinations);
+ *   driver.exit();
+ */
+class WorkerOnlyDriver {
+ public:
+  typedef std::function<void(WorkerOnlyDriver&, size_t)> StepHook;
+
+  explicit WorkerOnlyDriver(const CombiParameters& params);
+
+  WorkerOnlyDriver(WorkerOnlyDriver const&) = delete;
+  WorkerOnlyDriver& operator=(WorkerOnlyDriver const&) = delete;
+
+  /**
+   * @brief create the tasks of this process group and initialize the sparse grids for them
+   */
+  template <typename TaskType, typename... TaskArgs>
+  void initializeTasks(const TaskAssignment& assignment, TaskArgs&&... args) {
+    worker_.initializeAllTasks<TaskType>(assignment.levels, assignment.coeffs,
+                                         assignment.taskNumbers, std::forward<TaskArgs>(args)...);
+    worker_.initCombinedUniDSGVector();
+  }
+
+  /**
+   * @brief combine through files instead of the global reduce only: the output group writes its
+   * sparse grid to "<filePrefix>_<systemNumber>_step<i>", reduces it with the one of the other
+   * system (or its own, if there is only one system), and broadcasts the result to the other
+   * groups
+   */
+  void setFileBasedCombination(unsigned int systemNumber, unsigned int numberOfSystems,
+                               const std::string& filePrefix = "dsg");
+
+  /**
+   * @brief write partial Stats to "<filePrefix>_group<g>.json" after every combination
+   */
+  void setStatsOutput(const std::string& filePrefix);
+
+  /**
+   * @brief interpolate the combined solution at the coordinates after every run step, and write
+   * the values to a single file per step (cf. ProcessGroupWorker::writeInterpolatedValuesSingleFile)
+   */
+  void setInterpolation(const std::vector<std::vector<real>>& interpolationCoords,
+                        const std::string& filenamePrefix);
+
+  /**
+   * @brief let run() do the run and combine steps as one pipelined step (cf. runAndCombineStep),
+   * reducing the sparse grids in chunks of chunkSize elements
+   */
+  void setPipelinedCombination(bool pipelined = true,
+                               size_t chunkSize = CombiCom::globalReduceChunkSize);
+
+  // called (collectively) after every run step / combination, with the number of the step
+  void setAfterRunHook(StepHook hook) { afterRunHook_ = std::move(hook); }
+
+  void setAfterCombineHook(StepHook hook) { afterCombineHook_ = std::move(hook); }
+
+  /**
+   * @brief collective: run all tasks of this group for one time interval
+   */
+  void runStep();
+
+  /**
+   * @brief collective: combine the component grids of all groups (and systems)
+   */
+  void combineStep();
+
+  /**
+   * @brief collective: run and combine, with each task's combination overlapping the runs and
+   * combinations of the others (cf. ProcessGroupWorker::runAndCombinePipelined); only for the
+   * combination by global reduce, and without interpolation or after-run hook, as there is no
+   * point between the run and the combination anymore
+   */
+  void runAndCombineStep();
+
+  /**
+   * @brief collective: alternate run and combine steps numberOfCombinations times
+   */
+  void run(size_t numberOfCombinations);
+
+  /**
+   * @brief collective: clean up the tasks
+   */
+  void exit();
+
+  ProcessGroupWorker& getWorker() { return worker_; }
+
+  size_t getNumberOfRunSteps() const { return numberOfRunSteps_; }
+
+ private:
+  // write the partial Stats and call the hook after combination number combinationNumber
+  void finishCombineStep(size_t combinationNumber);
+
+  ProcessGroupWorker worker_;
+
+  size_t numberOfRunSteps_ = 0;
+
+  bool fileBasedCombination_ = false;
+
+  bool pipelinedCombination_ = false;
+
+  size_t pipelinedChunkSize_ = CombiCom::globalReduceChunkSize;
+
+  unsigned int systemNumber_ = 0;
+
+  unsigned int numberOfSystems_ = 1;
+
+  std::string combinationFilePrefix_;
+
+  std::string statsFilePrefix_;
+
+  std::vector<std::vector<real>> interpolationCoords_;
+
+  std::string interpolationFilePrefix_;
+
+  StepHook afterRunHook_;
+
+  StepHook afterCombineHook_;
+};
+
+}  // namespace combigrid
+
+#endif /* WORKERONLYDRIVER_HPP_ */
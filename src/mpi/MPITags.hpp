@@ -18,5 +18,10 @@ constexpr int TRANSFER_GHOST_LAYER_TAG = MAX_TAG - 9;
 constexpr int TRANSFER_NORM_TAG = MAX_TAG - 10;
 constexpr int TRANSFER_INTERPOLATION_TAG = MAX_TAG - 11;
 constexpr int TRANSFER__TAG = MAX_TAG - 12;
+constexpr int TRANSFER_MEMORY_REPORT_TAG = MAX_TAG - 13;
+constexpr int TRANSFER_CHECKPOINT_LAYOUT_TAG = MAX_TAG - 14;
+constexpr int TRANSFER_CHECKPOINT_DATA_TAG = MAX_TAG - 15;
+// keep last: the halo exchange uses two tags per dimension, counting down from here
+constexpr int TRANSFER_HALO_TAG = MAX_TAG - 16;
 
 }  // namespace combigrid
\ No newline at end of file
@@ -2,13 +2,21 @@
 #define SRC_SGPP_COMBIGRID_SPARSEGRID_DISTRIBUTEDSPARSEGRIDUNIFORM_HPP_
 
 #include <assert.h>
+#include <algorithm>
+#include <array>
 
 #include "utils/Types.hpp"
+#include "utils/GridAllocator.hpp"
 #include "utils/LevelSetUtils.hpp"
+#include "utils/MemoryTracker.hpp"
+#include "utils/PackedLevelVectorIndex.hpp"
+#include "utils/PowerOfTwo.hpp"
 #include "manager/ProcessGroupSignals.hpp"
 #include "mpi/MPITags.hpp"
 #include "io/MPIInputOutput.hpp"
+#include <map>
 #include <numeric>
+#include <set>
 
 #include <boost/serialization/vector.hpp>
 
@@ -17,6 +25,24 @@ namespace combigrid {
 template <typename FG_ELEMENT>
 class DistributedFullGrid;
 
+/**
+ * @brief describes which points of the sparse grid's subspaces a process holds, and in which basis
+ *
+ * The bounds are the 1d indices (first, and one past the last) of the process' part of the domain
+ * on the reference level, for which the decomposition is given (cf.
+ * CombiParameters::getDecomposition(), downsampleDecomposition()). Up to nodalLevel, the
+ * coefficients are not hierarchical surpluses but nodal values on that level (cf. the lmin
+ * argument of DistributedHierarchization::hierarchize); in non-hierarchized dimensions,
+ * nodalLevel is the reference level.
+ */
+struct SparseGridPartition {
+  LevelVector referenceLevel;
+  std::vector<BoundaryType> boundary;
+  IndexVector lowerBounds;
+  IndexVector upperBounds;
+  LevelVector nodalLevel;
+};
+
 /* This class can store a distributed sparse grid with a uniform space
  * decomposition. During construction no data is created and the data size of
  * the subspaces is initialized to zero (data sizes are usually set the
@@ -60,19 +86,26 @@ class DistributedSparseGridUniform {
   void createSubspaceData();
 
   // allocates memory for kahan term data and sets pointers for it
+  // (does nothing if Kahan summation is switched off)
   void createKahanBuffer();
 
+  // switches compensated (Kahan) summation in addDistributedFullGrid on or off;
+  // switching it off releases the Kahan buffer, which is as large as the subspace data
+  void setKahanSummation(bool useKahanSummation);
+
+  inline bool isKahanSummation() const { return useKahanSummation_; }
+
   // deletes memory for subspace data and invalids pointers to subspaces
   void deleteSubspaceData();
 
   // creates data if necessary and sets all data elements to zero
   void setZero();
 
-  // return all level vectors
-  inline const std::vector<LevelVector>& getAllLevelVectors() const;
+  // return all level vectors (unpacked, i.e. allocates them all -- only use if really needed)
+  inline std::vector<LevelVector> getAllLevelVectors() const;
 
   // return level vector of subspace i
-  inline const LevelVector& getLevelVector(SubspaceIndexType i) const;
+  inline LevelVector getLevelVector(SubspaceIndexType i) const;
 
   inline SubspaceIndexType getIndexInRange(const LevelVector& l, IndexType lowerBound) const;
 
@@ -102,6 +135,9 @@ class DistributedSparseGridUniform {
   // clear the levels_ vector, it is only necessary for registration of full grids
   void resetLevels();
 
+  // number of bytes used to store the level vectors and their lookup table
+  inline size_t getLevelsNumBytes() const;
+
   // data size of the subspace at index i
   inline SubspaceSizeType getDataSize(SubspaceIndexType i) const;
 
@@ -111,10 +147,25 @@ class DistributedSparseGridUniform {
   // sets data size of subspace with index i to newSize
   inline void setDataSize(SubspaceIndexType i, SubspaceSizeType newSize);
 
-  inline void registerDistributedFullGrid(const DistributedFullGrid<FG_ELEMENT>& dfg);
+  // the full grids may have a different precision than the sparse grid, e.g. float grids can be
+  // added to a double sparse grid
+  template <typename DFG_ELEMENT>
+  inline void registerDistributedFullGrid(const DistributedFullGrid<DFG_ELEMENT>& dfg);
+
+  /**
+   * @brief sets the subspace sizes on this rank like registerDistributedFullGrid does for the full
+   * grids of all combinationLevels, but computed analytically from the partition, without
+   * creating the grids or walking their downward closed sets
+   *
+   * The full grids have to follow the partition's decomposition (cf. downsampleDecomposition).
+   */
+  void registerCombinationLevels(const std::vector<LevelVector>& combinationLevels,
+                                 const SparseGridPartition& partition);
 
-  inline void addDistributedFullGrid(const DistributedFullGrid<FG_ELEMENT>& dfg,
-                                     combigrid::real coeff);
+  template <typename DFG_ELEMENT>
+  inline void addDistributedFullGrid(const DistributedFullGrid<DFG_ELEMENT>& dfg,
+                                     combigrid::real coeff,
+                                     const std::vector<bool>& selectedSubspaces = {});
 
   // returns the number of allocated grid points == size of the raw data vector
   inline size_t getRawDataSize() const;
@@ -139,11 +190,30 @@ class DistributedSparseGridUniform {
   // returns true if data for the subspaces has been created
   bool isSubspaceDataCreated() const;
 
+  // sets the category under which the subspace data is accounted for in the MemoryTracker
+  inline void setMemoryCategory(MemoryCategory category) {
+    subspacesDataMemory_.setCategory(category);
+  }
+
   // copy data from another DSGU (which has the same subspaces, but they may be less or more populated than in this DSGU)
   void copyDataFrom(const DistributedSparseGridUniform<FG_ELEMENT>& other);
 
   void writeMinMaxCoefficents(const std::string& filename, size_t i) const;
 
+  /**
+   * @brief evaluates this process' part of the sparse grid function on a batch of coordinates,
+   * directly from the hierarchical surpluses (hat basis), without communication
+   *
+   * Only the coordinates that are within the support of one of the local points' basis functions
+   * are evaluated; their positions in interpolationCoords are appended to contributingIndices and
+   * their partial values to contributions. Summing the contributions of all processes gives the
+   * same values as dehierarchizing the sparse grid into a full grid and interpolating there.
+   */
+  void evalLocalContributions(const std::vector<std::vector<real>>& interpolationCoords,
+                              const SparseGridPartition& partition,
+                              std::vector<size_t>& contributingIndices,
+                              std::vector<FG_ELEMENT>& contributions) const;
+
   // naive read/write operations -- each rank writes their own data partition to a separate binary file
   void writeToDiskChunked(std::string filePrefix);
 
@@ -170,7 +240,9 @@ class DistributedSparseGridUniform {
 
   DimType dim_;
 
-  std::vector<LevelVector> levels_; // linear access to all subspaces; may be reset to save memory
+  // linear access to all subspaces, stored packed and with hashed lookup;
+  // may be reset to save memory
+  PackedLevelVectorIndex<SubspaceIndexType> levels_;
 
   CommunicatorType comm_;
 
@@ -180,13 +252,19 @@ class DistributedSparseGridUniform {
 
   std::vector<FG_ELEMENT*> subspaces_;  // pointers to subspaces of the dsg
 
-  std::vector<FG_ELEMENT> subspacesData_;  // allows linear access to all subspaces data
+  GridVector<FG_ELEMENT> subspacesData_;  // allows linear access to all subspaces data
+
+  TrackedMemory subspacesDataMemory_{MemoryCategory::sparseGrids};
 
   std::vector<SubspaceSizeType> subspacesDataSizes_;  // allocated data sizes of all subspaces
 
   std::vector<FG_ELEMENT*> kahanDataBegin_;  // pointers to Kahan summation residual terms
 
-  std::vector<FG_ELEMENT> kahanData_;  // Kahan summation residual terms
+  GridVector<FG_ELEMENT> kahanData_;  // Kahan summation residual terms
+
+  TrackedMemory kahanDataMemory_{MemoryCategory::kahanData};
+
+  bool useKahanSummation_ = true;
 
   friend class boost::serialization::access;
 
@@ -252,6 +330,7 @@ void DistributedSparseGridUniform<FG_ELEMENT>::createSubspaceData() {
     size_t numDataPoints = this->getAccumulatedDataSize();
     assert(numDataPoints > 0 && "all subspaces in dsg have 0 size");
     subspacesData_.resize(numDataPoints, 0.);
+    subspacesDataMemory_.track(subspacesData_);
 
     // update pointers and sizes in subspaces
     SubspaceSizeType offset = 0;
@@ -269,9 +348,13 @@ void DistributedSparseGridUniform<FG_ELEMENT>::createSubspaceData() {
 
 template <typename FG_ELEMENT>
 void DistributedSparseGridUniform<FG_ELEMENT>::createKahanBuffer() {
+  if (!useKahanSummation_) {
+    return;
+  }
   size_t numDataPoints = std::accumulate(subspacesDataSizes_.begin(), subspacesDataSizes_.end(),
                                          static_cast<size_t>(0));
   kahanData_.resize(numDataPoints, 0.);
+  kahanDataMemory_.track(kahanData_);
   kahanDataBegin_.resize(subspacesDataSizes_.size());
 
   // update pointers for begin of subspacen in kahan buffer
@@ -282,6 +365,18 @@ void DistributedSparseGridUniform<FG_ELEMENT>::createKahanBuffer() {
   }
 }
 
+template <typename FG_ELEMENT>
+void DistributedSparseGridUniform<FG_ELEMENT>::setKahanSummation(bool useKahanSummation) {
+  useKahanSummation_ = useKahanSummation;
+  if (!useKahanSummation_) {
+    kahanData_.clear();
+    kahanData_.shrink_to_fit();
+    kahanDataMemory_.track(kahanData_);
+    kahanDataBegin_.clear();
+    kahanDataBegin_.shrink_to_fit();
+  }
+}
+
 /** Deallocates the dsgu data.
  *  This affects the values stored at the grid points and pointers which address
  *  the subspaces data.
@@ -290,6 +385,8 @@ template <typename FG_ELEMENT>
 void DistributedSparseGridUniform<FG_ELEMENT>::deleteSubspaceData() {
   if (isSubspaceDataCreated()) {
     subspacesData_.clear();
+    subspacesData_.shrink_to_fit();
+    subspacesDataMemory_.track(subspacesData_);
 
     // update pointers in subspaces
     for (auto& ss : subspaces_) {
@@ -314,12 +411,12 @@ void DistributedSparseGridUniform<FG_ELEMENT>::setZero() {
 
 template <typename FG_ELEMENT>
 void DistributedSparseGridUniform<FG_ELEMENT>::print(std::ostream& os) const {
-  auto levelIterator = levels_.cbegin();
+  LevelVector level;
   for (size_t i = 0; i < subspaces_.size(); ++i) {
-    os << i << " " << *levelIterator << " " << subspacesDataSizes_[i] << " "
+    levels_.getLevelVector(static_cast<SubspaceIndexType>(i), level);
+    os << i << " " << level << " " << subspacesDataSizes_[i] << " "
       //  << subspaces_[i].size_
        << std::endl;
-    ++levelIterator;
   }
 }
 
@@ -346,17 +443,15 @@ std::vector<LevelVector> DistributedSparseGridUniform<FG_ELEMENT>::createLevels(
 }
 
 template <typename FG_ELEMENT>
-inline const std::vector<LevelVector>&
-DistributedSparseGridUniform<FG_ELEMENT>::getAllLevelVectors() const {
-  return levels_;
+inline std::vector<LevelVector> DistributedSparseGridUniform<FG_ELEMENT>::getAllLevelVectors()
+    const {
+  return levels_.getAllLevelVectors();
 }
 
 template <typename FG_ELEMENT>
-inline const LevelVector& DistributedSparseGridUniform<FG_ELEMENT>::getLevelVector(
+inline LevelVector DistributedSparseGridUniform<FG_ELEMENT>::getLevelVector(
     SubspaceIndexType i) const {
-  auto levelIterator = levels_.cbegin();
-  std::advance(levelIterator, i);
-  return *levelIterator;
+  return levels_.getLevelVector(i);
 }
 
 template <typename FG_ELEMENT>
@@ -368,11 +463,10 @@ DistributedSparseGridUniform<FG_ELEMENT>::getIndexInRange(const LevelVector& l,
     assert(l_i > 0);
   }
 #endif  // NDEBUG
-  auto start = levels_.cbegin();
-  std::advance(start, lowerBound);
-  auto found = std::lower_bound(start, levels_.end(), l);
-  if (found != levels_.end() && *found == l) {
-    return static_cast<SubspaceIndexType>(std::distance(levels_.cbegin(), found));
+  // hashed lookup; the lower bound is kept for compatibility with the former binary search
+  auto found = levels_.find(l);
+  if (found >= lowerBound) {
+    return found;
   } else {
     // assert(false && "space not found in levels_");
     return -1;
@@ -423,8 +517,7 @@ DistributedSparseGridUniform<FG_ELEMENT>::getNumSubspaces() const {
 
 template <typename FG_ELEMENT>
 bool DistributedSparseGridUniform<FG_ELEMENT>::isContained(const LevelVector& l) const {
-  auto found = std::lower_bound(levels_.cbegin(), levels_.cend(), l);
-  return (found != levels_.end() && *found == l);
+  return levels_.find(l) > -1;
 }
 
 template <typename FG_ELEMENT>
@@ -432,6 +525,11 @@ void DistributedSparseGridUniform<FG_ELEMENT>::resetLevels() {
   levels_.clear();
 }
 
+template <typename FG_ELEMENT>
+size_t DistributedSparseGridUniform<FG_ELEMENT>::getLevelsNumBytes() const {
+  return levels_.getNumBytes();
+}
+
 template <typename FG_ELEMENT>
 SubspaceSizeType DistributedSparseGridUniform<FG_ELEMENT>::getDataSize(SubspaceIndexType i) const {
 #ifndef NDEBUG
@@ -479,17 +577,15 @@ void DistributedSparseGridUniform<FG_ELEMENT>::setDataSize(SubspaceIndexType i,
  * @param dfg the DFG to register
  */
 template <typename FG_ELEMENT>
+template <typename DFG_ELEMENT>
 inline void DistributedSparseGridUniform<FG_ELEMENT>::registerDistributedFullGrid(
-    const DistributedFullGrid<FG_ELEMENT>& dfg) {
+    const DistributedFullGrid<DFG_ELEMENT>& dfg) {
   assert(dfg.getDimension() == dim_);
-  // all the hierarchical subspaces contained in the full grid
-  const auto downwardClosedSet = combigrid::getDownSet(dfg.getLevels());
-
-  SubspaceIndexType index = 0;
   IndexType numPointsOfSubspace = 1;
-  // resize all common subspaces in dsg, if necessary
-  for (const auto& level : downwardClosedSet) {
-    index = this->getIndexInRange(level, index);
+  // resize all common subspaces in dsg, if necessary;
+  // iterate all the hierarchical subspaces contained in the full grid
+  combigrid::forEachLevelInDownSet(dfg.getLevels(), [&](const LevelVector& level) {
+    const auto index = this->getIndex(level);
     if (index > -1) {
       numPointsOfSubspace = 1;
       for (DimType d = 0; d < dim_; ++d) {
@@ -506,6 +602,81 @@ inline void DistributedSparseGridUniform<FG_ELEMENT>::registerDistributedFullGri
                                  << level << " , rank " << this->rank_ << std::endl);
       }
     }
+  });
+}
+
+template <typename FG_ELEMENT>
+void DistributedSparseGridUniform<FG_ELEMENT>::registerCombinationLevels(
+    const std::vector<LevelVector>& combinationLevels, const SparseGridPartition& partition) {
+  const auto numSubspaces = this->getNumSubspaces();
+  if (combinationLevels.empty() || numSubspaces == 0) return;
+  assert(partition.referenceLevel.size() == dim_);
+
+  // the number of points of each 1d level on this rank's partition
+  std::vector<std::vector<SubspaceSizeType>> numPoints1d(dim_);
+  // the sparse grid only holds subspaces up to its own maximum level
+  LevelVector sparseGridLmax(dim_, 0);
+  for (SubspaceIndexType i = 0; i < numSubspaces; ++i) {
+    const auto level = this->getLevelVector(i);
+    for (DimType d = 0; d < dim_; ++d) sparseGridLmax[d] = std::max(sparseGridLmax[d], level[d]);
+  }
+  for (DimType d = 0; d < dim_; ++d) {
+    numPoints1d[d].resize(partition.referenceLevel[d] + 1, 0);
+    for (LevelType l = 1; l <= partition.referenceLevel[d]; ++l) {
+      numPoints1d[d][l] = static_cast<SubspaceSizeType>(getNumDofHierarchicalInRange(
+          l, partition.referenceLevel[d], partition.boundary[d], partition.lowerBounds[d],
+          partition.upperBounds[d]));
+    }
+  }
+
+  // a subspace is contained in a component grid if it is one of the (clipped) combination levels
+  // or if one of its upper neighbors is contained; the neighbors have a higher level sum, so the
+  // subspaces are visited by level sum from the top, in parallel for each level sum
+  std::set<LevelVector> clippedLevels;
+  for (const auto& l : combinationLevels) {
+    auto clipped = l;
+    for (DimType d = 0; d < dim_; ++d) clipped[d] = std::min(clipped[d], sparseGridLmax[d]);
+    clippedLevels.insert(clipped);
+  }
+  std::map<LevelType, std::vector<SubspaceIndexType>> subspacesByLevelSum;
+  for (SubspaceIndexType i = 0; i < numSubspaces; ++i) {
+    subspacesByLevelSum[levelSum(this->getLevelVector(i))].push_back(i);
+  }
+  std::vector<char> isContained(numSubspaces, 0);
+  // the sizes are only set afterwards, as setDataSize may reallocate the subspace data
+  std::vector<SubspaceSizeType> containedSizes(numSubspaces, 0);
+  for (auto it = subspacesByLevelSum.rbegin(); it != subspacesByLevelSum.rend(); ++it) {
+    const auto& indices = it->second;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif  // _OPENMP
+    for (size_t j = 0; j < indices.size(); ++j) {
+      const auto i = indices[j];
+      auto level = this->getLevelVector(i);
+      bool contained = clippedLevels.find(level) != clippedLevels.end();
+      for (DimType d = 0; d < dim_ && !contained; ++d) {
+        if (level[d] == sparseGridLmax[d]) continue;
+        ++level[d];
+        const auto neighborIndex = levels_.find(level);
+        if (neighborIndex > -1) {
+          contained = isContained[neighborIndex];
+        } else {
+          // the neighbor is cut off by the truncation of the sparse grid
+          contained = std::any_of(clippedLevels.begin(), clippedLevels.end(),
+                                  [&level](const LevelVector& l) { return level <= l; });
+        }
+        --level[d];
+      }
+      if (contained) {
+        isContained[i] = 1;
+        SubspaceSizeType numPointsOfSubspace = 1;
+        for (DimType d = 0; d < dim_; ++d) numPointsOfSubspace *= numPoints1d[d][level[d]];
+        containedSizes[i] = numPointsOfSubspace;
+      }
+    }
+  }
+  for (SubspaceIndexType i = 0; i < numSubspaces; ++i) {
+    if (isContained[i]) this->setDataSize(i, containedSizes[i]);
   }
 }
 
@@ -515,27 +686,45 @@ inline void DistributedSparseGridUniform<FG_ELEMENT>::registerDistributedFullGri
  *
  * @param dfg the DFG to add
  * @param coeff the coefficient that gets multiplied to all entries in DFG
+ * @param selectedSubspaces if not empty, only the subspaces i with selectedSubspaces[i] are added
  */
 template <typename FG_ELEMENT>
+template <typename DFG_ELEMENT>
 inline void DistributedSparseGridUniform<FG_ELEMENT>::addDistributedFullGrid(
-    const DistributedFullGrid<FG_ELEMENT>& dfg, combigrid::real coeff) {
+    const DistributedFullGrid<DFG_ELEMENT>& dfg, combigrid::real coeff,
+    const std::vector<bool>& selectedSubspaces) {
+  static_assert(sizeof(typename RealTypeOf<FG_ELEMENT>::type) >=
+                    sizeof(typename RealTypeOf<DFG_ELEMENT>::type),
+                "the sparse grid must be at least as precise as the full grids added to it");
   assert(this->isSubspaceDataCreated());
-  if (kahanData_.empty() || kahanDataBegin_.empty()) {
+  assert(selectedSubspaces.empty() ||
+         selectedSubspaces.size() == static_cast<size_t>(this->getNumSubspaces()));
+  if (useKahanSummation_ && (kahanData_.empty() || kahanDataBegin_.empty())) {
     throw std::runtime_error("Kahan data not initialized");
   }
 
   bool anythingWasAdded = false;
+  const auto dfgData = dfg.getData();
+  // accumulate in the precision of the sparse grid
+  const auto c = static_cast<typename RealTypeOf<FG_ELEMENT>::type>(coeff);
 
-  // all the hierarchical subspaces contained in this full grid
-  const auto downwardClosedSet = combigrid::getDownSet(dfg.getLevels());
   static IndexVector subspaceIndices;
 
-  SubspaceIndexType sIndex = 0;
-  // loop over all subspaces of the full grid
-  for (const auto& level : downwardClosedSet) {
-    sIndex = this->getIndexInRange(level, sIndex);
-    if (sIndex > -1 && this->getDataSize(sIndex) > 0) {
+  // loop over all the hierarchical subspaces contained in this full grid
+  combigrid::forEachLevelInDownSet(dfg.getLevels(), [&](const LevelVector& level) {
+    const auto sIndex = this->getIndex(level);
+    if (sIndex > -1 && this->getDataSize(sIndex) > 0 &&
+        (selectedSubspaces.empty() || selectedSubspaces[sIndex])) {
       auto sPointer = this->getData(sIndex);
+      if (!useKahanSummation_) {
+        subspaceIndices = dfg.getFGPointsOfSubspace(level);
+        for (const auto& fIndex : subspaceIndices) {
+          *sPointer += c * static_cast<FG_ELEMENT>(dfgData[fIndex]);
+          ++sPointer;
+          anythingWasAdded = true;
+        }
+        return;
+      }
       auto kPointer = kahanDataBegin_[sIndex];
 #ifndef NDEBUG
       if (sIndex < kahanDataBegin_.size() - 1) {
@@ -545,7 +734,7 @@ inline void DistributedSparseGridUniform<FG_ELEMENT>::addDistributedFullGrid(
 #endif  // NDEBUG
       subspaceIndices = dfg.getFGPointsOfSubspace(level);
       for (const auto& fIndex : subspaceIndices) {
-        FG_ELEMENT summand = coeff * dfg.getElementVector()[fIndex];
+        FG_ELEMENT summand = c * static_cast<FG_ELEMENT>(dfgData[fIndex]);
         // cf. https://en.wikipedia.org/wiki/Kahan_summation_algorithm
         FG_ELEMENT y = summand - *kPointer;
         FG_ELEMENT t = *sPointer + y;
@@ -556,7 +745,7 @@ inline void DistributedSparseGridUniform<FG_ELEMENT>::addDistributedFullGrid(
         anythingWasAdded = true;
       }
     }
-  }
+  });
 
   // make sure that anything was added -- I can only think of weird setups
   // where that would not be the case
@@ -652,6 +841,160 @@ void DistributedSparseGridUniform<FG_ELEMENT>::receiveDsgSizesWithScatter(Commun
   this->deleteSubspaceData();
 }
 
+// the points of level l in one dimension are at the 1d indices offset + i * stride on the
+// reference level (cf. DistributedFullGrid::get1dIndicesLocal)
+static inline void getOffsetAndStrideOfLevel(LevelType l, LevelType referenceLevel, BoundaryType boundary,
+                                      IndexType& offset, IndexType& stride) {
+  if (boundary > 0 && l == 1) {
+    offset = 0;
+    stride = powerOfTwoByBitshift(static_cast<LevelType>(referenceLevel - 1));
+  } else {
+    offset = powerOfTwoByBitshift(static_cast<LevelType>(referenceLevel - l)) -
+             (boundary > 0 ? 0 : 1);
+    stride = powerOfTwoByBitshift(static_cast<LevelType>(referenceLevel - l + 1));
+  }
+}
+
+// number of points of a level with 1d index smaller than idx1d
+static inline IndexType getNumPointsBelow(IndexType idx1d, IndexType offset, IndexType stride) {
+  return idx1d <= offset ? 0 : (idx1d - offset + stride - 1) / stride;
+}
+
+template <typename FG_ELEMENT>
+void DistributedSparseGridUniform<FG_ELEMENT>::evalLocalContributions(
+    const std::vector<std::vector<real>>& interpolationCoords, const SparseGridPartition& partition,
+    std::vector<size_t>& contributingIndices, std::vector<FG_ELEMENT>& contributions) const {
+  assert(this->isSubspaceDataCreated());
+  assert(!levels_.empty() && "cannot evaluate without levels");
+  assert(partition.referenceLevel.size() == dim_);
+  // in every dimension, at most three points of a level have a basis function that is nonzero
+  // at some coordinate (on level 1 with boundary: the two boundary points and the middle point)
+  constexpr int maxPointsPerLevel = 3;
+  struct OneDContribution {
+    int numPoints = 0;
+    std::array<IndexType, maxPointsPerLevel> localPosition;
+    std::array<real, maxPointsPerLevel> basisValue;
+  };
+
+  // per dimension and level: offset, stride, and the number of local points
+  std::vector<std::vector<IndexType>> offsets(dim_), strides(dim_), numLocalPoints(dim_),
+      numPointsBelowLowerBound(dim_);
+  for (DimType d = 0; d < dim_; ++d) {
+    const auto maxLevel = partition.referenceLevel[d];
+    offsets[d].resize(maxLevel + 1);
+    strides[d].resize(maxLevel + 1);
+    numLocalPoints[d].resize(maxLevel + 1);
+    numPointsBelowLowerBound[d].resize(maxLevel + 1);
+    for (LevelType l = 1; l <= maxLevel; ++l) {
+      getOffsetAndStrideOfLevel(l, maxLevel, partition.boundary[d], offsets[d][l], strides[d][l]);
+      numPointsBelowLowerBound[d][l] =
+          getNumPointsBelow(partition.lowerBounds[d], offsets[d][l], strides[d][l]);
+      numLocalPoints[d][l] =
+          getNumPointsBelow(partition.upperBounds[d], offsets[d][l], strides[d][l]) -
+          numPointsBelowLowerBound[d][l];
+    }
+  }
+
+  std::vector<std::vector<OneDContribution>> oneDContributions(dim_);
+  for (DimType d = 0; d < dim_; ++d) {
+    oneDContributions[d].resize(partition.referenceLevel[d] + 1);
+  }
+  LevelVector level(dim_);
+  IndexVector localIndexOffsets(dim_);
+  std::vector<int> pointInDimension(dim_);
+
+  for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+    const auto& coords = interpolationCoords[i];
+    assert(coords.size() == dim_);
+    // 1d basis function values of the local points, per dimension and level
+    for (DimType d = 0; d < dim_; ++d) {
+      const auto x = coords[d];
+      const auto boundary = partition.boundary[d];
+      for (LevelType l = 1; l <= partition.referenceLevel[d]; ++l) {
+        auto& oneD = oneDContributions[d][l];
+        oneD.numPoints = 0;
+        // candidate points j * 2^-l
+        std::array<IndexType, maxPointsPerLevel> candidates;
+        int numCandidates = 0;
+        if (boundary > 0 && l == 1) {
+          candidates = {0, 1, 2};
+          numCandidates = boundary == 1 ? 2 : 3;
+        } else {
+          auto lowerNeighbor = static_cast<IndexType>(std::floor(x * powerOfTwo[l]));
+          auto oddNeighbor = (lowerNeighbor % 2 == 1) ? lowerNeighbor : lowerNeighbor + 1;
+          if (oddNeighbor < powerOfTwo[l]) {
+            candidates[numCandidates++] = oddNeighbor;
+          }
+        }
+        for (int c = 0; c < numCandidates; ++c) {
+          const auto j = candidates[c];
+          // boundary points are on level 0; below the nodal level, the hats are nodal ones
+          const auto pointLevel = (j == 0 || j == powerOfTwo[l]) ? static_cast<LevelType>(0) : l;
+          const auto width = oneOverPowOfTwo[std::max(pointLevel, partition.nodalLevel[d])];
+          const real pointCoordinate = static_cast<real>(j) * oneOverPowOfTwo[l];
+          real basisValue = std::max(0., 1. - std::abs(x - pointCoordinate) / width);
+          if (boundary == 1 && j == 0) {
+            // periodic: the hat at 0 is also the one at 1
+            basisValue += std::max(0., 1. - std::abs(x - 1.) / width);
+          }
+          if (basisValue <= 0.) continue;
+          const IndexType idx1d = (boundary > 0 && l == 1) ? j * strides[d][l]
+                                                            : offsets[d][l] + (j / 2) * strides[d][l];
+          if (idx1d < partition.lowerBounds[d] || idx1d >= partition.upperBounds[d]) continue;
+          oneD.localPosition[oneD.numPoints] =
+              getNumPointsBelow(idx1d, offsets[d][l], strides[d][l]) -
+              numPointsBelowLowerBound[d][l];
+          oneD.basisValue[oneD.numPoints] = basisValue;
+          ++oneD.numPoints;
+        }
+      }
+    }
+
+    // sum up the contributions of all subspaces
+    bool isContributing = false;
+    FG_ELEMENT value = 0.;
+    for (SubspaceIndexType s = 0; s < getNumSubspaces(); ++s) {
+      if (subspacesDataSizes_[s] == 0) continue;
+      levels_.getLevelVector(s, level);
+      bool hasLocalSupport = true;
+      IndexType localIndexOffset = 1;
+      for (DimType d = 0; d < dim_ && hasLocalSupport; ++d) {
+        assert(level[d] <= partition.referenceLevel[d]);
+        hasLocalSupport = oneDContributions[d][level[d]].numPoints > 0;
+        localIndexOffsets[d] = localIndexOffset;
+        localIndexOffset *= numLocalPoints[d][level[d]];
+      }
+      if (!hasLocalSupport) continue;
+      assert(localIndexOffset == static_cast<IndexType>(subspacesDataSizes_[s]));
+      isContributing = true;
+      // iterate the tensor product of the 1d contributions, first dimension fastest
+      std::fill(pointInDimension.begin(), pointInDimension.end(), 0);
+      const auto* data = subspaces_[s];
+      while (true) {
+        real basisValue = 1.;
+        IndexType localIndex = 0;
+        for (DimType d = 0; d < dim_; ++d) {
+          const auto& oneD = oneDContributions[d][level[d]];
+          basisValue *= oneD.basisValue[pointInDimension[d]];
+          localIndex += oneD.localPosition[pointInDimension[d]] * localIndexOffsets[d];
+        }
+        value +=
+            static_cast<typename RealTypeOf<FG_ELEMENT>::type>(basisValue) * data[localIndex];
+        DimType d = 0;
+        for (; d < dim_; ++d) {
+          if (++pointInDimension[d] < oneDContributions[d][level[d]].numPoints) break;
+          pointInDimension[d] = 0;
+        }
+        if (d == dim_) break;
+      }
+    }
+    if (isContributing) {
+      contributingIndices.push_back(i);
+      contributions.push_back(value);
+    }
+  }
+}
+
 template <typename FG_ELEMENT>
 inline void DistributedSparseGridUniform<FG_ELEMENT>::writeMinMaxCoefficents(
     const std::string& filename, size_t outputIndex) const {
@@ -803,6 +1146,71 @@ static void sendDsgData(DistributedSparseGridUniform<FG_ELEMENT>* dsgu, RankType
            comm);
 }
 
+/**
+ * Creates an MPI datatype that selects, in place, those subspaces of the raw dsg data
+ * for which partialSizes is non-zero (a partial view, e.g. the subspaces that are also present
+ * in another system). The selected subspaces have to be complete, i.e.
+ * partialSizes[i] is either 0 or dsgu->getDataSize(i).
+ * The caller has to free the datatype.
+ */
+template <typename FG_ELEMENT>
+static MPI_Datatype getPartialDsgDatatype(DistributedSparseGridUniform<FG_ELEMENT>* dsgu,
+                                          const std::vector<SubspaceSizeType>& partialSizes) {
+  assert(dsgu->isSubspaceDataCreated());
+  assert(partialSizes.size() == static_cast<size_t>(dsgu->getNumSubspaces()));
+  if (dsgu->getRawDataSize() >= INT_MAX) {
+    throw std::runtime_error(
+        "getPartialDsgDatatype: Dsg is too large to be addressed by an MPI datatype");
+  }
+  std::vector<int> blockLengths;
+  std::vector<int> displacements;
+  const FG_ELEMENT* rawData = dsgu->getRawData();
+  for (decltype(dsgu->getNumSubspaces()) i = 0; i < dsgu->getNumSubspaces(); ++i) {
+    if (partialSizes[i] == 0) continue;
+    assert(partialSizes[i] == dsgu->getDataSize(i));
+    auto displacement = static_cast<int>(dsgu->getData(i) - rawData);
+    if (!blockLengths.empty() && displacements.back() + blockLengths.back() == displacement) {
+      // merge with previous block
+      blockLengths.back() += static_cast<int>(partialSizes[i]);
+    } else {
+      blockLengths.push_back(static_cast<int>(partialSizes[i]));
+      displacements.push_back(displacement);
+    }
+  }
+  MPI_Datatype dataType = getMPIDatatype(abstraction::getabstractionDataType<FG_ELEMENT>());
+  MPI_Datatype partialType;
+  MPI_Type_indexed(static_cast<int>(blockLengths.size()), blockLengths.data(),
+                   displacements.data(), dataType, &partialType);
+  MPI_Type_commit(&partialType);
+  return partialType;
+}
+
+/**
+ * Sends the partial view of the raw dsg data selected by partialSizes to the destination
+ * process in communicator comm; the receiver gets the selected subspaces contiguously.
+ */
+template <typename FG_ELEMENT>
+static void sendDsgDataPartial(DistributedSparseGridUniform<FG_ELEMENT>* dsgu,
+                               const std::vector<SubspaceSizeType>& partialSizes, RankType dest,
+                               CommunicatorType comm) {
+  MPI_Datatype partialType = getPartialDsgDatatype(dsgu, partialSizes);
+  MPI_Send(dsgu->getRawData(), 1, partialType, dest, TRANSFER_DSGU_DATA_TAG, comm);
+  MPI_Type_free(&partialType);
+}
+
+/**
+ * Receives contiguous data into the partial view of the raw dsg data selected by partialSizes.
+ */
+template <typename FG_ELEMENT>
+static void recvDsgDataPartial(DistributedSparseGridUniform<FG_ELEMENT>* dsgu,
+                               const std::vector<SubspaceSizeType>& partialSizes, RankType source,
+                               CommunicatorType comm) {
+  MPI_Datatype partialType = getPartialDsgDatatype(dsgu, partialSizes);
+  MPI_Recv(dsgu->getRawData(), 1, partialType, source, TRANSFER_DSGU_DATA_TAG, comm,
+           MPI_STATUS_IGNORE);
+  MPI_Type_free(&partialType);
+}
+
 /**
 * Recvs the raw dsg data from the source process in communicator comm.
 */
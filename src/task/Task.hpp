@@ -4,6 +4,7 @@
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/serialization/vector.hpp>
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include "fault_tolerance/FaultCriterion.hpp"
@@ -93,6 +94,25 @@ class Task {
   // This method returns the local part of the n-th distributedFullGrid
   virtual DistributedFullGrid<CombiDataType>& getDistributedFullGrid(int n = 0) = 0;
 
+  // override to hold the grids in single precision instead of CombiDataType; they are then
+  // accessed through getSinglePrecisionDistributedFullGrid, and combined like the others
+  virtual bool isSinglePrecision() const { return false; }
+
+  // the local part of the n-th distributedFullGrid of a single precision task
+  virtual DistributedFullGrid<SinglePrecisionDataType>& getSinglePrecisionDistributedFullGrid(
+      int n = 0) {
+    throw std::runtime_error("getSinglePrecisionDistributedFullGrid: task is not single precision");
+  }
+
+  // call f with the local part of the n-th distributedFullGrid, in the task's element type
+  template <typename F>
+  decltype(auto) visitDistributedFullGrid(F&& f, int n = 0) {
+    if (isSinglePrecision()) {
+      return f(getSinglePrecisionDistributedFullGrid(n));
+    }
+    return f(getDistributedFullGrid(n));
+  }
+
   virtual void setZero() = 0;
 
   // override if there is adaptive timestepping in the solver
@@ -117,7 +137,7 @@ class Task {
   }
 
   // do task-specific postprocessing (by default: nothing)
-  virtual void doDiagnostics(const std::vector<DistributedSparseGridUniform<CombiDataType>*>, const std::vector<bool>& hierarchizationDims) {
+  virtual void doDiagnostics(const std::vector<DistributedSparseGridUniform<SparseGridDataType>*>, const std::vector<bool>& hierarchizationDims) {
     std::cout << "doDiagnostics called but not implemented";
   }
 
@@ -21,6 +21,9 @@
 #include <memory>
 #include <string.h>
 
+#include "utils/GridAllocator.hpp"
+#include "utils/MemoryTracker.hpp"
+
 namespace combigrid {
 
 template <typename FG_ELEMENT>
@@ -197,7 +200,9 @@ bool ClientSocket::recvallBinaryAndCorrectInPlace(FG_ELEMENT* buff,
   int err;
   ssize_t recvd = -1;
   size_t totalRecvd = 0;
-  std::vector<char> recvBuff(chunksize);
+  GridVector<char> recvBuff(chunksize);
+  TrackedMemory recvBuffMemory(MemoryCategory::communicationBuffers);
+  recvBuffMemory.track(recvBuff);
   size_t rawSize = buffSize * sizeof(FG_ELEMENT);
 
   // for oddly received data
@@ -307,7 +312,9 @@ bool ClientSocket::recvallBinaryAndReduceInPlace(FG_ELEMENT* buff,
   // for recv()
   int err;
   ssize_t recvd = -1;
-  std::vector<char> recvBuff(chunksize);
+  GridVector<char> recvBuff(chunksize);
+  TrackedMemory recvBuffMemory(MemoryCategory::communicationBuffers);
+  recvBuffMemory.track(recvBuff);
   size_t totalRecvd = 0;
   size_t rawSize = buffSize * sizeof(FG_ELEMENT);
 
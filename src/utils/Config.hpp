@@ -82,13 +82,28 @@ typedef std::complex<real> complex;
  * have two options: real values or complex numbers. other datatypes like int
  * have not been tested and operations on the grids like evaluation or
  * hierarchization might produce unexpected results.
+ * with SINGLEPRECISION, the component grids hold float values (halving their
+ * memory and communication volume), but they are still combined in double
+ * precision sparse grids (SparseGridDataType).
+ * independently of that, single tasks may hold their grids in single precision
+ * (SinglePrecisionDataType, cf. Task::isSinglePrecision), mixed with
+ * CombiDataType tasks in the same run.
  */
+#ifdef SINGLEPRECISION
+	typedef float gridReal;
+#else
+	typedef real gridReal;
+#endif
 #ifdef ISGENE
-	typedef complex CombiDataType;
+	typedef std::complex<gridReal> CombiDataType;
+	typedef complex SparseGridDataType;
+	typedef std::complex<float> SinglePrecisionDataType;
 	// this switch seems to make not much of a difference after all ;)
 	constexpr bool reverseOrderingDFGPartitions = true;
 #else
-	typedef real CombiDataType;
+	typedef gridReal CombiDataType;
+	typedef real SparseGridDataType;
+	typedef float SinglePrecisionDataType;
 	constexpr bool reverseOrderingDFGPartitions = false;
 #endif
 
@@ -0,0 +1,266 @@
+#include "utils/DecompositionPlanner.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+
+#include "fullgrid/DistributedFullGrid.hpp"
+#include "utils/LevelSetUtils.hpp"
+#include "utils/PowerOfTwo.hpp"
+
+namespace combigrid {
+
+namespace {
+
+/**
+ * number of points outside the 1d index range [lower, upper) that are needed to hierarchize
+ * the points inside it, i.e. the nearest coarser points left and right of the range
+ */
+IndexType getNumRemoteHierarchicalParents(LevelType nodalLevel, BoundaryType boundary,
+                                          IndexType lower, IndexType upper) {
+  if (upper <= lower) return 0;
+  // positions in units of the finest mesh width, 0 is the left boundary
+  const IndexType shift = boundary > 0 ? 0 : 1;
+  const IndexType lowerPosition = lower + shift;
+  const IndexType lastPosition = upper - 1 + shift;
+  const IndexType rightBoundaryPosition = powerOfTwoByBitshift(nodalLevel);
+  std::set<IndexType> remote;
+  for (LevelType k = 0; k < nodalLevel; ++k) {
+    // the points of level <= k
+    const IndexType stride = powerOfTwoByBitshift(static_cast<LevelType>(nodalLevel - k));
+    if (lowerPosition % stride != 0) {
+      const auto left = lowerPosition / stride * stride;
+      if (boundary > 0 || left > 0) remote.insert(left);
+    }
+    if (lastPosition % stride != 0) {
+      const auto right = (lastPosition / stride + 1) * stride;
+      if (right < rightBoundaryPosition || boundary == 2 ||
+          // periodic: the right boundary is the left one, which may be local
+          (boundary == 1 && right == rightBoundaryPosition && lower > 0)) {
+        remote.insert(right);
+      }
+    }
+  }
+  return static_cast<IndexType>(remote.size());
+}
+
+IndexType getPartitionUpperBound(const IndexVector& decomposition1d, size_t k,
+                                 IndexType numPoints) {
+  return k + 1 < decomposition1d.size() ? decomposition1d[k + 1] : numPoints;
+}
+
+/**
+ * sparse grid size per rank of the subspaces [begin, end), which agree in the dimensions < d;
+ * indexed by the partition coordinates of the dimensions >= d, the first one fastest
+ */
+std::vector<IndexType> accumulateSubspaceSizes(
+    std::vector<LevelVector>::const_iterator begin, std::vector<LevelVector>::const_iterator end,
+    DimType d, const std::vector<std::vector<IndexVector>>& numPointsPerLevelAndPartition,
+    const std::vector<int>& p) {
+  const auto dim = static_cast<DimType>(p.size());
+  if (d == dim) {
+    return {static_cast<IndexType>(std::distance(begin, end))};
+  }
+  const auto numRanksFromHere =
+      std::accumulate(p.begin() + d, p.end(), size_t(1), std::multiplies<size_t>());
+  std::vector<IndexType> sizes(numRanksFromHere, 0);
+  while (begin != end) {
+    const auto level = (*begin)[d];
+    auto groupEnd = std::find_if(begin, end, [d, level](const LevelVector& l) {
+      return l[d] != level;
+    });
+    const auto childSizes =
+        accumulateSubspaceSizes(begin, groupEnd, static_cast<DimType>(d + 1),
+                                numPointsPerLevelAndPartition, p);
+    const auto& numPoints = numPointsPerLevelAndPartition[d][level];
+    for (size_t r = 0; r < childSizes.size(); ++r) {
+      for (int k = 0; k < p[d]; ++k) {
+        sizes[k + p[d] * r] += numPoints[k] * childSizes[r];
+      }
+    }
+    begin = groupEnd;
+  }
+  return sizes;
+}
+
+/** the (sorted) subspaces of all component grids that are contained in the sparse grid */
+std::vector<LevelVector> getSparseGridSubspaces(const std::vector<LevelVector>& combinationLevels,
+                                                const LevelVector& lmax,
+                                                const DecompositionPlannerOptions& options) {
+  auto sparseGridLmax = lmax;
+  if (!options.reduceCombinationDimsLmax.empty()) {
+    sparseGridLmax = lmax - options.reduceCombinationDimsLmax;
+  }
+  std::set<LevelVector> subspaces;
+  for (const auto& l : combinationLevels) {
+    forEachLevelInDownSet(l, [&subspaces, &sparseGridLmax](const LevelVector& level) {
+      if (level <= sparseGridLmax) subspaces.insert(level);
+    });
+  }
+  return std::vector<LevelVector>(subspaces.begin(), subspaces.end());
+}
+
+DecompositionPlan evaluateDecomposition(const std::vector<LevelVector>& combinationLevels,
+                                        const std::vector<LevelVector>& subspaces,
+                                        const LevelVector& lmax,
+                                        const std::vector<BoundaryType>& boundary,
+                                        const std::vector<int>& p,
+                                        const DecompositionPlannerOptions& options) {
+  const auto dim = static_cast<DimType>(lmax.size());
+  assert(p.size() == dim && boundary.size() == dim);
+  DecompositionPlan plan;
+  plan.parallelization = p;
+  IndexVector numPoints(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    numPoints[d] = getNumDofNodal(lmax[d], boundary[d]);
+  }
+  plan.decomposition = getDefaultDecomposition(numPoints, p, options.forwardDecomposition);
+
+  // hierarchization: per dimension, the remote parents times the local size of the others
+  for (const auto& level : combinationLevels) {
+    const auto decomposition = downsampleDecomposition(plan.decomposition, lmax, level, boundary);
+    IndexVector maxLocal(dim), maxRemote(dim), totalRemote(dim);
+    for (DimType d = 0; d < dim; ++d) {
+      const auto numPointsOfLevel = getNumDofNodal(level[d], boundary[d]);
+      for (size_t k = 0; k < decomposition[d].size(); ++k) {
+        const auto lower = decomposition[d][k];
+        const auto upper = getPartitionUpperBound(decomposition[d], k, numPointsOfLevel);
+        const auto remote =
+            p[d] > 1 ? getNumRemoteHierarchicalParents(level[d], boundary[d], lower, upper) : 0;
+        maxLocal[d] = std::max(maxLocal[d], upper - lower);
+        maxRemote[d] = std::max(maxRemote[d], remote);
+        totalRemote[d] += remote;
+      }
+    }
+    for (DimType d = 0; d < dim; ++d) {
+      IndexType maxPerRank = maxRemote[d];
+      IndexType total = totalRemote[d];
+      for (DimType j = 0; j < dim; ++j) {
+        if (j == d) continue;
+        maxPerRank *= maxLocal[j];
+        total *= getNumDofNodal(level[j], boundary[j]);
+      }
+      plan.hierarchizationMaxPerRank += maxPerRank;
+      plan.hierarchizationTotal += total;
+    }
+  }
+
+  // sparse grid: the points of each hierarchical level on each partition of the lmax grid
+  std::vector<std::vector<IndexVector>> numPointsPerLevelAndPartition(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    numPointsPerLevelAndPartition[d].resize(lmax[d] + 1, IndexVector(p[d], 0));
+    for (LevelType l = 1; l <= lmax[d]; ++l) {
+      for (int k = 0; k < p[d]; ++k) {
+        numPointsPerLevelAndPartition[d][l][k] = getNumDofHierarchicalInRange(
+            l, lmax[d], boundary[d], plan.decomposition[d][k],
+            getPartitionUpperBound(plan.decomposition[d], k, numPoints[d]));
+      }
+    }
+  }
+  const auto sizes = accumulateSubspaceSizes(subspaces.cbegin(), subspaces.cend(), 0,
+                                             numPointsPerLevelAndPartition, p);
+  plan.sparseGridMaxPerRank = *std::max_element(sizes.begin(), sizes.end());
+  plan.sparseGridMinPerRank = *std::min_element(sizes.begin(), sizes.end());
+  plan.sparseGridTotal = std::accumulate(sizes.begin(), sizes.end(), IndexType(0));
+
+  plan.cost = options.hierarchizationWeight * static_cast<double>(plan.hierarchizationMaxPerRank) +
+              options.reduceWeight * static_cast<double>(plan.sparseGridMaxPerRank);
+  return plan;
+}
+
+void addParallelizationCandidates(DimType d, int remainingProcs, std::vector<int>& p,
+                                  const IndexVector& maxProcs,
+                                  const DecompositionPlannerOptions& options,
+                                  std::vector<std::vector<int>>& candidates) {
+  const auto dim = static_cast<DimType>(p.size());
+  if (d == dim) {
+    if (remainingProcs == 1) candidates.push_back(p);
+    return;
+  }
+  for (int p_d = 1; p_d <= remainingProcs; ++p_d) {
+    if (remainingProcs % p_d != 0 || p_d > maxProcs[d]) continue;
+    if (d < options.fixedProcs.size() && options.fixedProcs[d] > 0 && options.fixedProcs[d] != p_d)
+      continue;
+    p[d] = p_d;
+    addParallelizationCandidates(static_cast<DimType>(d + 1), remainingProcs / p_d, p, maxProcs,
+                                 options, candidates);
+  }
+}
+
+}  // namespace
+
+double DecompositionPlan::getSparseGridImbalance() const {
+  const auto numRanks = std::accumulate(parallelization.begin(), parallelization.end(), 1,
+                                        std::multiplies<int>());
+  if (sparseGridTotal == 0) return 1.;
+  return static_cast<double>(sparseGridMaxPerRank) * numRanks /
+         static_cast<double>(sparseGridTotal);
+}
+
+std::string DecompositionPlan::toString() const {
+  std::stringstream ss;
+  ss << "p =";
+  for (const auto& p_d : parallelization) ss << " " << p_d;
+  ss << ": hierarchization max/rank " << hierarchizationMaxPerRank << " total "
+     << hierarchizationTotal << ", sparse grid max/rank " << sparseGridMaxPerRank << " min/rank "
+     << sparseGridMinPerRank << " total " << sparseGridTotal << " (imbalance "
+     << getSparseGridImbalance() << "), cost " << cost;
+  return ss.str();
+}
+
+std::vector<std::vector<int>> getParallelizationCandidates(
+    const LevelVector& lmin, const std::vector<BoundaryType>& boundary, int numProcs,
+    const DecompositionPlannerOptions& options) {
+  const auto dim = static_cast<DimType>(lmin.size());
+  if (numProcs < 1) {
+    throw std::invalid_argument("number of processes has to be positive");
+  }
+  // every process needs points on the coarsest grids, cf. getDefaultDecomposition
+  IndexVector maxProcs(dim);
+  for (DimType d = 0; d < dim; ++d) {
+    maxProcs[d] = getNumDofNodal(lmin[d], boundary[d]);
+    if (d < options.maxProcs.size() && options.maxProcs[d] > 0) {
+      maxProcs[d] = std::min(maxProcs[d], static_cast<IndexType>(options.maxProcs[d]));
+    }
+  }
+  std::vector<std::vector<int>> candidates;
+  std::vector<int> p(dim);
+  addParallelizationCandidates(0, numProcs, p, maxProcs, options, candidates);
+  return candidates;
+}
+
+DecompositionPlan evaluateDecomposition(const std::vector<LevelVector>& combinationLevels,
+                                        const LevelVector& lmax,
+                                        const std::vector<BoundaryType>& boundary,
+                                        const std::vector<int>& p,
+                                        const DecompositionPlannerOptions& options) {
+  return evaluateDecomposition(combinationLevels,
+                               getSparseGridSubspaces(combinationLevels, lmax, options), lmax,
+                               boundary, p, options);
+}
+
+std::vector<DecompositionPlan> planDecompositions(
+    const std::vector<LevelVector>& combinationLevels, const LevelVector& lmin,
+    const LevelVector& lmax, const std::vector<BoundaryType>& boundary, int numProcs,
+    const DecompositionPlannerOptions& options) {
+  const auto candidates = getParallelizationCandidates(lmin, boundary, numProcs, options);
+  const auto subspaces = getSparseGridSubspaces(combinationLevels, lmax, options);
+  std::vector<DecompositionPlan> plans(candidates.size());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic)
+#endif  // _OPENMP
+  for (size_t i = 0; i < candidates.size(); ++i) {
+    plans[i] =
+        evaluateDecomposition(combinationLevels, subspaces, lmax, boundary, candidates[i], options);
+  }
+  std::stable_sort(plans.begin(), plans.end(),
+                   [](const DecompositionPlan& a, const DecompositionPlan& b) {
+                     if (a.cost != b.cost) return a.cost < b.cost;
+                     return a.sparseGridTotal < b.sparseGridTotal;
+                   });
+  return plans;
+}
+
+}  // namespace combigrid
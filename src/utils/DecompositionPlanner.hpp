@@ -0,0 +1,95 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "utils/LevelVector.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief constraints and weights for the choice of the parallelization vector p
+ */
+struct DecompositionPlannerOptions {
+  /** entries > 0 fix p in that dimension, e.g. if the solver cannot split a dimension (1) */
+  std::vector<int> fixedProcs;
+
+  /** entries > 0 limit p in that dimension */
+  std::vector<int> maxProcs;
+
+  /** if the grid points on the process boundaries belong to the right-hand process */
+  bool forwardDecomposition = false;
+
+  /**
+   * the sparse grid lmax is lmax - reduceCombinationDimsLmax (as in CombiParameters);
+   * empty means no reduction
+   */
+  LevelVector reduceCombinationDimsLmax;
+
+  /** weights of the per-rank hierarchization exchange and reduce volume in the cost */
+  double hierarchizationWeight = 1.;
+  double reduceWeight = 1.;
+};
+
+/**
+ * @brief a parallelization vector and the resulting decomposition, with the predicted volumes;
+ * all volumes are counted in grid elements and summed over all component grids
+ */
+struct DecompositionPlan {
+  std::vector<int> parallelization;
+
+  /** as expected by CombiParameters::setDecomposition, on the lmax grid */
+  std::vector<IndexVector> decomposition;
+
+  /**
+   * elements received from the neighbors in the distributed (de-)hierarchization; per rank,
+   * this is an upper bound (the maximum in each dimension is taken independently)
+   */
+  IndexType hierarchizationMaxPerRank = 0;
+  IndexType hierarchizationTotal = 0;
+
+  /**
+   * sparse grid size per rank, which is also each rank's volume in the global reduce
+   * (and the size of the sparse grid files written per rank)
+   */
+  IndexType sparseGridMaxPerRank = 0;
+  IndexType sparseGridMinPerRank = 0;
+  IndexType sparseGridTotal = 0;
+
+  double cost = 0.;
+
+  /** max / mean of the sparse grid size per rank, 1 is perfectly balanced */
+  double getSparseGridImbalance() const;
+
+  std::string toString() const;
+};
+
+/**
+ * @brief all parallelization vectors of numProcs processes that satisfy the options and give
+ * every process points on the lmin grids, in lexicographic order
+ */
+std::vector<std::vector<int>> getParallelizationCandidates(
+    const LevelVector& lmin, const std::vector<BoundaryType>& boundary, int numProcs,
+    const DecompositionPlannerOptions& options = DecompositionPlannerOptions());
+
+/**
+ * @brief predict the volumes of the combination pipeline for the parallelization p, for the
+ * component grids combinationLevels
+ */
+DecompositionPlan evaluateDecomposition(
+    const std::vector<LevelVector>& combinationLevels, const LevelVector& lmax,
+    const std::vector<BoundaryType>& boundary, const std::vector<int>& p,
+    const DecompositionPlannerOptions& options = DecompositionPlannerOptions());
+
+/**
+ * @brief evaluate all candidate parallelizations for numProcs processes per group
+ *
+ * @return the plans, the best (lowest cost) first; empty if no parallelization is possible
+ */
+std::vector<DecompositionPlan> planDecompositions(
+    const std::vector<LevelVector>& combinationLevels, const LevelVector& lmin,
+    const LevelVector& lmax, const std::vector<BoundaryType>& boundary, int numProcs,
+    const DecompositionPlannerOptions& options = DecompositionPlannerOptions());
+
+}  // namespace combigrid
@@ -0,0 +1,155 @@
+#include "utils/GridAllocator.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#ifdef __linux__
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace combigrid {
+
+namespace {
+
+GridMemoryPolicy& currentPolicy() {
+  static GridMemoryPolicy policy;
+  return policy;
+}
+
+#ifdef __linux__
+size_t getPageSize() {
+  static const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return pageSize;
+}
+
+/** the mask of the online NUMA nodes, as expected by mbind(2); empty if unknown */
+const std::vector<unsigned long>& getOnlineNodeMask() {
+  static const std::vector<unsigned long> mask = [] {
+    std::vector<unsigned long> nodeMask;
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string ranges;
+    if (!(online >> ranges)) return nodeMask;
+    // e.g. "0-3,5"
+    std::istringstream stream(ranges);
+    std::string range;
+    constexpr size_t bitsPerLong = 8 * sizeof(unsigned long);
+    while (std::getline(stream, range, ',')) {
+      const auto dash = range.find('-');
+      const auto first = std::stoul(range.substr(0, dash));
+      const auto last = dash == std::string::npos ? first : std::stoul(range.substr(dash + 1));
+      for (auto node = first; node <= last; ++node) {
+        if (nodeMask.size() <= node / bitsPerLong) nodeMask.resize(node / bitsPerLong + 1, 0);
+        nodeMask[node / bitsPerLong] |= 1UL << (node % bitsPerLong);
+      }
+    }
+    return nodeMask;
+  }();
+  return mask;
+}
+
+/** interleave the whole pages of the buffer, best effort: ignored if mbind fails */
+void interleavePages(void* pointer, size_t numBytes) {
+  const auto& nodeMask = getOnlineNodeMask();
+  if (nodeMask.empty()) return;
+  const auto pageSize = getPageSize();
+  const auto begin = (reinterpret_cast<uintptr_t>(pointer) + pageSize - 1) / pageSize * pageSize;
+  const auto end = (reinterpret_cast<uintptr_t>(pointer) + numBytes) / pageSize * pageSize;
+  if (end <= begin) return;
+  syscall(SYS_mbind, begin, end - begin, MPOL_INTERLEAVE, nodeMask.data(),
+          8 * sizeof(unsigned long) * nodeMask.size() + 1, 0);
+}
+
+/** write to each page with the thread that will (statically scheduled) work on it */
+void touchPages(void* pointer, size_t numBytes) {
+  auto bytes = static_cast<char*>(pointer);
+  const auto pageSize = static_cast<long long>(getPageSize());
+  const auto numPages = static_cast<long long>((numBytes + getPageSize() - 1) / getPageSize());
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif  // _OPENMP
+  for (long long page = 0; page < numPages; ++page) {
+    bytes[page * pageSize] = 0;
+  }
+}
+#endif  // __linux__
+
+}  // namespace
+
+GridMemoryPolicy GridMemoryPolicy::fromString(const std::string& options) {
+  GridMemoryPolicy policy;
+  std::istringstream stream(options);
+  std::string option;
+  while (std::getline(stream, option, ',')) {
+    option.erase(std::remove_if(option.begin(), option.end(), ::isspace), option.end());
+    if (option.empty()) {
+      continue;
+    } else if (option.rfind("align=", 0) == 0) {
+      policy.alignment = std::stoul(option.substr(6));
+    } else if (option == "hugepages") {
+      policy.hugePages = true;
+    } else if (option == "firsttouch") {
+      policy.numaPlacement = NUMAPlacement::firstTouch;
+    } else if (option == "interleave") {
+      policy.numaPlacement = NUMAPlacement::interleave;
+    } else {
+      throw std::invalid_argument("unknown grid memory option " + option);
+    }
+  }
+  if (policy.alignment < sizeof(void*) || (policy.alignment & (policy.alignment - 1)) != 0) {
+    throw std::invalid_argument("grid memory alignment has to be a power of two >= " +
+                                std::to_string(sizeof(void*)));
+  }
+  return policy;
+}
+
+std::string GridMemoryPolicy::toString() const {
+  std::string options = "align=" + std::to_string(alignment);
+  if (hugePages) options += ",hugepages";
+  if (numaPlacement == NUMAPlacement::firstTouch) options += ",firsttouch";
+  if (numaPlacement == NUMAPlacement::interleave) options += ",interleave";
+  return options;
+}
+
+void setGridMemoryPolicy(const GridMemoryPolicy& policy) { currentPolicy() = policy; }
+
+const GridMemoryPolicy& getGridMemoryPolicy() { return currentPolicy(); }
+
+namespace gridmemory {
+
+void* allocate(size_t numBytes) {
+  const auto& policy = getGridMemoryPolicy();
+  const bool hugePages = policy.hugePages && numBytes >= GridMemoryPolicy::hugePageSize;
+  // huge pages need to be aligned to the huge page size to be used for the whole buffer
+  const auto alignment =
+      hugePages ? std::max(policy.alignment, GridMemoryPolicy::hugePageSize) : policy.alignment;
+  void* pointer = nullptr;
+  if (posix_memalign(&pointer, alignment, std::max(numBytes, size_t(1))) != 0) {
+    throw std::bad_alloc();
+  }
+#ifdef __linux__
+  if (hugePages) {
+    madvise(pointer, numBytes, MADV_HUGEPAGE);
+  }
+  if (numBytes >= getPageSize()) {
+    if (policy.numaPlacement == GridMemoryPolicy::NUMAPlacement::interleave) {
+      interleavePages(pointer, numBytes);
+    } else if (policy.numaPlacement == GridMemoryPolicy::NUMAPlacement::firstTouch) {
+      touchPages(pointer, numBytes);
+    }
+  }
+#endif  // __linux__
+  return pointer;
+}
+
+void deallocate(void* pointer) noexcept { std::free(pointer); }
+
+}  // namespace gridmemory
+
+}  // namespace combigrid
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace combigrid {
+
+/**
+ * @brief how the large grid buffers (cf. GridVector) are allocated and placed in memory
+ */
+struct GridMemoryPolicy {
+  /** how the pages of a buffer are distributed over the NUMA domains */
+  enum class NUMAPlacement : uint8_t {
+    none,        // wherever the (usually single) initializing thread runs, the default
+    firstTouch,  // touch the pages with all OpenMP threads (static schedule) on allocation
+    interleave   // round robin over all NUMA domains, e.g. for buffers shared by all sockets
+  };
+
+  /** alignment of the buffers in bytes, a power of two of at least sizeof(void*) */
+  size_t alignment = 64;
+
+  /** back the buffers of at least hugePageSize bytes by transparent huge pages */
+  bool hugePages = false;
+
+  NUMAPlacement numaPlacement = NUMAPlacement::none;
+
+  static constexpr size_t hugePageSize = size_t(2) << 20;
+
+  /**
+   * @brief parses a comma-separated list of options, e.g. "align=4096,hugepages,interleave":
+   * align=<bytes>, hugepages, firsttouch, interleave; the empty string gives the default policy
+   *
+   * @throws std::invalid_argument for unknown options and invalid alignments
+   */
+  static GridMemoryPolicy fromString(const std::string& options);
+
+  std::string toString() const;
+};
+
+/**
+ * @brief sets the policy for all subsequent grid allocations of this process, e.g. from the
+ * parameter file before the grids are created (not thread-safe w.r.t. concurrent allocations)
+ */
+void setGridMemoryPolicy(const GridMemoryPolicy& policy);
+
+const GridMemoryPolicy& getGridMemoryPolicy();
+
+namespace gridmemory {
+
+/** allocates numBytes according to the current GridMemoryPolicy, throws std::bad_alloc */
+void* allocate(size_t numBytes);
+
+void deallocate(void* pointer) noexcept;
+
+}  // namespace gridmemory
+
+/**
+ * @brief stateless allocator for the grid containers, which follows the runtime GridMemoryPolicy
+ *
+ * All instances compare equal, as any buffer can be freed regardless of the policy it was
+ * allocated with.
+ */
+template <typename T>
+class GridAllocator {
+ public:
+  using value_type = T;
+
+  GridAllocator() noexcept = default;
+
+  template <typename U>
+  GridAllocator(const GridAllocator<U>&) noexcept {}
+
+  T* allocate(size_t n) {
+    if (n > std::numeric_limits<size_t>::max() / sizeof(T)) throw std::bad_array_new_length();
+    return static_cast<T*>(gridmemory::allocate(n * sizeof(T)));
+  }
+
+  void deallocate(T* pointer, size_t) noexcept { gridmemory::deallocate(pointer); }
+};
+
+template <typename T, typename U>
+inline bool operator==(const GridAllocator<T>&, const GridAllocator<U>&) noexcept {
+  return true;
+}
+
+template <typename T, typename U>
+inline bool operator!=(const GridAllocator<T>&, const GridAllocator<U>&) noexcept {
+  return false;
+}
+
+/** the container for full grid, sparse grid and communication buffer data */
+template <typename T>
+using GridVector = std::vector<T, GridAllocator<T>>;
+
+}  // namespace combigrid
@@ -1,27 +1,17 @@
 #include "utils/LevelSetUtils.hpp"
 
+#include <limits>
 #include <map>
 
 namespace combigrid {
-void getDownSetRecursively(combigrid::LevelVector const& l, combigrid::LevelVector fixedDimensions,
-                           std::vector<LevelVector>& downSet) {
-  if (fixedDimensions.size() == l.size()) {
-    downSet.push_back(fixedDimensions);
-  } else {
-    // for the whole range of values in dimension d
-    size_t d = fixedDimensions.size();
-    for (LevelType i = 1; i <= l[d]; ++i) {  // levels start at 1 here, in compliance with our
-                                             // definition of DistributedSparseGrid
-      auto moreDimensionsFixed = fixedDimensions;
-      moreDimensionsFixed.push_back(i);
-      getDownSetRecursively(l, moreDimensionsFixed, downSet);
-    }
-  }
-}
-
 std::vector<LevelVector> getDownSet(combigrid::LevelVector const& l) {
   std::vector<LevelVector> downSet;
-  getDownSetRecursively(l, LevelVector(), downSet);
+  size_t numLevels = 1;
+  for (const auto& l_i : l) {
+    numLevels *= static_cast<size_t>(std::max(l_i, static_cast<LevelType>(0)));
+  }
+  downSet.reserve(numLevels);
+  forEachLevelInDownSet(l, [&downSet](const LevelVector& level) { downSet.push_back(level); });
   return downSet;
 }
 
@@ -108,6 +98,73 @@ void createTruncatedHierarchicalLevelsRec(DimType dim, size_t n, LevelVector& l,
   }
 }
 
+bool isWithinMixedDimensionSums(const LevelVector& l, const LevelVector& lmin, size_t n) {
+  // the largest partial sum of (l - lmin) over any selection of at least two dimensions is
+  // either the sum of all positive differences, or the sum of the two largest differences
+  // (if less than two are positive) -- this replaces the check of all k-out-of-d selections
+  auto dimensionality = static_cast<DimType>(l.size());
+  if (dimensionality < 2) {
+    return true;
+  }
+  LevelType sumPositive = 0;
+  DimType numPositive = 0;
+  LevelType largest = std::numeric_limits<LevelType>::lowest();
+  LevelType secondLargest = std::numeric_limits<LevelType>::lowest();
+  for (DimType i = 0; i < dimensionality; ++i) {
+    auto diff = static_cast<LevelType>(l[i] - lmin[i]);
+    if (diff > 0) {
+      sumPositive = static_cast<LevelType>(sumPositive + diff);
+      ++numPositive;
+    }
+    if (diff > largest) {
+      secondLargest = largest;
+      largest = diff;
+    } else if (diff > secondLargest) {
+      secondLargest = diff;
+    }
+  }
+  auto largestPartialSum =
+      (numPositive >= 2) ? sumPositive : static_cast<LevelType>(largest + secondLargest);
+  return largestPartialSum <= static_cast<LevelType>(n);
+}
+
+void createTruncatedHierarchicalLevelsIteratively(size_t n, const LevelVector& lmax,
+                                                  const LevelVector& lmin,
+                                                  std::vector<LevelVector>& created) {
+  assert(lmax.size() == lmin.size());
+  auto dimensionality = static_cast<DimType>(lmax.size());
+  if (dimensionality == 0) {
+    return;
+  }
+  const auto hyperplaneSum = static_cast<LevelType>(combigrid::levelSum(lmin) + n);
+
+  // partialSums[d] is the sum of the entries l[0] ... l[d-1]
+  LevelVector partialSums(dimensionality + 1, 0);
+  LevelVector l(dimensionality, 0);
+  const auto lastDim = static_cast<DimType>(dimensionality - 1);
+  DimType dim = 0;
+  while (true) {
+    ++l[dim];
+    // iterate everything below hyperplane, and smallereq than lmax in every dim
+    if (l[dim] > std::min(lmax[dim], static_cast<LevelType>(hyperplaneSum - partialSums[dim]))) {
+      if (dim == 0) {
+        break;
+      }
+      --dim;
+      continue;
+    }
+    if (dim == lastDim) {
+      if (isWithinMixedDimensionSums(l, lmin, n)) {
+        created.push_back(l);
+      }
+    } else {
+      partialSums[dim + 1] = static_cast<LevelType>(partialSums[dim] + l[dim]);
+      ++dim;
+      l[dim] = 0;
+    }
+  }
+}
+
 void createTruncatedHierarchicalLevels(const LevelVector& lmax, const LevelVector& lmin,
                                        std::vector<LevelVector>& created) {
   assert(created.empty());
@@ -132,8 +189,7 @@ void createTruncatedHierarchicalLevels(const LevelVector& lmax, const LevelVecto
 
   LevelType n = minLevelDifference;
 
-  LevelVector l(dim);
-  createTruncatedHierarchicalLevelsRec(0, n, l, lmax, rlmin, created);
+  createTruncatedHierarchicalLevelsIteratively(n, lmax, rlmin, created);
 }
 
 }  // namespace combigrid
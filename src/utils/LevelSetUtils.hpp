@@ -1,5 +1,6 @@
 #pragma once
 
+#include <algorithm>
 #include <vector>
 
 #include "utils/LevelVector.hpp"
@@ -69,6 +70,34 @@ inline IndexType getNumDofHierarchical(const std::vector<LevelVector>& levelVect
   return numDof;
 }
 
+/**
+ * @brief number of points of the hierarchical level l_i that lie in the nodal index range
+ * [lower, upper) of a 1d grid of level nodalLevel, e.g. on one partition of a decomposition
+ *
+ * uses the same index layout as DistributedFullGrid::getNumPointsOnThisPartition, but needs no
+ * grid; summed over the whole grid, this is getNumDofHierarchical(l_i, boundary)
+ */
+inline IndexType getNumDofHierarchicalInRange(LevelType l_i, LevelType nodalLevel,
+                                              BoundaryType boundary, IndexType lower,
+                                              IndexType upper) {
+  assert(l_i > 0 && l_i <= nodalLevel);
+  const IndexType stride = (l_i == 1 && boundary > 0)
+                               ? powerOfTwoByBitshift(static_cast<LevelType>(nodalLevel - 1))
+                               : powerOfTwoByBitshift(static_cast<LevelType>(nodalLevel - l_i + 1));
+  IndexType offset = 0;
+  if (boundary > 0) {
+    offset = l_i == 1 ? 0 : powerOfTwoByBitshift(static_cast<LevelType>(nodalLevel - l_i));
+  } else {
+    offset = powerOfTwoByBitshift(static_cast<LevelType>(nodalLevel - l_i)) - 1;
+  }
+  upper = std::min(upper, getNumDofNodal(nodalLevel, boundary));
+  // number of points of this level with index below x
+  auto numBelow = [offset, stride](IndexType x) {
+    return x <= offset ? 0 : (x - 1 - offset) / stride + 1;
+  };
+  return upper <= lower ? 0 : numBelow(upper) - numBelow(lower);
+}
+
 template <typename T>
 inline bool isPowerOfTwo(const T& x) {
   return (x != 0) && ((x & (x - 1)) == 0);
@@ -77,6 +106,40 @@ inline bool isPowerOfTwo(const T& x) {
 // get downward closed set of a single LevelVector
 std::vector<LevelVector> getDownSet(combigrid::LevelVector const& l);
 
+/**
+ * @brief call f on every level vector in the downward closed set of l, in lexicographic order
+ *
+ * unlike getDownSet, this does not store the downward closed set; the level vector passed to f
+ * is updated in place and is only valid during the call
+ */
+template <typename Function>
+void forEachLevelInDownSet(const LevelVector& l, Function&& f) {
+  const auto dim = static_cast<DimType>(l.size());
+  for (const auto& l_i : l) {
+    if (l_i < 1) {  // levels start at 1 here, in compliance with our
+                    // definition of DistributedSparseGrid
+      return;
+    }
+  }
+  // iterate the box [1, l] like an odometer, last dimension fastest
+  LevelVector current(dim, 1);
+  while (true) {
+    f(static_cast<const LevelVector&>(current));
+    DimType d = dim;
+    while (true) {
+      if (d == 0) {
+        return;
+      }
+      --d;
+      if (current[d] < l[d]) {
+        ++current[d];
+        break;
+      }
+      current[d] = 1;
+    }
+  }
+}
+
 struct AllKOutOfDDimensions {
   /**
    * @brief Get all combinations of k out of d dimensions (from 0 to d-1)
@@ -106,6 +169,23 @@ void createTruncatedHierarchicalLevelsRec(DimType dim, size_t n, LevelVector& l,
                                           const LevelVector& lmax, const LevelVector& lmin,
                                           std::vector<LevelVector>& created);
 
+/**
+ * @brief check the mixed dimension sum restrictions of createTruncatedHierarchicalLevelsRec
+ *
+ * returns true if, for every selection of at least two dimensions, the sum of l does not
+ * exceed the sum of lmin plus n; runs in O(d) instead of O(2^d)
+ */
+bool isWithinMixedDimensionSums(const LevelVector& l, const LevelVector& lmin, size_t n);
+
+/**
+ * @brief iterative (non-recursive, copy-free) equivalent of createTruncatedHierarchicalLevelsRec
+ *
+ * appends the levels to created in lexicographic order
+ */
+void createTruncatedHierarchicalLevelsIteratively(size_t n, const LevelVector& lmax,
+                                                  const LevelVector& lmin,
+                                                  std::vector<LevelVector>& created);
+
 void createTruncatedHierarchicalLevels(const LevelVector& lmax, const LevelVector& lmin,
                                        std::vector<LevelVector>& created);
 
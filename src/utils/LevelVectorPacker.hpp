@@ -0,0 +1,89 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "utils/LevelVector.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief encodes a LevelVector into a single 64-bit key
+ *
+ * Each dimension gets a fixed-width bit field, with dimension 0 in the most significant
+ * bits, such that the numeric order of the keys is the lexicographic order of the level
+ * vectors (the same order as in std::set<LevelVector>).
+ * The field width is chosen such that maxLevel + 1 still fits, so that incrementing the level
+ * in one dimension never carries into the neighboring field.
+ */
+class LevelVectorPacker {
+ public:
+  typedef uint64_t KeyType;
+
+  LevelVectorPacker(DimType dim, LevelType maxLevel) : dim_(dim), bitsPerDim_(0) {
+    assert(dim > 0);
+    assert(maxLevel >= 0);
+    while ((static_cast<LevelType>(1) << bitsPerDim_) <= maxLevel + 1) {
+      ++bitsPerDim_;
+    }
+    fieldMask_ = (static_cast<KeyType>(1) << bitsPerDim_) - 1;
+    shifts_.resize(dim_);
+    for (DimType d = 0; d < dim_; ++d) {
+      shifts_[d] = static_cast<uint8_t>(bitsPerDim_ * (dim_ - 1 - d));
+    }
+  }
+
+  /**
+   * @brief whether a level vector of this dimensionality and maximum level fits into a key
+   */
+  inline bool fits() const { return static_cast<unsigned int>(bitsPerDim_) * dim_ <= 64; }
+
+  inline KeyType pack(const LevelVector& l) const {
+    assert(fits());
+    assert(l.size() == dim_);
+    KeyType key = 0;
+    for (DimType d = 0; d < dim_; ++d) {
+      assert(l[d] >= 0 && static_cast<KeyType>(l[d]) <= fieldMask_);
+      key |= static_cast<KeyType>(l[d]) << shifts_[d];
+    }
+    return key;
+  }
+
+  inline void unpack(KeyType key, LevelVector& l) const {
+    l.resize(dim_);
+    for (DimType d = 0; d < dim_; ++d) {
+      l[d] = static_cast<LevelType>((key >> shifts_[d]) & fieldMask_);
+    }
+  }
+
+  inline LevelVector unpack(KeyType key) const {
+    LevelVector l(dim_);
+    unpack(key, l);
+    return l;
+  }
+
+  inline LevelType getLevel(KeyType key, DimType d) const {
+    return static_cast<LevelType>((key >> shifts_[d]) & fieldMask_);
+  }
+
+  /**
+   * @brief the key difference corresponding to a level increment by one in dimension d
+   */
+  inline KeyType unitIncrement(DimType d) const { return static_cast<KeyType>(1) << shifts_[d]; }
+
+  inline DimType getDimension() const { return dim_; }
+
+  inline uint8_t getBitsPerDimension() const { return bitsPerDim_; }
+
+ private:
+  DimType dim_;
+
+  uint8_t bitsPerDim_;
+
+  KeyType fieldMask_;
+
+  std::vector<uint8_t> shifts_;
+};
+
+}  // namespace combigrid
@@ -0,0 +1,104 @@
+#pragma once
+
+// to resolve https://github.com/open-mpi/ompi/issues/5157
+#define OMPI_SKIP_MPICXX 1
+#include <mpi.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <map>
+#include <vector>
+
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/** maximum, 1 and 2 norm, in this order (cf. DistributedFullGrid::getLpNorm with p = 0, 1, 2) */
+using LpNorms = std::array<real, 3>;
+
+/** the norms requested with a single EVAL_NORM_BUNDLE signal, cf. NormBundleType */
+struct NormBundle {
+  std::map<size_t, LpNorms> taskNorms;  // by task ID
+  LpNorms combined = {0., 0., 0.};
+  LpNorms analytical = {0., 0., 0.};
+  LpNorms error = {0., 0., 0.};
+};
+
+/**
+ * @brief accumulates the maximum, 1 and 2 norm of a grid function from its nodal values in a
+ * single pass; the partial results of all processes, for any number of accumulators, are then
+ * combined with a single reduction
+ */
+class LpNormAccumulator {
+ public:
+  /**
+   * @param absValue the absolute value at a grid point
+   * @param hatFunctionIntegral the integral of the point's nodal hat function relative to an
+   * inner one, i.e. 1/2 per dimension in which the point is on the boundary
+   */
+  inline void add(real absValue, real hatFunctionIntegral) {
+    partial_[0] = std::max(partial_[0], absValue);
+    partial_[1] += absValue * hatFunctionIntegral;
+    partial_[2] += absValue * absValue * hatFunctionIntegral;
+  }
+
+  /** combine the accumulators of all processes in comm (same number and order everywhere) */
+  static void allreduce(std::vector<LpNormAccumulator>& accumulators, CommunicatorType comm) {
+    static_assert(sizeof(LpNormAccumulator) == 3 * sizeof(real),
+                  "accumulators are reduced as contiguous triples of reals");
+    MPI_Allreduce(MPI_IN_PLACE, accumulators.data(), static_cast<int>(accumulators.size()),
+                  getMPIDatatype(), getMaxSumSumOp(), comm);
+  }
+
+  /**
+   * @param innerNodalBasisFunctionIntegral the integral of an inner nodal hat function, i.e.
+   * the product of the grid spacings
+   */
+  inline LpNorms getNorms(real innerNodalBasisFunctionIntegral) const {
+    return {partial_[0], partial_[1] * innerNodalBasisFunctionIntegral,
+            std::sqrt(partial_[2] * innerNodalBasisFunctionIntegral *
+                      innerNodalBasisFunctionIntegral)};
+  }
+
+ private:
+  /** one accumulator as an MPI datatype, created and committed on first use */
+  static MPI_Datatype getMPIDatatype() {
+    static const MPI_Datatype accumulatorType = [] {
+      MPI_Datatype type;
+      MPI_Type_contiguous(
+          3, abstraction::getMPIDatatype(abstraction::getabstractionDataType<real>()), &type);
+      MPI_Type_commit(&type);
+      return type;
+    }();
+    return accumulatorType;
+  }
+
+  /** the reduction operation on accumulators, created on first use */
+  static MPI_Op getMaxSumSumOp() {
+    static const MPI_Op maxSumSum = [] {
+      MPI_Op op;
+      MPI_Op_create(&reduceMaxSumSum, 1, &op);
+      return op;
+    }();
+    return maxSumSum;
+  }
+
+  // *len is the number of accumulators, each a triple of reals
+  static void reduceMaxSumSum(void* in, void* inout, int* len, MPI_Datatype*) {
+    const auto* inAccumulators = static_cast<const LpNormAccumulator*>(in);
+    auto* inoutAccumulators = static_cast<LpNormAccumulator*>(inout);
+    for (int i = 0; i < *len; ++i) {
+      auto& inoutPartial = inoutAccumulators[i].partial_;
+      const auto& inPartial = inAccumulators[i].partial_;
+      inoutPartial[0] = std::max(inoutPartial[0], inPartial[0]);
+      inoutPartial[1] += inPartial[1];
+      inoutPartial[2] += inPartial[2];
+    }
+  }
+
+  // maximum, sum of absolute values and of squares, weighted by the hat function integrals
+  std::array<real, 3> partial_ = {0., 0., 0.};
+};
+
+}  // namespace combigrid
@@ -0,0 +1,70 @@
+#include "utils/MemoryTracker.hpp"
+
+#include <cassert>
+
+namespace combigrid {
+
+std::array<std::atomic<size_t>, MemoryTracker::numCategories> MemoryTracker::currentBytes_{};
+std::array<std::atomic<size_t>, MemoryTracker::numCategories> MemoryTracker::peakBytes_{};
+
+void MemoryTracker::allocate(MemoryCategory category, size_t numBytes) {
+  auto c = static_cast<size_t>(category);
+  assert(c < numCategories);
+  auto current = currentBytes_[c].fetch_add(numBytes, std::memory_order_relaxed) + numBytes;
+  auto peak = peakBytes_[c].load(std::memory_order_relaxed);
+  while (current > peak &&
+         !peakBytes_[c].compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+  }
+}
+
+void MemoryTracker::deallocate(MemoryCategory category, size_t numBytes) {
+  auto c = static_cast<size_t>(category);
+  assert(c < numCategories);
+  assert(currentBytes_[c].load(std::memory_order_relaxed) >= numBytes);
+  currentBytes_[c].fetch_sub(numBytes, std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getCurrentBytes(MemoryCategory category) {
+  return currentBytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+size_t MemoryTracker::getPeakBytes(MemoryCategory category) {
+  return peakBytes_[static_cast<size_t>(category)].load(std::memory_order_relaxed);
+}
+
+void MemoryTracker::resetPeaks() {
+  for (size_t c = 0; c < numCategories; ++c) {
+    peakBytes_[c].store(currentBytes_[c].load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+  }
+}
+
+std::string MemoryTracker::getCategoryName(MemoryCategory category) {
+  switch (category) {
+    case MemoryCategory::fullGrids:
+      return "full grids";
+    case MemoryCategory::sparseGrids:
+      return "sparse grids";
+    case MemoryCategory::kahanData:
+      return "kahan data";
+    case MemoryCategory::thirdLevelSparseGrids:
+      return "third level sparse grids";
+    case MemoryCategory::communicationBuffers:
+      return "communication buffers";
+    case MemoryCategory::checkpoints:
+      return "checkpoints";
+    default:
+      return "unknown";
+  }
+}
+
+std::vector<uint64_t> MemoryTracker::getReport() {
+  std::vector<uint64_t> report(2 * numCategories);
+  for (size_t c = 0; c < numCategories; ++c) {
+    report[2 * c] = getCurrentBytes(static_cast<MemoryCategory>(c));
+    report[2 * c + 1] = getPeakBytes(static_cast<MemoryCategory>(c));
+  }
+  return report;
+}
+
+}  // namespace combigrid
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace combigrid {
+
+/**
+ * @brief the kinds of large buffers whose memory is accounted for by the MemoryTracker
+ */
+enum class MemoryCategory : uint8_t {
+  fullGrids = 0,          // data of the DistributedFullGrids
+  sparseGrids,            // subspace data of the DistributedSparseGridUniforms
+  kahanData,              // Kahan summation residuals of the DistributedSparseGridUniforms
+  thirdLevelSparseGrids,  // subspace data of the extra third level DistributedSparseGridUniforms
+  communicationBuffers,   // buffers for remote data, e.g. in hierarchization or third level
+  checkpoints,            // in-memory buddy checkpoints of the full grids (cf. BuddyCheckpoint)
+  numCategories
+};
+
+/**
+ * @brief per-process bookkeeping of the bytes allocated for each MemoryCategory,
+ * without the need to scrape /proc or to synchronize (cf. mpimemory)
+ */
+class MemoryTracker {
+ public:
+  static constexpr size_t numCategories = static_cast<size_t>(MemoryCategory::numCategories);
+
+  static void allocate(MemoryCategory category, size_t numBytes);
+
+  static void deallocate(MemoryCategory category, size_t numBytes);
+
+  static size_t getCurrentBytes(MemoryCategory category);
+
+  static size_t getPeakBytes(MemoryCategory category);
+
+  /**
+   * @brief set the peaks to the current values, e.g. to measure a single phase
+   */
+  static void resetPeaks();
+
+  static std::string getCategoryName(MemoryCategory category);
+
+  /**
+   * @brief current and peak bytes of all categories, as
+   * [current_0, peak_0, current_1, peak_1, ...]
+   */
+  static std::vector<uint64_t> getReport();
+
+ private:
+  static std::array<std::atomic<size_t>, numCategories> currentBytes_;
+  static std::array<std::atomic<size_t>, numCategories> peakBytes_;
+};
+
+/**
+ * @brief the memory report of a process group, summed and maximized over its ranks
+ */
+struct MemoryReport {
+  std::array<uint64_t, MemoryTracker::numCategories> currentBytesSum{};
+  std::array<uint64_t, MemoryTracker::numCategories> peakBytesSum{};
+  std::array<uint64_t, MemoryTracker::numCategories> currentBytesMax{};
+  std::array<uint64_t, MemoryTracker::numCategories> peakBytesMax{};
+};
+
+/**
+ * @brief accounts for the size of a single buffer in the MemoryTracker, to be kept next to
+ * the buffer and updated whenever it is (re)allocated
+ */
+class TrackedMemory {
+ public:
+  explicit TrackedMemory(MemoryCategory category) : category_(category), numBytes_(0) {}
+
+  TrackedMemory(const TrackedMemory& other) : category_(other.category_), numBytes_(0) {
+    setNumBytes(other.numBytes_);
+  }
+
+  TrackedMemory(TrackedMemory&& other) noexcept
+      : category_(other.category_), numBytes_(other.numBytes_) {
+    other.numBytes_ = 0;
+  }
+
+  TrackedMemory& operator=(const TrackedMemory& other) {
+    if (this != &other) {
+      setNumBytes(0);
+      category_ = other.category_;
+      setNumBytes(other.numBytes_);
+    }
+    return *this;
+  }
+
+  TrackedMemory& operator=(TrackedMemory&& other) noexcept {
+    if (this != &other) {
+      setNumBytes(0);
+      category_ = other.category_;
+      numBytes_ = other.numBytes_;
+      other.numBytes_ = 0;
+    }
+    return *this;
+  }
+
+  ~TrackedMemory() { setNumBytes(0); }
+
+  inline void setNumBytes(size_t numBytes) {
+    if (numBytes > numBytes_) {
+      MemoryTracker::allocate(category_, numBytes - numBytes_);
+    } else if (numBytes < numBytes_) {
+      MemoryTracker::deallocate(category_, numBytes_ - numBytes);
+    }
+    numBytes_ = numBytes;
+  }
+
+  /**
+   * @brief track the capacity of a std::vector (with any allocator, e.g. a GridVector)
+   */
+  template <typename T, typename Allocator>
+  inline void track(const std::vector<T, Allocator>& buffer) {
+    setNumBytes(buffer.capacity() * sizeof(T));
+  }
+
+  /**
+   * @brief move the tracked bytes to another category
+   */
+  inline void setCategory(MemoryCategory category) {
+    auto numBytes = numBytes_;
+    setNumBytes(0);
+    category_ = category;
+    setNumBytes(numBytes);
+  }
+
+  inline MemoryCategory getCategory() const { return category_; }
+
+  inline size_t getNumBytes() const { return numBytes_; }
+
+ private:
+  MemoryCategory category_;
+
+  size_t numBytes_;
+};
+
+}  // namespace combigrid
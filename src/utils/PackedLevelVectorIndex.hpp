@@ -0,0 +1,194 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "utils/LevelVector.hpp"
+#include "utils/LevelVectorPacker.hpp"
+#include "utils/Types.hpp"
+
+namespace combigrid {
+
+/**
+ * @brief compact storage of a sorted list of level vectors with O(1) lookup of their positions
+ *
+ * The level vectors are stored as packed 64-bit keys (cf. LevelVectorPacker), and their positions
+ * are found through an open-addressing hash table with linear probing.
+ * If the level vectors are too large to be packed, they are stored as they are and looked up by
+ * binary search.
+ *
+ * @tparam PositionType the (signed) type used to index the list; -1 denotes "not contained"
+ */
+template <typename PositionType>
+class PackedLevelVectorIndex {
+ public:
+  typedef LevelVectorPacker::KeyType KeyType;
+
+  PackedLevelVectorIndex() : maxLevel_(0), packer_(1, 0) {}
+
+  /**
+   * @param levels the level vectors, sorted and unique
+   */
+  explicit PackedLevelVectorIndex(const std::vector<LevelVector>& levels)
+      : maxLevel_(getMaximumLevel(levels)),
+        packer_(levels.empty() ? 1 : static_cast<DimType>(levels[0].size()), maxLevel_) {
+    assert(std::is_sorted(levels.begin(), levels.end()));
+    assert(std::adjacent_find(levels.begin(), levels.end()) == levels.end());
+    if (levels.size() > static_cast<size_t>(std::numeric_limits<PositionType>::max())) {
+      throw std::runtime_error("number of level vectors exceeds the maximum position type");
+    }
+    if (!packer_.fits()) {
+      unpackedLevels_ = levels;
+      return;
+    }
+    keys_.reserve(levels.size());
+    for (const auto& l : levels) {
+      keys_.push_back(packer_.pack(l));
+    }
+    buildHashTable();
+  }
+
+  inline size_t size() const { return isPacked() ? keys_.size() : unpackedLevels_.size(); }
+
+  inline bool empty() const { return size() == 0; }
+
+  inline bool isPacked() const { return unpackedLevels_.empty(); }
+
+  inline void getLevelVector(PositionType i, LevelVector& l) const {
+    assert(i >= 0 && static_cast<size_t>(i) < size());
+    if (isPacked()) {
+      packer_.unpack(keys_[i], l);
+    } else {
+      l = unpackedLevels_[i];
+    }
+  }
+
+  inline LevelVector getLevelVector(PositionType i) const {
+    LevelVector l;
+    getLevelVector(i, l);
+    return l;
+  }
+
+  std::vector<LevelVector> getAllLevelVectors() const {
+    if (!isPacked()) {
+      return unpackedLevels_;
+    }
+    std::vector<LevelVector> levels(keys_.size());
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      packer_.unpack(keys_[i], levels[i]);
+    }
+    return levels;
+  }
+
+  /**
+   * @brief get the position of l in the list, or -1 if it is not contained
+   */
+  inline PositionType find(const LevelVector& l) const {
+    if (!isPacked()) {
+      auto found = std::lower_bound(unpackedLevels_.cbegin(), unpackedLevels_.cend(), l);
+      if (found != unpackedLevels_.cend() && *found == l) {
+        return static_cast<PositionType>(std::distance(unpackedLevels_.cbegin(), found));
+      }
+      return -1;
+    }
+    if (keys_.empty() || l.size() != packer_.getDimension()) {
+      return -1;
+    }
+    for (const auto& l_i : l) {
+      // levels outside of the packable range cannot be contained
+      if (l_i < 0 || l_i > maxLevel_) {
+        return -1;
+      }
+    }
+    return findKey(packer_.pack(l));
+  }
+
+  inline PositionType findKey(KeyType key) const {
+    assert(isPacked());
+    if (slots_.empty()) {
+      return -1;
+    }
+    auto slot = hash(key);
+    while (slots_[slot] != -1) {
+      if (keys_[slots_[slot]] == key) {
+        return slots_[slot];
+      }
+      slot = (slot + 1) & slotMask_;
+    }
+    return -1;
+  }
+
+  inline const LevelVectorPacker& getPacker() const { return packer_; }
+
+  void clear() {
+    keys_.clear();
+    keys_.shrink_to_fit();
+    slots_.clear();
+    slots_.shrink_to_fit();
+    unpackedLevels_.clear();
+    unpackedLevels_.shrink_to_fit();
+  }
+
+  /**
+   * @brief the number of bytes allocated for the level vectors and the lookup table
+   */
+  size_t getNumBytes() const {
+    size_t numBytes = keys_.capacity() * sizeof(KeyType) + slots_.capacity() * sizeof(PositionType);
+    for (const auto& l : unpackedLevels_) {
+      numBytes += sizeof(LevelVector) + l.capacity() * sizeof(LevelType);
+    }
+    return numBytes;
+  }
+
+ private:
+  static LevelType getMaximumLevel(const std::vector<LevelVector>& levels) {
+    LevelType maxLevel = 0;
+    for (const auto& l : levels) {
+      for (const auto& l_i : l) {
+        maxLevel = std::max(maxLevel, l_i);
+      }
+    }
+    return maxLevel;
+  }
+
+  inline size_t hash(KeyType key) const {
+    // Fibonacci hashing, uses the high bits of the product
+    return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> hashShift_);
+  }
+
+  void buildHashTable() {
+    // keep the load factor at or below one half
+    uint8_t numBits = 1;
+    while ((static_cast<size_t>(1) << numBits) < 2 * keys_.size()) {
+      ++numBits;
+    }
+    slots_.assign(static_cast<size_t>(1) << numBits, -1);
+    slotMask_ = slots_.size() - 1;
+    hashShift_ = static_cast<uint8_t>(64 - numBits);
+    for (size_t i = 0; i < keys_.size(); ++i) {
+      auto slot = hash(keys_[i]);
+      while (slots_[slot] != -1) {
+        slot = (slot + 1) & slotMask_;
+      }
+      slots_[slot] = static_cast<PositionType>(i);
+    }
+  }
+
+  LevelType maxLevel_;
+
+  LevelVectorPacker packer_;
+
+  std::vector<KeyType> keys_;  // packed level vectors, sorted
+
+  std::vector<PositionType> slots_;  // open-addressing table of positions in keys_, -1 if empty
+
+  size_t slotMask_ = 0;
+
+  uint8_t hashShift_ = 63;
+
+  std::vector<LevelVector> unpackedLevels_;  // only used if the levels do not fit into a key
+};
+
+}  // namespace combigrid
@@ -9,5 +9,10 @@ Stats::time_point Stats::partially_written_until_;
 size_t Stats::numWrites_ = 0;
 std::unordered_map<std::string, std::vector<Stats::Event>> Stats::event_;
 std::unordered_map<std::string, std::string> Stats::attributes_;
+constexpr size_t Stats::traceBufferSize;
+std::mutex Stats::traceMutex_;
+std::vector<std::unique_ptr<Stats::TraceBuffer>> Stats::traceBuffers_;
+std::vector<std::string> Stats::eventNames_;
+std::unordered_map<std::string, Stats::EventHandle> Stats::eventHandles_;
 }
 // end namespace combigrid
@@ -7,9 +7,13 @@
 #include <mpi.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <fstream>
 #include <iostream>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <unordered_map>
@@ -17,6 +21,7 @@
 
 #include "io/MPIInputOutput.hpp"
 #include "mpi/MPISystem.hpp"
+#include "utils/MemoryTracker.hpp"
 
 namespace combigrid {
 
@@ -31,6 +36,39 @@ class Stats {
     Event() : start(std::chrono::high_resolution_clock::now()) {}
   };
 
+  /**
+   * interned event name, obtain once through internEvent and reuse
+   */
+  typedef uint32_t EventHandle;
+
+  /**
+   * a begin/end pair of a scoped event, as it is kept in the per-thread ring buffer
+   */
+  struct TraceRecord {
+    EventHandle handle;
+    uint32_t depth;      // number of enclosing scopes on this thread
+    int64_t parent;      // sequence number of the enclosing scope, -1 if there is none
+    int64_t sequence;    // running number of this record on this thread
+    int64_t startNanos;  // time since clock epoch
+    int64_t endNanos;    // 0 as long as the scope is open
+  };
+
+  /**
+   * the number of scoped events each thread keeps; older ones are overwritten
+   */
+  static constexpr size_t traceBufferSize = 1 << 16;
+
+  /**
+   * RAII wrapper for beginScope / endScope
+   */
+  class ScopedEvent {
+   public:
+    explicit ScopedEvent(EventHandle handle) { Stats::beginScope(handle); }
+    ~ScopedEvent() { Stats::endScope(); }
+    ScopedEvent(const ScopedEvent&) = delete;
+    ScopedEvent& operator=(const ScopedEvent&) = delete;
+  };
+
   static long unsigned int getEventDuration(const Stats::Event e){
     std::chrono::milliseconds x = std::chrono::duration_cast<std::chrono::milliseconds>(e.end - e.start);
     return x.count();
@@ -72,6 +110,39 @@ class Stats {
    */
   static long unsigned int getDuration(const std::string& name);
 
+  /**
+   * get the handle for the event name, registering the name if necessary;
+   * the name lookup is done only here, not when the event is recorded
+   */
+  static EventHandle internEvent(const std::string& name);
+
+  /**
+   * get the name an event handle was interned for
+   */
+  static std::string getEventName(EventHandle handle);
+
+  /**
+   * start a scoped event on the calling thread, nested in the currently open one (if any);
+   * does not allocate, cf. the STATS_SCOPED_EVENT macro
+   */
+  static void beginScope(EventHandle handle);
+
+  /**
+   * stop the innermost scoped event of the calling thread
+   */
+  static void endScope();
+
+  /**
+   * get the scoped events recorded by the calling thread that are still in its ring buffer,
+   * oldest first
+   */
+  static std::vector<TraceRecord> getTraceRecords();
+
+  /**
+   * get the number of scoped events the calling thread had to overwrite in its ring buffer
+   */
+  static size_t getNumDroppedTraceRecords();
+
   /**
    * set an attribute which can later be used for plotting
    */
@@ -90,7 +161,112 @@ class Stats {
   static void writePartial(const std::string& pathPrefix,
                            CommunicatorType comm = theMPISystem()->getWorldComm());
 
+  /**
+   * write both the scoped and the named events in Chrome trace event format (as understood by
+   * chrome://tracing and Perfetto) to specified path, one process per rank and one track
+   * per thread; only call this when no other thread is recording
+   */
+  static void writeChromeTrace(const std::string& path,
+                               CommunicatorType comm = theMPISystem()->getWorldComm());
+
  private:
+  class TraceBuffer {
+   public:
+    explicit TraceBuffer(int threadIndex) : records_(traceBufferSize), threadIndex_(threadIndex) {
+      // nesting deeper than this will allocate
+      openScopes_.reserve(64);
+    }
+
+    inline void begin(EventHandle handle, int64_t now) {
+      auto& record = records_[numRecorded_ % traceBufferSize];
+      record.handle = handle;
+      record.depth = static_cast<uint32_t>(openScopes_.size());
+      record.parent = openScopes_.empty() ? -1 : openScopes_.back();
+      record.sequence = numRecorded_;
+      record.startNanos = now;
+      record.endNanos = 0;
+      openScopes_.push_back(numRecorded_++);
+    }
+
+    inline void end(int64_t now) {
+      assert(!openScopes_.empty());
+      auto sequence = openScopes_.back();
+      openScopes_.pop_back();
+      // the record may already have been overwritten by its children
+      if (numRecorded_ - sequence <= static_cast<int64_t>(traceBufferSize)) {
+        records_[sequence % traceBufferSize].endNanos = now;
+      }
+    }
+
+    std::vector<TraceRecord> getRecords() const {
+      std::vector<TraceRecord> records;
+      auto first = std::max(static_cast<int64_t>(0),
+                            numRecorded_ - static_cast<int64_t>(traceBufferSize));
+      records.reserve(static_cast<size_t>(numRecorded_ - first));
+      for (auto sequence = first; sequence < numRecorded_; ++sequence) {
+        records.push_back(records_[sequence % traceBufferSize]);
+      }
+      return records;
+    }
+
+    size_t getNumDropped() const {
+      return static_cast<size_t>(std::max(static_cast<int64_t>(0),
+                                          numRecorded_ - static_cast<int64_t>(traceBufferSize)));
+    }
+
+    int getThreadIndex() const { return threadIndex_; }
+
+    void clear() {
+      numRecorded_ = 0;
+      openScopes_.clear();
+    }
+
+   private:
+    std::vector<TraceRecord> records_;
+    std::vector<int64_t> openScopes_;
+    int64_t numRecorded_ = 0;
+    int threadIndex_;
+  };
+
+  // current and peak bytes per category of the MemoryTracker
+  static void writeMemoryReport(std::ostream& buffer) {
+    buffer << "\"memory\":{" << std::endl;
+    for (size_t c = 0; c < MemoryTracker::numCategories; ++c) {
+      auto category = static_cast<MemoryCategory>(c);
+      buffer << "\"" << MemoryTracker::getCategoryName(category) << "\":["
+             << MemoryTracker::getCurrentBytes(category) << ","
+             << MemoryTracker::getPeakBytes(category) << "]";
+      if (c + 1 != MemoryTracker::numCategories) {
+        buffer << "," << std::endl;
+      } else {
+        buffer << std::endl;
+      }
+    }
+    buffer << "}," << std::endl;
+  }
+
+  static inline int64_t nowInNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::high_resolution_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static TraceBuffer& getThreadTraceBuffer() {
+    // registered on first use by each thread, owned by traceBuffers_
+    thread_local TraceBuffer* buffer = nullptr;
+    if (buffer == nullptr) {
+      std::lock_guard<std::mutex> lock(traceMutex_);
+      traceBuffers_.emplace_back(new TraceBuffer(static_cast<int>(traceBuffers_.size())));
+      buffer = traceBuffers_.back().get();
+    }
+    return *buffer;
+  }
+
+  static std::mutex traceMutex_;
+  static std::vector<std::unique_ptr<TraceBuffer>> traceBuffers_;
+  static std::vector<std::string> eventNames_;
+  static std::unordered_map<std::string, EventHandle> eventHandles_;
+
   static bool initialized_;
   static bool finalized_;
   static time_point init_time_;
@@ -107,6 +283,12 @@ inline void Stats::initialize() {
   // clear data (in case of multiple calls to initialize, e.g. in tests)
   event_.clear();
   attributes_.clear();
+  {
+    std::lock_guard<std::mutex> lock(traceMutex_);
+    for (auto& buffer : traceBuffers_) {
+      buffer->clear();
+    }
+  }
 
   initialized_ = true;
   finalized_ = false;
@@ -162,6 +344,7 @@ inline void Stats::write(const std::string& path, CommunicatorType comm) {
       }
     }
     buffer << "}," << std::endl;
+    writeMemoryReport(buffer);
 
     buffer << "\"events\":{" << std::endl;
     std::size_t event_count = 0;
@@ -229,6 +412,7 @@ inline void Stats::writePartial(const std::string& pathSuffix, CommunicatorType
       }
     }
     buffer << "}," << std::endl;
+    writeMemoryReport(buffer);
     buffer << "\"events\":{" << std::endl;
     std::stringstream allEventsBuffer;
     bool anyEventFirstTime = true;
@@ -277,6 +461,86 @@ inline void Stats::writePartial(const std::string& pathSuffix, CommunicatorType
   partially_written_until_ = std::chrono::high_resolution_clock::now();
 }
 
+inline void Stats::beginScope(EventHandle handle) {
+  getThreadTraceBuffer().begin(handle, nowInNanos());
+}
+
+inline void Stats::endScope() { getThreadTraceBuffer().end(nowInNanos()); }
+
+inline void Stats::writeChromeTrace(const std::string& path, CommunicatorType comm) {
+  std::string myJSONpart = "";
+  {
+    MPI_Barrier(comm);
+
+    using namespace std::chrono;
+    int rank = getCommRank(comm);
+    int size = getCommSize(comm);
+    auto initNanos = duration_cast<nanoseconds>(init_time_.time_since_epoch()).count();
+    auto toMicros = [initNanos](int64_t nanos) {
+      return static_cast<double>(nanos - initNanos) * 1e-3;
+    };
+
+    std::stringstream buffer;
+    buffer << std::fixed;
+    buffer.precision(3);
+
+    if (rank == 0) {
+      buffer << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << std::endl;
+    }
+    // every rank writes at least its process name, so the separators are always needed
+    buffer << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+           << ",\"args\":{\"name\":\"rank" << rank << "\"}}";
+
+    // named events go to their own track, as they may overlap
+    const int namedEventsTid = 0;
+    buffer << "," << std::endl
+           << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank
+           << ",\"tid\":" << namedEventsTid << ",\"args\":{\"name\":\"named events\"}}";
+    for (const auto& t : event_) {
+      for (const auto& e : t.second) {
+        if (e.end <= e.start) continue;
+        buffer << "," << std::endl
+               << "{\"name\":\"" << t.first << "\",\"cat\":\"named\",\"ph\":\"X\",\"pid\":"
+               << rank << ",\"tid\":" << namedEventsTid
+               << ",\"ts\":" << toMicros(duration_cast<nanoseconds>(e.start.time_since_epoch()).count())
+               << ",\"dur\":" << static_cast<double>(duration_cast<nanoseconds>(e.end - e.start).count()) * 1e-3
+               << "}";
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(traceMutex_);
+    for (const auto& traceBuffer : traceBuffers_) {
+      auto tid = traceBuffer->getThreadIndex() + 1;
+      buffer << "," << std::endl
+             << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"tid\":" << tid
+             << ",\"args\":{\"name\":\"thread" << traceBuffer->getThreadIndex()
+             << " scopes\",\"dropped\":" << traceBuffer->getNumDropped() << "}}";
+      auto records = traceBuffer->getRecords();
+      for (const auto& record : records) {
+        // skip scopes that are still open
+        if (record.endNanos == 0) continue;
+        buffer << "," << std::endl
+               << "{\"name\":\"" << eventNames_[record.handle]
+               << "\",\"cat\":\"scoped\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":" << tid
+               << ",\"ts\":" << toMicros(record.startNanos)
+               << ",\"dur\":" << static_cast<double>(record.endNanos - record.startNanos) * 1e-3
+               << ",\"args\":{\"depth\":" << record.depth << ",\"parent\":" << record.parent
+               << ",\"id\":" << record.sequence << "}}";
+      }
+    }
+
+    if (rank != size - 1) {
+      buffer << "," << std::endl;
+    } else {
+      buffer << std::endl << "]}" << std::endl;
+    }
+    myJSONpart = buffer.str();
+  }
+  bool success =
+      mpiio::writeValuesConsecutive<char>(myJSONpart.data(), myJSONpart.size(), path, comm);
+  assert(success);
+}
+
 #else
 inline void Stats::initialize() {}
 inline void Stats::finalize() {}
@@ -286,8 +550,36 @@ inline void Stats::startEvent(const std::string& name) {
 inline void Stats::setAttribute(const std::string& name, const std::string& value) {}
 inline void Stats::write(const std::string& path, CommunicatorType comm) {}
 inline void Stats::writePartial(const std::string& pathSuffix, CommunicatorType comm) {}
+inline void Stats::beginScope(EventHandle handle) {}
+inline void Stats::endScope() {}
+inline void Stats::writeChromeTrace(const std::string& path, CommunicatorType comm) {}
 #endif
 
+inline Stats::EventHandle Stats::internEvent(const std::string& name) {
+  std::lock_guard<std::mutex> lock(traceMutex_);
+  auto found = eventHandles_.find(name);
+  if (found != eventHandles_.end()) {
+    return found->second;
+  }
+  auto handle = static_cast<EventHandle>(eventNames_.size());
+  eventNames_.push_back(name);
+  eventHandles_[name] = handle;
+  return handle;
+}
+
+inline std::string Stats::getEventName(EventHandle handle) {
+  std::lock_guard<std::mutex> lock(traceMutex_);
+  return eventNames_.at(handle);
+}
+
+inline std::vector<Stats::TraceRecord> Stats::getTraceRecords() {
+  return getThreadTraceBuffer().getRecords();
+}
+
+inline size_t Stats::getNumDroppedTraceRecords() {
+  return getThreadTraceBuffer().getNumDropped();
+}
+
 inline const Stats::Event Stats::stopEvent(const std::string& name) {
   // check if event is not stopped already
   assert(event_[name].back().end.time_since_epoch().count() == 0);
@@ -313,4 +605,18 @@ inline long unsigned int Stats::getDuration(const std::string& name) {
 }  // namespace combigrid
 // end namespace combigrid
 
+#define STATS_CONCATENATE_DETAIL(x, y) x##y
+#define STATS_CONCATENATE(x, y) STATS_CONCATENATE_DETAIL(x, y)
+
+/**
+ * time the enclosing scope as a nested event; the name is interned on first execution
+ * (it has to be the same every time the line is executed)
+ */
+#define STATS_SCOPED_EVENT(name)                                                     \
+  static const combigrid::Stats::EventHandle STATS_CONCATENATE(statsEventHandle_, \
+                                                               __LINE__) =           \
+      combigrid::Stats::internEvent(name);                                           \
+  combigrid::Stats::ScopedEvent STATS_CONCATENATE(statsScopedEvent_, __LINE__)(      \
+      STATS_CONCATENATE(statsEventHandle_, __LINE__))
+
 #endif /* STATS_HPP_ */
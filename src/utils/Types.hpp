@@ -57,6 +57,18 @@ namespace combigrid {
   // it is easily enough to fit the largest subspace (19,1,1,1,1,1) in the current scenario
   // (= 2^19 * 3 * 3 * 3 * 3 * 3 = 2^19 * 3^5 = 127401984)
   typedef uint32_t SubspaceSizeType;
+
+  // the real type of a (possibly complex) grid element type, for the scalar factors of operations
+  // on the grids (e.g. std::complex<float> cannot be multiplied by a double)
+  template <typename FG_ELEMENT>
+  struct RealTypeOf {
+    typedef FG_ELEMENT type;
+  };
+
+  template <typename T>
+  struct RealTypeOf<std::complex<T>> {
+    typedef T type;
+  };
   }  // namespace combigrid
 
 namespace abstraction {
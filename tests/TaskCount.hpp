@@ -3,6 +3,9 @@
 #define BOOST_TEST_DYN_LINK
 
 #include <boost/serialization/export.hpp>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
 #include "task/Task.hpp"
 
 using namespace combigrid;
@@ -49,7 +52,7 @@ class TaskCount : public combigrid::Task {
     }
     dfg_ = new DistributedFullGrid<CombiDataType>(getDim(), getLevelVector(), lcomm, getBoundary(), p, false, decomposition);
 
-    std::vector<CombiDataType>& elements = dfg_->getElementVector();
+    auto& elements = dfg_->getElementVector();
     for (auto& element : elements) {
       element = -0.;
     }
@@ -123,3 +126,88 @@ class TaskCount : public combigrid::Task {
     // ar& nprocs_;
   }
 };
+
+/* like TaskCount, but the tasks with odd IDs hold their grid in single precision, to test runs
+ * with mixed element types
+ */
+class TaskCountMixedPrecision : public combigrid::Task {
+ public:
+  TaskCountMixedPrecision(const LevelVector& l, const std::vector<BoundaryType>& boundary,
+                          real coeff, LoadModel* loadModel)
+      : Task(l, boundary, coeff, loadModel), nrun_(0) {}
+
+  bool isSinglePrecision() const override { return getID() % 2 == 1; }
+
+  void init(CommunicatorType lcomm, std::vector<IndexVector> decomposition) override {
+    std::vector<int> p;
+    if (decomposition.size() == 0) {
+      p = {getCommSize(lcomm), 1};
+    } else {
+      for (const auto& d : decomposition) {
+        p.push_back(static_cast<int>(d.size()));
+      }
+    }
+    if (isSinglePrecision()) {
+      singlePrecisionDfg_.reset(new DistributedFullGrid<SinglePrecisionDataType>(
+          getDim(), getLevelVector(), lcomm, getBoundary(), p, false, decomposition));
+    } else {
+      dfg_.reset(new DistributedFullGrid<CombiDataType>(getDim(), getLevelVector(), lcomm,
+                                                        getBoundary(), p, false, decomposition));
+    }
+    visitDistributedFullGrid([](auto& dfg) {
+      for (auto& element : dfg.getElementVector()) {
+        element = -0.;
+      }
+    });
+    nrun_ = 0;
+  }
+
+  void run(CommunicatorType lcomm) override {
+    // increase each value by sum( (d_i+1) * x_i), in the grid's precision
+    visitDistributedFullGrid([this](auto& dfg) {
+      TestFnCount<std::remove_reference_t<decltype(*dfg.getData())>> f;
+      for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+        std::vector<double> coords(getDim());
+        dfg.getCoordsLocal(li, coords);
+        dfg.getData()[li] += f(coords);
+      }
+    });
+    ++nrun_;
+    setFinished(true);
+    MPI_Barrier(lcomm);
+  }
+
+  void getFullGrid(FullGrid<CombiDataType>& fg, RankType r, CommunicatorType lcomm,
+                   int n = 0) override {
+    getDistributedFullGrid(n).gatherFullGrid(fg, r);
+  }
+
+  DistributedFullGrid<CombiDataType>& getDistributedFullGrid(int n = 0) override {
+    if (isSinglePrecision()) {
+      throw std::runtime_error("TaskCountMixedPrecision: task is single precision");
+    }
+    return *dfg_;
+  }
+
+  DistributedFullGrid<SinglePrecisionDataType>& getSinglePrecisionDistributedFullGrid(
+      int n = 0) override {
+    if (!isSinglePrecision()) {
+      throw std::runtime_error("TaskCountMixedPrecision: task is not single precision");
+    }
+    return *singlePrecisionDfg_;
+  }
+
+  void setZero() override {}
+
+  CombiDataType analyticalSolution(const std::vector<real>& coords, int n = 0) const override {
+    TestFnCount<CombiDataType> f;
+    return f(coords, nrun_);
+  }
+
+ private:
+  std::unique_ptr<DistributedFullGrid<CombiDataType>> dfg_;
+
+  std::unique_ptr<DistributedFullGrid<SinglePrecisionDataType>> singlePrecisionDfg_;
+
+  size_t nrun_;
+};
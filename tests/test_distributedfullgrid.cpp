@@ -4,6 +4,7 @@
 #include <mpi.h>
 
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <complex>
 #include <cstdarg>
 #include <iostream>
@@ -11,8 +12,11 @@
 #include <vector>
 
 #include "TaskConstParaboloid.hpp"
+#include "combicom/CombiCom.hpp"
 #include "fullgrid/DistributedFullGrid.hpp"
 #include "fullgrid/FullGrid.hpp"
+#include "fullgrid/HaloExchange.hpp"
+#include "fullgrid/StencilSweep.hpp"
 #include "hierarchization/DistributedHierarchization.hpp"
 #include "io/H5InputOutput.hpp"
 #include "mpi/MPIMemory.hpp"
@@ -242,6 +246,11 @@ void checkDistributedFullgrid(LevelVector& levels, std::vector<int>& procs,
   // lazy for the two-norm, just check boundedness relations:
   BOOST_CHECK(twonorm <= onenorm);
   BOOST_CHECK(onenorm <= maxnorm);
+  // the fused computation gives the same norms
+  auto lpNorms = dfg.getLpNorms();
+  BOOST_CHECK_EQUAL(lpNorms[0], maxnorm);
+  BOOST_CHECK_CLOSE(lpNorms[1], onenorm, TestHelper::tolerance);
+  BOOST_CHECK_CLOSE(lpNorms[2], twonorm, TestHelper::tolerance);
 
   // test ghost layer exchange
   std::vector<int> subarrayExtents;
@@ -279,6 +288,63 @@ void checkDistributedFullgrid(LevelVector& levels, std::vector<int>& procs,
     }
   }
 
+  // test persistent halo exchange, in all dimensions and directions at once
+  IndexType minLocalSize =
+      *std::min_element(dfg.getLocalSizes().begin(), dfg.getLocalSizes().end());
+  MPI_Allreduce(MPI_IN_PLACE, &minLocalSize, 1, MPI_INT64_T, MPI_MIN, comm);
+  for (IndexType ghostWidth = 1; ghostWidth <= std::min(minLocalSize, IndexType(2)); ++ghostWidth) {
+    HaloExchange<std::complex<double>> halo(dfg, ghostWidth);
+    BOOST_CHECK_EQUAL(halo.getGhostWidth(), ghostWidth);
+    // twice, to reuse the requests
+    for (int repetition = 0; repetition < 2; ++repetition) {
+      halo.start();
+      BOOST_CHECK(halo.isActive());
+      halo.finish();
+      for (DimType d = 0; d < dim; ++d) {
+        const auto& offsets = halo.getGhostLayerOffsets(d);
+        if (ghostWidth == 1) {
+          // same as the blocking exchange
+          auto ghostLayer = dfg.exchangeGhostLayerUpward(d, subarrayExtents);
+          BOOST_CHECK(halo.getLowerGhostLayer(d) == ghostLayer);
+        }
+        for (bool upper : {false, true}) {
+          const auto& layer = upper ? halo.getUpperGhostLayer(d) : halo.getLowerGhostLayer(d);
+          BOOST_CHECK_EQUAL(layer.empty(),
+                            upper ? !halo.hasHigherNeighbor(d) : !halo.hasLowerNeighbor(d));
+          for (size_t j = 0; j < layer.size(); ++j) {
+            IndexVector locAxisIndex(dim), globAxisIndex(dim);
+            IndexType tmp = j;
+            for (int i = static_cast<int>(dim) - 1; i >= 0; i--) {
+              locAxisIndex[i] = tmp / offsets[i];
+              tmp = tmp % offsets[i];
+            }
+            BOOST_CHECK(locAxisIndex[d] < ghostWidth);
+            dfg.getGlobalVectorIndex(locAxisIndex, globAxisIndex);
+            globAxisIndex[d] += upper ? dfg.getLocalSizes()[d] : -ghostWidth;
+            // wrap around
+            if (globAxisIndex[d] < 0) globAxisIndex[d] += dfg.length(d);
+            if (globAxisIndex[d] >= dfg.length(d)) globAxisIndex[d] -= dfg.length(d);
+            std::vector<double> coords(dim);
+            dfg.getCoordsGlobal(dfg.getGlobalLinearIndex(globAxisIndex), coords);
+            BOOST_CHECK_EQUAL(layer[j], f(coords));
+          }
+        }
+      }
+    }
+    // double-buffered like in a time stepping: one set of send requests per buffer
+    std::vector<std::vector<std::complex<double>>> lowerGhostLayers(dim);
+    for (DimType d = 0; d < dim; ++d) lowerGhostLayers[d] = halo.getLowerGhostLayer(d);
+    auto otherBuffer = dfg.getElementVector();
+    for (int step = 0; step < 4; ++step) {
+      dfg.getElementVector().swap(otherBuffer);
+      halo.exchange();
+      for (DimType d = 0; d < dim; ++d) {
+        BOOST_CHECK(halo.getLowerGhostLayer(d) == lowerGhostLayers[d]);
+      }
+    }
+    BOOST_CHECK_EQUAL(halo.getNumSendRequestSets(), 2);
+  }
+
   // test gatherFullgrid
   FullGrid<std::complex<double>> fg(dim, levels, boundary);
   dfg.gatherFullGrid(fg, 0);
@@ -1225,11 +1291,237 @@ BOOST_AUTO_TEST_CASE(test_evalDFG) {
                           TestHelper::tolerance);
         BOOST_CHECK_CLOSE(stepWiseInterpolatedValues[i], 1., TestHelper::tolerance);
       }
+
+      // the batched local evaluation gives the same values
+      std::vector<real> batchValues(interpolationCoords.size());
+      dfg.evalLocal(interpolationCoords, batchValues);
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        BOOST_CHECK_CLOSE(batchValues[i], dfg.evalLocal(interpolationCoords[i]),
+                          TestHelper::tolerance);
+      }
+
+      // only the coordinates with local support are returned by evalLocalContributions
+      std::vector<size_t> contributingIndices;
+      std::vector<real> contributions;
+      dfg.evalLocalContributions(interpolationCoords, contributingIndices, contributions);
+      BOOST_CHECK_EQUAL(contributingIndices.size(), contributions.size());
+      BOOST_CHECK(std::is_sorted(contributingIndices.begin(), contributingIndices.end()));
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        auto localValue = dfg.evalLocal(interpolationCoords[i]);
+        auto found = std::lower_bound(contributingIndices.begin(), contributingIndices.end(), i);
+        if (found != contributingIndices.end() && *found == i) {
+          BOOST_CHECK_CLOSE(contributions[std::distance(contributingIndices.begin(), found)],
+                            localValue, TestHelper::tolerance);
+        } else {
+          BOOST_CHECK_EQUAL(localValue, 0.);
+        }
+      }
       MPI_Barrier(comm);
     }
   }
 }
 
+BOOST_AUTO_TEST_CASE(test_evalLocalBatch) {
+  // multilinear functions are interpolated exactly, also by the kernel without compile-time
+  // dimension (dim > 6)
+  for (DimType dim : {1, 2, 3, 4, 6, 7}) {
+    std::vector<int> procs(dim, 1);
+    CommunicatorType comm = TestHelper::getComm(procs);
+    if (comm != MPI_COMM_NULL) {
+      LevelVector level(dim, static_cast<LevelType>(dim < 4 ? 5 : 2));
+      std::vector<BoundaryType> boundary(dim, 2);
+      DistributedFullGrid<real> dfg(dim, level, comm, boundary, procs, false);
+      auto multilinear = [](const std::vector<real>& coords) {
+        real result = 1.;
+        for (DimType d = 0; d < coords.size(); ++d) result *= 1. + (d + 1) * coords[d];
+        return result;
+      };
+      std::vector<real> coords(dim);
+      for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+        dfg.getCoordsLocal(li, coords);
+        dfg.getData()[li] = multilinear(coords);
+      }
+      auto interpolationCoords = montecarlo::getRandomCoordinates(100000, dim);
+      std::vector<real> values(interpolationCoords.size());
+      auto start = std::chrono::high_resolution_clock::now();
+      dfg.evalLocal(interpolationCoords, values);
+      auto end = std::chrono::high_resolution_clock::now();
+      auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+      BOOST_TEST_MESSAGE("batched evalLocal, dim " << static_cast<int>(dim) << ": "
+                                                   << duration.count() << " us for "
+                                                   << interpolationCoords.size() << " points");
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        BOOST_CHECK_CLOSE(values[i], multilinear(interpolationCoords[i]), TestHelper::tolerance);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_igatherFullGrid) {
+  std::vector<int> procs = {2, 2};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm != MPI_COMM_NULL) {
+    DimType dim = 2;
+    LevelVector levels = {4, 3};
+    std::vector<BoundaryType> boundary(dim, 2);
+    DistributedFullGrid<real> dfg(dim, levels, comm, boundary, procs, false);
+    auto f = [](const std::vector<real>& coords) { return coords[0] + 10. * coords[1]; };
+    std::vector<real> coords(dim);
+    for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+      dfg.getCoordsLocal(li, coords);
+      dfg.getData()[li] = f(coords);
+    }
+    const auto rank = TestHelper::getRank(comm);
+    const auto size = getCommSize(comm);
+
+    // gather repeatedly to different roots, reusing the subarray types
+    for (RankType root : {0, 3, 0}) {
+      FullGrid<real> fg(dim, levels, boundary);
+      MPI_Request request = dfg.igatherFullGrid(fg, root);
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+      if (rank == root) {
+        for (IndexType i = 0; i < fg.getNrElements(); ++i) {
+          fg.getCoords(i, coords);
+          BOOST_CHECK_CLOSE(fg.getData()[i], f(coords), TestHelper::tolerance);
+        }
+      }
+    }
+
+    // reduce full grids with rank + 1 everywhere
+    FullGrid<real> fg(dim, levels, boundary);
+    fg.createFullGrid();
+    std::fill(fg.getElementVector().begin(), fg.getElementVector().end(), rank + 1.);
+    MPI_Request request = CombiCom::FGIreduce(fg, 1, comm);
+    MPI_Wait(&request, MPI_STATUS_IGNORE);
+    if (rank == 1) {
+      for (const auto& value : fg.getElementVector()) {
+        BOOST_CHECK_EQUAL(value, size * (size + 1) / 2.);
+      }
+    }
+    std::fill(fg.getElementVector().begin(), fg.getElementVector().end(), rank + 1.);
+    CombiCom::FGAllreduce(fg, comm);
+    for (const auto& value : fg.getElementVector()) {
+      BOOST_CHECK_EQUAL(value, size * (size + 1) / 2.);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_stencilSweep) {
+  std::vector<int> procs = {2, 1, 2};
+  for (bool periodic : {true, false}) {
+    CommunicatorType comm = TestHelper::getComm(procs, std::vector<int>(3, periodic ? 1 : 0));
+    if (comm == MPI_COMM_NULL) continue;
+    DimType dim = 3;
+    LevelVector levels = {3, 2, 3};
+    std::vector<BoundaryType> boundary(dim, periodic ? 1 : 2);
+    DistributedFullGrid<real> dfg(dim, levels, comm, boundary, procs, false);
+    // exact in floating point, and different for all points
+    auto u = [](const IndexVector& globAxisIndex) {
+      return globAxisIndex[0] + 100. * globAxisIndex[1] + 10000. * globAxisIndex[2];
+    };
+    IndexVector locAxisIndex(dim), globAxisIndex(dim);
+    for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+      dfg.getLocalVectorIndex(li, locAxisIndex);
+      dfg.getGlobalVectorIndex(locAxisIndex, globAxisIndex);
+      dfg.getData()[li] = u(globAxisIndex);
+    }
+
+    const real centerWeight = 1.5;
+    std::vector<StencilTap<real>> taps = {{0, -1, 0.5}, {0, 2, 0.25}, {1, -1, -1.},
+                                          {1, 1, 2.},   {2, -2, 0.125}, {2, 1, 3.}};
+    HaloExchange<real> halo(dfg, 2);
+    StencilSweep<real> sweep(dfg, centerWeight, taps);
+    GridVector<real> out;
+    sweep.apply(halo, out);
+    BOOST_REQUIRE_EQUAL(out.size(), dfg.getNrLocalElements());
+
+    for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+      dfg.getLocalVectorIndex(li, locAxisIndex);
+      dfg.getGlobalVectorIndex(locAxisIndex, globAxisIndex);
+      real expected = centerWeight * u(globAxisIndex);
+      for (const auto& tap : taps) {
+        auto neighbor = globAxisIndex;
+        neighbor[tap.d] += tap.offset;
+        if (neighbor[tap.d] < 0 || neighbor[tap.d] >= dfg.length(tap.d)) {
+          if (!periodic) {
+            // Dirichlet: copied
+            expected = u(globAxisIndex);
+            break;
+          }
+          neighbor[tap.d] = (neighbor[tap.d] + dfg.length(tap.d)) % dfg.length(tap.d);
+        }
+        expected += tap.weight * u(neighbor);
+      }
+      BOOST_CHECK_EQUAL(out[li], expected);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_wrapExternalData) {
+  std::vector<int> procs = {2, 2};
+  CommunicatorType comm = TestHelper::getComm(procs, {1, 1});
+  if (comm != MPI_COMM_NULL) {
+    DimType dim = 2;
+    LevelVector levels = {4, 3};
+    std::vector<BoundaryType> boundary(dim, 1);
+    DistributedFullGrid<real> owned(dim, levels, comm, boundary, procs, false);
+    // the "application's" buffer
+    std::vector<real> buffer(owned.getNrLocalElements());
+    DistributedFullGrid<real> wrapped(dim, levels, comm, boundary, procs, false, {}, nullptr,
+                                      buffer.data());
+    BOOST_CHECK(wrapped.hasExternalData());
+    BOOST_CHECK(!owned.hasExternalData());
+    BOOST_CHECK_EQUAL(wrapped.getData(), buffer.data());
+    BOOST_CHECK_EQUAL(wrapped.getNrLocalElements(), owned.getNrLocalElements());
+
+    auto f = [](const std::vector<double>& coords) {
+      return std::sin(2. * M_PI * coords[0]) + coords[1] * coords[1];
+    };
+    std::vector<double> coords(dim);
+    for (IndexType li = 0; li < owned.getNrLocalElements(); ++li) {
+      owned.getCoordsLocal(li, coords);
+      owned.getData()[li] = f(coords);
+      buffer[li] = f(coords);
+    }
+    auto initialValues = buffer;
+
+    std::vector<bool> dims(dim, true);
+    DistributedHierarchization::hierarchizeHierachicalBasis<real>(owned, dims);
+    DistributedHierarchization::hierarchizeHierachicalBasis<real>(wrapped, dims);
+    for (IndexType li = 0; li < owned.getNrLocalElements(); ++li) {
+      BOOST_CHECK_EQUAL(buffer[li], owned.getData()[li]);
+    }
+    BOOST_CHECK_EQUAL(wrapped.getLpNorm(0), owned.getLpNorm(0));
+    BOOST_CHECK_EQUAL(wrapped.getLpNorm(2), owned.getLpNorm(2));
+
+    // to the sparse grid and back, in place (lmin = lmax, so all subspaces are contained)
+    DistributedSparseGridUniform<real> dsg(dim, levels, levels, comm);
+    dsg.registerDistributedFullGrid(wrapped);
+    dsg.setZero();
+    dsg.addDistributedFullGrid(wrapped, 1.);
+    wrapped.setZero();
+    BOOST_CHECK_EQUAL(buffer[0], 0.);
+    wrapped.extractFromUniformSG(dsg);
+    for (IndexType li = 0; li < owned.getNrLocalElements(); ++li) {
+      BOOST_CHECK_EQUAL(buffer[li], owned.getData()[li]);
+    }
+
+    DistributedHierarchization::dehierarchizeHierachicalBasis<real>(wrapped, dims);
+    for (IndexType li = 0; li < owned.getNrLocalElements(); ++li) {
+      BOOST_TEST(buffer[li] == initialValues[li],
+                 boost::test_tools::tolerance(TestHelper::tolerance));
+    }
+
+    // an owning grid can be switched to external data, too
+    std::vector<real> otherBuffer(buffer);
+    owned.wrapExternalData(otherBuffer.data());
+    BOOST_CHECK(owned.hasExternalData());
+    BOOST_CHECK_EQUAL(owned.getData(), otherBuffer.data());
+    owned.mul(2.);
+    BOOST_CHECK_EQUAL(otherBuffer[0], 2. * buffer[0]);
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_massLoss2D) {
   std::vector<int> procs = {1, 1};
   CommunicatorType comm = TestHelper::getComm(procs);
@@ -8,18 +8,27 @@
 #include <complex>
 #include <cstdarg>
 #include <iostream>
+#include <numeric>
 #include <random>
+#include <set>
 #include <vector>
 
 #include "TaskConstParaboloid.hpp"
 #include "combicom/CombiCom.hpp"
 #include "combischeme/CombiMinMaxScheme.hpp"
 #include "fullgrid/FullGrid.hpp"
+#include "hierarchization/DistributedHierarchization.hpp"
 #include "manager/CombiParameters.hpp"
+#include "mpi/MPICartesianUtils.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 #include "sparsegrid/SGrid.hpp"
+#include "utils/DecompositionPlanner.hpp"
+#include "utils/GridAllocator.hpp"
 #include "utils/IndexVector.hpp"
 #include "utils/LevelSetUtils.hpp"
+#include "utils/MemoryTracker.hpp"
+#include "utils/MonteCarlo.hpp"
+#include "utils/PackedLevelVectorIndex.hpp"
 #include "utils/Types.hpp"
 #include "test_helper.hpp"
 
@@ -48,11 +57,12 @@ void checkDistributedSparsegrid(LevelVector& lmin, LevelVector& lmax, std::vecto
     auto uniDSG = std::unique_ptr<DistributedSparseGridUniform<std::complex<double>>>(
         new DistributedSparseGridUniform<std::complex<double>>(dim, lmax, lmin, comm));
 
+    const auto allLevelVectors = uniDSG->getAllLevelVectors();
     for (const auto& corner : cornersOfScheme) {
       // make sure corners are part of the scheme
-      BOOST_CHECK(std::find(uniDSG->getAllLevelVectors().begin(),
-                            uniDSG->getAllLevelVectors().end(),
-                            corner) != uniDSG->getAllLevelVectors().end());
+      BOOST_CHECK(std::find(allLevelVectors.begin(), allLevelVectors.end(), corner) !=
+                  allLevelVectors.end());
+      BOOST_CHECK(uniDSG->isContained(corner));
       // and higher neighbors of corner are not part of the scheme
       for (DimType d = 0; d < dim; ++d) {
         auto neighbor = corner;
@@ -61,14 +71,13 @@ void checkDistributedSparsegrid(LevelVector& lmin, LevelVector& lmax, std::vecto
         stringStream << "corner: " << corner << " neighbor: " << neighbor;
         BOOST_TEST_CONTEXT(stringStream.str());
         if (schemeIsRegular) {
-          BOOST_CHECK(std::find(uniDSG->getAllLevelVectors().begin(),
-                                uniDSG->getAllLevelVectors().end(),
-                                neighbor) == uniDSG->getAllLevelVectors().end());
+          BOOST_CHECK(std::find(allLevelVectors.begin(), allLevelVectors.end(), neighbor) ==
+                      allLevelVectors.end());
+          BOOST_CHECK(!uniDSG->isContained(neighbor));
 
         } else {
-          BOOST_WARN(std::find(uniDSG->getAllLevelVectors().begin(),
-                               uniDSG->getAllLevelVectors().end(),
-                               neighbor) == uniDSG->getAllLevelVectors().end());
+          BOOST_WARN(std::find(allLevelVectors.begin(), allLevelVectors.end(), neighbor) ==
+                     allLevelVectors.end());
         }
       }
     }
@@ -634,6 +643,645 @@ BOOST_AUTO_TEST_CASE(test_createSubspacesSingleLevel_large) {
   BOOST_CHECK(std::is_sorted(created.begin(), created.end()));
 }
 
+BOOST_AUTO_TEST_CASE(test_createTruncatedHierarchicalLevelsIteratively) {
+  std::vector<std::pair<LevelVector, LevelVector>> lminAndLmax = {
+      {{1}, {6}},
+      {{2, 2}, {6, 6}},
+      {{1, 2, 3}, {5, 5, 5}},
+      {{2, 2, 2, 2}, {4, 5, 6, 7}},
+      {{3, 1, 2, 1, 2}, {6, 5, 6, 5, 4}},
+  };
+  for (const auto& [lmin, lmax] : lminAndLmax) {
+    LevelVector ldiff = lmax - lmin;
+    auto n = static_cast<size_t>(*std::min_element(ldiff.begin(), ldiff.end()));
+    LevelVector rlmin(lmax.size());
+    for (size_t i = 0; i < rlmin.size(); ++i) {
+      rlmin[i] = static_cast<LevelType>(lmax[i] - n);
+    }
+    std::vector<LevelVector> createdRecursively;
+    LevelVector l(lmax.size());
+    combigrid::createTruncatedHierarchicalLevelsRec(0, n, l, lmax, rlmin, createdRecursively);
+    std::vector<LevelVector> created;
+    combigrid::createTruncatedHierarchicalLevelsIteratively(n, lmax, rlmin, created);
+    BOOST_CHECK_EQUAL(created.size(), createdRecursively.size());
+    BOOST_CHECK(created == createdRecursively);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_getDownSet) {
+  LevelVector level = {3, 1, 4, 2};
+  auto downSet = getDownSet(level);
+  BOOST_CHECK_EQUAL(downSet.size(),
+                    std::accumulate(level.begin(), level.end(), 1, std::multiplies<LevelType>()));
+  BOOST_CHECK(std::is_sorted(downSet.begin(), downSet.end()));
+  BOOST_CHECK(std::adjacent_find(downSet.begin(), downSet.end()) == downSet.end());
+  BOOST_CHECK(downSet.front() == LevelVector(level.size(), 1));
+  BOOST_CHECK(downSet.back() == level);
+  for (const auto& subspace : downSet) {
+    BOOST_CHECK(subspace <= level);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_computeCombiCoeffsAdaptive) {
+  // for a regular scheme, the adaptive coefficients need to match the classical ones
+  for (DimType dim = 1; dim < 6; ++dim) {
+    LevelVector lmin(dim, 2);
+    LevelVector lmax(dim, 6);
+    CombiMinMaxScheme classicalScheme(dim, lmin, lmax);
+    classicalScheme.createClassicalCombischeme();
+    CombiMinMaxScheme adaptiveScheme(dim, lmin, lmax);
+    adaptiveScheme.createAdaptiveCombischeme();
+    std::map<LevelVector, real> classicalCoefficients;
+    for (size_t i = 0; i < classicalScheme.getCombiSpaces().size(); ++i) {
+      classicalCoefficients[classicalScheme.getCombiSpaces()[i]] = classicalScheme.getCoeffs()[i];
+    }
+    BOOST_CHECK_EQUAL(adaptiveScheme.getCombiSpaces().size(), classicalCoefficients.size());
+    for (size_t i = 0; i < adaptiveScheme.getCombiSpaces().size(); ++i) {
+      const auto& space = adaptiveScheme.getCombiSpaces()[i];
+      BOOST_REQUIRE(classicalCoefficients.find(space) != classicalCoefficients.end());
+      BOOST_CHECK_EQUAL(adaptiveScheme.getCoeffs()[i], classicalCoefficients[space]);
+    }
+  }
+  // for anisotropic schemes, the coefficients sum to one and the down set is the union of
+  // the active grids' down sets
+  std::vector<std::pair<LevelVector, LevelVector>> lminAndLmax = {
+      {{2, 2, 2}, {4, 6, 8}},
+      {{1, 2, 1, 2}, {5, 6, 4, 6}},
+      {{2, 2, 2, 2, 2, 2}, {6, 6, 6, 6, 6, 6}},
+  };
+  for (const auto& [lmin, lmax] : lminAndLmax) {
+    auto dim = static_cast<DimType>(lmin.size());
+    CombiMinMaxScheme scheme(dim, lmin, lmax);
+    scheme.createAdaptiveCombischeme();
+    const auto& coeffs = scheme.getCoeffs();
+    BOOST_CHECK_EQUAL(std::accumulate(coeffs.begin(), coeffs.end(), 0.), 1.);
+    BOOST_CHECK(std::find(coeffs.begin(), coeffs.end(), 0.) == coeffs.end());
+
+    std::set<LevelVector> expectedDownSet;
+    for (size_t i = 0; i < coeffs.size(); ++i) {
+      if (coeffs[i] == 1.) {
+        auto gridDownSet = getDownSet(scheme.getCombiSpaces()[i]);
+        expectedDownSet.insert(gridDownSet.begin(), gridDownSet.end());
+      }
+    }
+    scheme.createDownSet();
+    const auto& downSet = scheme.getDownSet();
+    BOOST_CHECK_EQUAL(downSet.size(), expectedDownSet.size());
+    BOOST_CHECK(std::equal(downSet.begin(), downSet.end(), expectedDownSet.begin()));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_createAdaptiveCombischeme_large) {
+  // scaling of scheme setup over dimension and lmax, only reported on rank 0
+  if (TestHelper::getRank(MPI_COMM_WORLD) != 0) {
+    return;
+  }
+  for (DimType dim = 2; dim <= 6; ++dim) {
+    for (LevelType maxLevel : {6, 10, 14}) {
+      LevelVector lmin(dim, 2);
+      LevelVector lmax(dim, maxLevel);
+      auto start = std::chrono::high_resolution_clock::now();
+      CombiMinMaxScheme scheme(dim, lmin, lmax);
+      scheme.createAdaptiveCombischeme();
+      auto afterScheme = std::chrono::high_resolution_clock::now();
+      scheme.createDownSet();
+      auto end = std::chrono::high_resolution_clock::now();
+      auto schemeDuration =
+          std::chrono::duration_cast<std::chrono::milliseconds>(afterScheme - start);
+      auto downSetDuration = std::chrono::duration_cast<std::chrono::milliseconds>(end - afterScheme);
+      BOOST_TEST_MESSAGE("dim " << static_cast<int>(dim) << " lmax " << maxLevel << ": "
+                                << scheme.getCombiSpaces().size() << " component grids in "
+                                << schemeDuration.count() << " milliseconds, "
+                                << scheme.getDownSet().size() << " subspaces in down set in "
+                                << downSetDuration.count() << " milliseconds");
+      const auto& coeffs = scheme.getCoeffs();
+      BOOST_CHECK_EQUAL(std::accumulate(coeffs.begin(), coeffs.end(), 0.), 1.);
+#ifdef NDEBUG
+      BOOST_CHECK(schemeDuration.count() < 10000);
+#endif
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_PackedLevelVectorIndex) {
+  // one index that packs and one that needs to fall back to unpacked level vectors
+  std::vector<std::vector<LevelVector>> levelLists(2);
+  combigrid::createTruncatedHierarchicalLevels({6, 5, 7, 6}, {2, 2, 2, 2}, levelLists[0]);
+  // 13 dimensions with five bits each do not fit into a key
+  for (LevelType l_0 : {1, 7, 15}) {
+    for (LevelType l_1 : {1, 3}) {
+      for (LevelType l_12 : {1, 2, 15}) {
+        LevelVector l(13, 1);
+        l[0] = l_0;
+        l[1] = l_1;
+        l[12] = l_12;
+        levelLists[1].push_back(l);
+      }
+    }
+  }
+  std::sort(levelLists[1].begin(), levelLists[1].end());
+
+  for (const auto& levels : levelLists) {
+    PackedLevelVectorIndex<int32_t> index(levels);
+    BOOST_CHECK_EQUAL(index.isPacked(), levels[0].size() < 13);
+    BOOST_CHECK_EQUAL(index.size(), levels.size());
+    for (size_t i = 0; i < levels.size(); ++i) {
+      BOOST_CHECK_EQUAL(index.find(levels[i]), static_cast<int32_t>(i));
+      BOOST_CHECK(index.getLevelVector(static_cast<int32_t>(i)) == levels[i]);
+    }
+    auto unpacked = index.getAllLevelVectors();
+    BOOST_CHECK(unpacked == levels);
+    // levels that are not contained
+    auto tooHigh = levels.back();
+    tooHigh[0] += 1;
+    BOOST_CHECK_EQUAL(index.find(tooHigh), -1);
+    auto tooLow = levels.front();
+    tooLow.back() = 0;
+    BOOST_CHECK_EQUAL(index.find(tooLow), -1);
+    auto farTooHigh = levels.front();
+    farTooHigh.back() = 1000;
+    BOOST_CHECK_EQUAL(index.find(farTooHigh), -1);
+    auto wrongDimension = levels.front();
+    wrongDimension.push_back(1);
+    BOOST_CHECK_EQUAL(index.find(wrongDimension), -1);
+    index.clear();
+    BOOST_CHECK_EQUAL(index.find(levels[0]), -1);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_PackedLevelVectorIndex_large) {
+  // compare memory and lookup time of the packed index to a sorted vector of level vectors
+  if (TestHelper::getRank(MPI_COMM_WORLD) != 0) {
+    return;
+  }
+  LevelVector lmin = {2, 2, 2, 2, 2, 2};
+  LevelVector lmax = {15, 15, 15, 15, 15, 15};
+  std::vector<LevelVector> levels;
+  combigrid::createTruncatedHierarchicalLevels(lmax, lmin, levels);
+  PackedLevelVectorIndex<int32_t> index(levels);
+  BOOST_REQUIRE(index.isPacked());
+
+  size_t levelsNumBytes = levels.capacity() * sizeof(LevelVector);
+  for (const auto& l : levels) {
+    levelsNumBytes += l.capacity() * sizeof(LevelType);
+  }
+  BOOST_TEST_MESSAGE("number of levels: " << levels.size() << ", vector of level vectors: "
+                                          << levelsNumBytes << " bytes (plus allocator overhead),"
+                                          << " packed index: " << index.getNumBytes() << " bytes");
+  BOOST_CHECK(index.getNumBytes() < levelsNumBytes);
+
+  int64_t checksumSorted = 0;
+  auto start = std::chrono::high_resolution_clock::now();
+  for (const auto& l : levels) {
+    auto found = std::lower_bound(levels.cbegin(), levels.cend(), l);
+    checksumSorted += std::distance(levels.cbegin(), found);
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto durationSorted = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+  int64_t checksumPacked = 0;
+  start = std::chrono::high_resolution_clock::now();
+  for (const auto& l : levels) {
+    checksumPacked += index.find(l);
+  }
+  end = std::chrono::high_resolution_clock::now();
+  auto durationPacked = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+  BOOST_TEST_MESSAGE("time to look up all levels: binary search "
+                     << durationSorted.count() << " milliseconds, packed index "
+                     << durationPacked.count() << " milliseconds");
+  BOOST_CHECK_EQUAL(checksumSorted, checksumPacked);
+#ifdef NDEBUG
+  BOOST_CHECK(durationPacked.count() <= durationSorted.count());
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(test_memoryTracking) {
+  DimType dim = 3;
+  std::vector<int> procs(dim, 1);
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  auto sparseGridBytes = MemoryTracker::getCurrentBytes(MemoryCategory::sparseGrids);
+  auto kahanBytes = MemoryTracker::getCurrentBytes(MemoryCategory::kahanData);
+  auto thirdLevelBytes = MemoryTracker::getCurrentBytes(MemoryCategory::thirdLevelSparseGrids);
+  auto fullGridBytes = MemoryTracker::getCurrentBytes(MemoryCategory::fullGrids);
+  {
+    LevelVector lmin(dim, 1);
+    LevelVector lmax(dim, 4);
+    std::vector<BoundaryType> boundary(dim, 2);
+    DistributedFullGrid<double> dfg(dim, lmax, comm, boundary, procs);
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::fullGrids) - fullGridBytes,
+                      dfg.getNrLocalElements() * sizeof(double));
+
+    DistributedSparseGridUniform<double> dsg(dim, lmax, lmin, comm);
+    dsg.registerDistributedFullGrid(dfg);
+    auto dataBytes = dsg.getAccumulatedDataSize() * sizeof(double);
+    dsg.createSubspaceData();
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::sparseGrids) - sparseGridBytes,
+                      dataBytes);
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::kahanData) - kahanBytes,
+                      dataBytes);
+    BOOST_CHECK_GE(MemoryTracker::getPeakBytes(MemoryCategory::sparseGrids),
+                   sparseGridBytes + dataBytes);
+
+    // the subspace data of the extra third level sparse grids is accounted for separately
+    dsg.setMemoryCategory(MemoryCategory::thirdLevelSparseGrids);
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::sparseGrids),
+                      sparseGridBytes);
+    BOOST_CHECK_EQUAL(
+        MemoryTracker::getCurrentBytes(MemoryCategory::thirdLevelSparseGrids) - thirdLevelBytes,
+        dataBytes);
+
+    dsg.deleteSubspaceData();
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::thirdLevelSparseGrids),
+                      thirdLevelBytes);
+    BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::kahanData) - kahanBytes,
+                      dataBytes);
+  }
+  BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::kahanData), kahanBytes);
+  BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::fullGrids), fullGridBytes);
+  MemoryTracker::resetPeaks();
+  BOOST_CHECK_EQUAL(MemoryTracker::getPeakBytes(MemoryCategory::sparseGrids), sparseGridBytes);
+}
+
+BOOST_AUTO_TEST_CASE(test_gridMemoryPolicy) {
+  DimType dim = 3;
+  std::vector<int> procs(dim, 1);
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  const auto defaultPolicy = getGridMemoryPolicy();
+  BOOST_CHECK_EQUAL(defaultPolicy.toString(), "align=64");
+  auto policy = GridMemoryPolicy::fromString(" align=4096, hugepages,interleave");
+  BOOST_CHECK_EQUAL(policy.alignment, 4096);
+  BOOST_CHECK(policy.hugePages);
+  BOOST_CHECK(policy.numaPlacement == GridMemoryPolicy::NUMAPlacement::interleave);
+  BOOST_CHECK_EQUAL(GridMemoryPolicy::fromString(policy.toString()).toString(), policy.toString());
+  BOOST_CHECK_THROW(GridMemoryPolicy::fromString("align=48"), std::invalid_argument);
+  BOOST_CHECK_THROW(GridMemoryPolicy::fromString("hugepage"), std::invalid_argument);
+
+  for (const std::string options : {"", "align=4096,hugepages,firsttouch", "interleave"}) {
+    policy = GridMemoryPolicy::fromString(options);
+    setGridMemoryPolicy(policy);
+    {
+      LevelVector lmin(dim, 1);
+      LevelVector lmax(dim, 6);
+      std::vector<BoundaryType> boundary(dim, 2);
+      DistributedFullGrid<double> dfg(dim, lmax, comm, boundary, procs);
+      BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(dfg.getData()) % policy.alignment, 0);
+      if (policy.hugePages) {
+        // the grid is larger than a huge page
+        BOOST_CHECK_GE(dfg.getNrLocalElements() * sizeof(double), GridMemoryPolicy::hugePageSize);
+        BOOST_CHECK_EQUAL(
+            reinterpret_cast<uintptr_t>(dfg.getData()) % GridMemoryPolicy::hugePageSize, 0);
+      }
+      // the allocation does not change the values
+      BOOST_CHECK_EQUAL(dfg.getLpNorm(1), 0.);
+
+      DistributedSparseGridUniform<double> dsg(dim, lmax, lmin, comm);
+      dsg.registerDistributedFullGrid(dfg);
+      dsg.createSubspaceData();
+      BOOST_CHECK_EQUAL(reinterpret_cast<uintptr_t>(dsg.getRawData()) % policy.alignment, 0);
+      dsg.addDistributedFullGrid(dfg, 1.);
+    }
+  }
+  setGridMemoryPolicy(defaultPolicy);
+}
+
+BOOST_AUTO_TEST_CASE(test_mixedPrecision) {
+  DimType dim = 3;
+  std::vector<int> procs = {2, 1, 1};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  LevelVector lmin(dim, 1);
+  LevelVector lmax(dim, 4);
+  LevelVector level = {4, 3, 2};
+  std::vector<BoundaryType> boundary(dim, 2);
+  auto f = [](const std::vector<double>& coords) {
+    return std::exp(coords[0]) * (1. + coords[1] * coords[2]);
+  };
+  DistributedFullGrid<double> dfgDouble(dim, level, comm, boundary, procs);
+  DistributedFullGrid<float> dfgFloat(dim, level, comm, boundary, procs);
+  DistributedFullGrid<std::complex<float>> dfgComplexFloat(dim, level, comm, boundary, procs);
+  std::vector<double> coords(dim);
+  for (IndexType li = 0; li < dfgDouble.getNrLocalElements(); ++li) {
+    dfgDouble.getCoordsLocal(li, coords);
+    dfgDouble.getData()[li] = f(coords);
+    dfgFloat.getData()[li] = static_cast<float>(f(coords));
+    dfgComplexFloat.getData()[li] = std::complex<float>(static_cast<float>(f(coords)), 1.f);
+  }
+  DistributedHierarchization::hierarchizeHierachicalBasis<double>(dfgDouble, {true, true, true});
+  DistributedHierarchization::hierarchizeHierachicalBasis<float>(dfgFloat, {true, true, true});
+  DistributedHierarchization::hierarchizeHierachicalBasis<std::complex<float>>(dfgComplexFloat,
+                                                                              {true, true, true});
+
+  // float and double grids accumulated in one double precision sparse grid
+  DistributedSparseGridUniform<double> dsg(dim, lmax, lmin, comm);
+  dsg.registerDistributedFullGrid(dfgDouble);
+  dsg.registerDistributedFullGrid(dfgFloat);
+  dsg.createSubspaceData();
+  dsg.addDistributedFullGrid(dfgDouble, 1.);
+  dsg.addDistributedFullGrid(dfgFloat, -1.);
+  // only the rounding error of the float grid remains
+  for (size_t i = 0; i < dsg.getRawDataSize(); ++i) {
+    BOOST_CHECK_SMALL(dsg.getRawData()[i], 1e-5);
+  }
+  dsg.setZero();
+  dsg.addDistributedFullGrid(dfgFloat, 2.);
+  dsg.addDistributedFullGrid(dfgDouble, -1.);
+
+  DistributedFullGrid<float> extracted(dim, level, comm, boundary, procs);
+  extracted.extractFromUniformSG(dsg);
+  DistributedHierarchization::dehierarchizeHierachicalBasis<float>(extracted, {true, true, true});
+  for (IndexType li = 0; li < extracted.getNrLocalElements(); ++li) {
+    extracted.getCoordsLocal(li, coords);
+    BOOST_TEST(extracted.getData()[li] == f(coords), boost::test_tools::tolerance(1e-5));
+  }
+
+  // complex float grid accumulated in complex double
+  DistributedSparseGridUniform<std::complex<double>> dsgComplex(dim, lmax, lmin, comm);
+  dsgComplex.registerDistributedFullGrid(dfgComplexFloat);
+  dsgComplex.createSubspaceData();
+  dsgComplex.addDistributedFullGrid(dfgComplexFloat, 1.);
+  dfgComplexFloat.setZero();
+  dfgComplexFloat.extractFromUniformSG(dsgComplex);
+  DistributedHierarchization::dehierarchizeHierachicalBasis<std::complex<float>>(
+      dfgComplexFloat, {true, true, true});
+  for (IndexType li = 0; li < dfgComplexFloat.getNrLocalElements(); ++li) {
+    dfgComplexFloat.getCoordsLocal(li, coords);
+    BOOST_TEST(dfgComplexFloat.getData()[li].real() == f(coords),
+               boost::test_tools::tolerance(1e-5));
+    BOOST_TEST(dfgComplexFloat.getData()[li].imag() == 1.f, boost::test_tools::tolerance(1e-5f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_decompositionPlanner) {
+  DimType dim = 3;
+  std::vector<int> procs = {2, 2, 1};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  LevelVector lmin = {2, 2, 2};
+  LevelVector lmax = {5, 6, 4};
+  std::vector<BoundaryType> boundary = {2, 1, 0};
+  CombiMinMaxScheme combischeme(dim, lmin, lmax);
+  combischeme.createAdaptiveCombischeme();
+  const auto& levels = combischeme.getCombiSpaces();
+
+  DecompositionPlannerOptions options;
+  auto candidates = getParallelizationCandidates(lmin, boundary, 4, options);
+  // level 2 without boundary has only 3 points, so at most 3 processes in dimension 2
+  BOOST_CHECK_EQUAL(candidates.size(), 5);
+  options.fixedProcs = {0, 0, 1};
+  options.maxProcs = {2, 0, 0};
+  candidates = getParallelizationCandidates(lmin, boundary, 4, options);
+  BOOST_CHECK_EQUAL(candidates.size(), 2);
+  for (const auto& p : candidates) {
+    BOOST_CHECK_EQUAL(p[2], 1);
+    BOOST_CHECK_LE(p[0], 2);
+  }
+
+  auto plans = planDecompositions(levels, lmin, lmax, boundary, 4, options);
+  BOOST_REQUIRE_EQUAL(plans.size(), 2);
+  BOOST_CHECK_LE(plans[0].cost, plans[1].cost);
+  BOOST_CHECK_GE(plans[0].getSparseGridImbalance(), 1.);
+  const auto& plan = plans[0].parallelization == procs ? plans[0] : plans[1];
+  BOOST_REQUIRE(plan.parallelization == procs);
+  BOOST_CHECK_GT(plan.hierarchizationMaxPerRank, 0);
+  BOOST_CHECK_GE(plan.hierarchizationTotal, plan.hierarchizationMaxPerRank);
+
+  // compare the predicted sparse grid sizes to the registration of the actual grids
+  DistributedSparseGridUniform<real> dsg(dim, lmax, lmin, comm);
+  for (const auto& level : levels) {
+    DistributedFullGrid<real> dfg(
+        dim, level, comm, boundary, procs, false,
+        downsampleDecomposition(plan.decomposition, lmax, level, boundary));
+    dsg.registerDistributedFullGrid(dfg);
+    for (DimType d = 0; d < dim; ++d) {
+      for (LevelType l = 1; l <= level[d]; ++l) {
+        BOOST_CHECK_EQUAL(dfg.getNumPointsOnThisPartition(l, d),
+                          getNumDofHierarchicalInRange(l, level[d], boundary[d],
+                                                       dfg.getLowerBounds()[d],
+                                                       dfg.getUpperBounds()[d]));
+      }
+    }
+  }
+  long long localSize = std::accumulate(dsg.getSubspaceDataSizes().begin(),
+                                        dsg.getSubspaceDataSizes().end(), 0LL);
+  long long maxSize = 0, minSize = 0, totalSize = 0;
+  MPI_Allreduce(&localSize, &maxSize, 1, MPI_LONG_LONG, MPI_MAX, comm);
+  MPI_Allreduce(&localSize, &minSize, 1, MPI_LONG_LONG, MPI_MIN, comm);
+  MPI_Allreduce(&localSize, &totalSize, 1, MPI_LONG_LONG, MPI_SUM, comm);
+  BOOST_CHECK_EQUAL(plan.sparseGridMaxPerRank, maxSize);
+  BOOST_CHECK_EQUAL(plan.sparseGridMinPerRank, minSize);
+  BOOST_CHECK_EQUAL(plan.sparseGridTotal, totalSize);
+
+  // same as the partitioned DOF count for schemes with boundary
+  boundary = std::vector<BoundaryType>(dim, 2);
+  auto evaluated = evaluateDecomposition(levels, lmax, boundary, procs);
+  std::set<LevelVector> subspaces;
+  for (const auto& level : levels) {
+    for (const auto& subspace : getDownSet(level)) subspaces.insert(subspace);
+  }
+  auto numDOF =
+      getPartitionedNumDOFSG(std::vector<LevelVector>(subspaces.begin(), subspaces.end()), lmax,
+                             evaluated.decomposition);
+  BOOST_CHECK_EQUAL(evaluated.sparseGridMaxPerRank,
+                    *std::max_element(numDOF.begin(), numDOF.end()));
+  BOOST_CHECK_EQUAL(evaluated.sparseGridTotal,
+                    std::accumulate(numDOF.begin(), numDOF.end(), 0LL));
+}
+
+BOOST_AUTO_TEST_CASE(test_registerCombinationLevels) {
+  DimType dim = 3;
+  std::vector<int> procs = {2, 2, 1};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  LevelVector lmin = {2, 2, 2};
+  LevelVector lmax = {6, 5, 4};
+  std::vector<BoundaryType> boundary = {2, 1, 0};
+  CombiMinMaxScheme combischeme(dim, lmin, lmax);
+  combischeme.createAdaptiveCombischeme();
+  const auto& levels = combischeme.getCombiSpaces();
+  IndexVector numPoints(dim);
+  for (DimType d = 0; d < dim; ++d) numPoints[d] = getNumDofNodal(lmax[d], boundary[d]);
+  const auto decomposition = getDefaultDecomposition(numPoints, procs, false);
+
+  SparseGridPartition partition{lmax, boundary, IndexVector(dim), IndexVector(dim),
+                                LevelVector(dim, 0)};
+  MPICartesianUtils cartesianUtils(comm);
+  std::vector<int> partitionCoords;
+  int rank = 0;
+  MPI_Comm_rank(comm, &rank);
+  cartesianUtils.getPartitionCoordsOfRank(rank, partitionCoords);
+  for (DimType d = 0; d < dim; ++d) {
+    const auto c = static_cast<size_t>(partitionCoords[d]);
+    partition.lowerBounds[d] = decomposition[d][c];
+    partition.upperBounds[d] =
+        (c + 1 < decomposition[d].size()) ? decomposition[d][c + 1] : numPoints[d];
+  }
+
+  // a sparse grid smaller than lmax, as in the worker, and only some of the grids
+  auto sparseGridLmax = lmax - LevelVector(dim, 1);
+  for (const auto numLevels : {levels.size() / 2, levels.size()}) {
+    std::vector<LevelVector> someLevels(levels.begin(), levels.begin() + numLevels);
+    DistributedSparseGridUniform<real> dsgRegistered(dim, sparseGridLmax, lmin, comm);
+    DistributedSparseGridUniform<real> dsgComputed(dim, sparseGridLmax, lmin, comm);
+    for (const auto& level : someLevels) {
+      DistributedFullGrid<real> dfg(dim, level, comm, boundary, procs, false,
+                                    downsampleDecomposition(decomposition, lmax, level, boundary));
+      dsgRegistered.registerDistributedFullGrid(dfg);
+    }
+    dsgComputed.registerCombinationLevels(someLevels, partition);
+    BOOST_CHECK(dsgRegistered.getSubspaceDataSizes() == dsgComputed.getSubspaceDataSizes());
+    BOOST_CHECK_GT(dsgComputed.getAccumulatedDataSize(), 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_leanSparseGrid) {
+  DimType dim = 3;
+  std::vector<int> procs(dim, 1);
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  LevelVector lmin(dim, 1);
+  LevelVector lmax(dim, 4);
+  std::vector<BoundaryType> boundary(dim, 2);
+  DistributedFullGrid<double> dfg(dim, lmax, comm, boundary, procs);
+  std::iota(dfg.getData(), dfg.getData() + dfg.getNrLocalElements(), 1.);
+
+  DistributedSparseGridUniform<double> dsgKahan(dim, lmax, lmin, comm);
+  DistributedSparseGridUniform<double> dsgLean(dim, lmax, lmin, comm);
+  dsgKahan.registerDistributedFullGrid(dfg);
+  dsgLean.registerDistributedFullGrid(dfg);
+  dsgKahan.createKahanBuffer();
+
+  // without Kahan summation, there is no Kahan buffer
+  auto kahanBytes = MemoryTracker::getCurrentBytes(MemoryCategory::kahanData);
+  dsgLean.setKahanSummation(false);
+  BOOST_CHECK(!dsgLean.isKahanSummation());
+  dsgLean.createKahanBuffer();
+  dsgLean.setZero();
+  dsgKahan.setZero();
+  BOOST_CHECK_EQUAL(MemoryTracker::getCurrentBytes(MemoryCategory::kahanData), kahanBytes);
+
+  // but adding gives the same result for these (exactly representable) values
+  for (auto coeff : {1., -0.5, 2.}) {
+    dsgKahan.addDistributedFullGrid(dfg, coeff);
+    dsgLean.addDistributedFullGrid(dfg, coeff);
+  }
+  BOOST_REQUIRE_EQUAL(dsgKahan.getRawDataSize(), dsgLean.getRawDataSize());
+  for (size_t i = 0; i < dsgLean.getRawDataSize(); ++i) {
+    BOOST_CHECK_EQUAL(dsgKahan.getRawData()[i], dsgLean.getRawData()[i]);
+  }
+
+  // select every other subspace as partial view, and exchange it in place
+  std::vector<SubspaceSizeType> partialSizes(dsgLean.getNumSubspaces(), 0);
+  size_t numPartialPoints = 0;
+  for (decltype(dsgLean.getNumSubspaces()) i = 0; i < dsgLean.getNumSubspaces(); i += 2) {
+    partialSizes[i] = dsgLean.getDataSize(i);
+    numPartialPoints += partialSizes[i];
+  }
+  BOOST_REQUIRE_GT(numPartialPoints, 0);
+  std::vector<double> partialData(numPartialPoints, -1.);
+  MPI_Datatype partialType = getPartialDsgDatatype(&dsgLean, partialSizes);
+  MPI_Sendrecv(dsgLean.getRawData(), 1, partialType, 0, TRANSFER_DSGU_DATA_TAG,
+               partialData.data(), static_cast<int>(numPartialPoints), MPI_DOUBLE, 0,
+               TRANSFER_DSGU_DATA_TAG, MPI_COMM_SELF, MPI_STATUS_IGNORE);
+  size_t partialIndex = 0;
+  for (decltype(dsgLean.getNumSubspaces()) i = 0; i < dsgLean.getNumSubspaces(); ++i) {
+    for (SubspaceSizeType j = 0; j < partialSizes[i]; ++j) {
+      BOOST_CHECK_EQUAL(partialData[partialIndex++], dsgLean.getData(i)[j]);
+    }
+  }
+  BOOST_CHECK_EQUAL(partialIndex, numPartialPoints);
+
+  // write back doubled values, the other subspaces remain untouched
+  for (auto& value : partialData) value *= 2.;
+  MPI_Sendrecv(partialData.data(), static_cast<int>(numPartialPoints), MPI_DOUBLE, 0,
+               TRANSFER_DSGU_DATA_TAG, dsgLean.getRawData(), 1, partialType, 0,
+               TRANSFER_DSGU_DATA_TAG, MPI_COMM_SELF, MPI_STATUS_IGNORE);
+  MPI_Type_free(&partialType);
+  for (decltype(dsgLean.getNumSubspaces()) i = 0; i < dsgLean.getNumSubspaces(); ++i) {
+    auto factor = partialSizes[i] > 0 ? 2. : 1.;
+    for (SubspaceSizeType j = 0; j < dsgLean.getDataSize(i); ++j) {
+      BOOST_CHECK_EQUAL(dsgLean.getData(i)[j], factor * dsgKahan.getData(i)[j]);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_evalLocalContributions) {
+  std::vector<int> procs = {2, 2, 1};
+  CommunicatorType comm = TestHelper::getComm(procs);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  DimType dim = static_cast<DimType>(procs.size());
+  LevelVector lmax = {4, 3, 3};
+  auto interpolationCoords = montecarlo::getRandomCoordinates(100, dim);
+  // make sure there are some corner cases
+  interpolationCoords.push_back(std::vector<double>(dim, 0.));
+  interpolationCoords.push_back(std::vector<double>(dim, 1.));
+  interpolationCoords.push_back(std::vector<double>(dim, 0.5));
+  std::vector<bool> hierarchizationDims(dim, true);
+  // the sparse grid contains all subspaces of the full grid, to represent it exactly
+  std::vector<LevelVector> fullGridSubspaces;
+  combigrid::forEachLevelInDownSet(
+      lmax, [&fullGridSubspaces](const LevelVector& l) { fullGridSubspaces.push_back(l); });
+  std::sort(fullGridSubspaces.begin(), fullGridSubspaces.end());
+
+  for (BoundaryType b : {0, 1, 2}) {
+    // the hierarchization may stop at a minimum level, below which the values stay nodal
+    for (LevelType nodalLevel : {0, 2}) {
+      if (b == 0 && nodalLevel > 0) continue;
+      BOOST_TEST_CHECKPOINT("boundary " + std::to_string(b) + " nodal level " +
+                            std::to_string(nodalLevel));
+      std::vector<BoundaryType> boundary(dim, b);
+      DistributedFullGrid<double> dfg(dim, lmax, comm, boundary, procs, false);
+      std::vector<double> coords(dim);
+      for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+        dfg.getCoordsLocal(li, coords);
+        dfg.getData()[li] = 2. + coords[0] * coords[0] - coords[1] + coords[2] * coords[0];
+      }
+      auto referenceValues = dfg.getInterpolatedValues(interpolationCoords);
+
+      LevelVector hierarchizationLMin(dim, nodalLevel);
+      DistributedHierarchization::hierarchizeHierachicalBasis<double>(dfg, hierarchizationDims,
+                                                                      hierarchizationLMin);
+      DistributedSparseGridUniform<double> dsg(dim, fullGridSubspaces, comm);
+      dsg.registerDistributedFullGrid(dfg);
+      dsg.createSubspaceData();
+      dsg.setZero();
+      dsg.addDistributedFullGrid(dfg, 1.);
+
+      SparseGridPartition partition{lmax, boundary, dfg.getLowerBounds(), dfg.getUpperBounds(),
+                                    hierarchizationLMin};
+      std::vector<size_t> contributingIndices;
+      std::vector<double> contributions;
+      dsg.evalLocalContributions(interpolationCoords, partition, contributingIndices,
+                                 contributions);
+      BOOST_REQUIRE_EQUAL(contributingIndices.size(), contributions.size());
+      std::vector<double> values(interpolationCoords.size(), 0.);
+      for (size_t k = 0; k < contributingIndices.size(); ++k) {
+        values[contributingIndices[k]] += contributions[k];
+      }
+      MPI_Allreduce(MPI_IN_PLACE, values.data(), static_cast<int>(values.size()), MPI_DOUBLE,
+                    MPI_SUM, comm);
+      for (size_t i = 0; i < values.size(); ++i) {
+        BOOST_CHECK_CLOSE(values[i], referenceValues[i], TestHelper::tolerance);
+      }
+    }
+  }
+}
+
 BOOST_AUTO_TEST_CASE(test_getAllKOutOfDDimensions) {
   if (TestHelper::getRank(MPI_COMM_WORLD) == 0) {
     for (DimType d = 1; d < 8; ++d) {
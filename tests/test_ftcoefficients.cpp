@@ -0,0 +1,246 @@
+#define BOOST_TEST_DYN_LINK
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <set>
+
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "fault_tolerance/FaultTolerantCoefficients.hpp"
+#include "utils/LevelSetUtils.hpp"
+#include "test_helper.hpp"
+
+using namespace combigrid;
+
+CombigridDict getFaultTolerantDict(DimType dim, const LevelVector& lmin, const LevelVector& lmax) {
+  CombiMinMaxScheme combischeme(dim, lmin, lmax);
+  combischeme.createAdaptiveCombischeme();
+  combischeme.makeFaultTolerant();
+  CombigridDict dict;
+  for (size_t i = 0; i < combischeme.getCombiSpaces().size(); ++i) {
+    dict[combischeme.getCombiSpaces()[i]] = combischeme.getCoeffs()[i];
+  }
+  return dict;
+}
+
+void checkValidCombination(const CombigridDict& dict, const LevelVectorList& faults,
+                           const LevelVectorList& recompute) {
+  real sum = 0.;
+  for (const auto& entry : dict) sum += entry.second;
+  BOOST_CHECK_CLOSE(sum, 1., TestHelper::tolerance);
+  for (const auto& fault : faults) {
+    if (std::find(recompute.begin(), recompute.end(), fault) == recompute.end()) {
+      BOOST_CHECK_EQUAL(dict.at(fault), 0.);
+    }
+  }
+}
+
+// the coefficients of the downset w, c_l = sum_{z in {0,1}^d} (-1)^|z| [l+z in w]
+CombigridDict getCoefficientsOfDownset(const std::set<LevelVector>& w) {
+  CombigridDict coefficients;
+  for (const auto& l : w) {
+    const auto dim = l.size();
+    real c = 0.;
+    for (size_t z = 0; z < (static_cast<size_t>(1) << dim); ++z) {
+      LevelVector neighbor = l;
+      int sign = 1;
+      for (size_t d = 0; d < dim; ++d) {
+        if (z & (static_cast<size_t>(1) << d)) {
+          neighbor[d] += 1;
+          sign = -sign;
+        }
+      }
+      if (w.find(neighbor) != w.end()) c += sign;
+    }
+    coefficients[l] = c;
+  }
+  return coefficients;
+}
+
+// the optimum value sum 4^-|l| found by enumerating all subsets of the full downset
+real getBruteForceOptimum(const CombigridDict& dict, const LevelVector& lmin,
+                          const LevelVectorList& blockedFaults) {
+  std::set<LevelVector> full;
+  for (const auto& entry : dict) {
+    if (entry.second == 0.) continue;
+    for (const auto& l : combigrid::getDownSet(entry.first)) {
+      if (l >= lmin) full.insert(l);
+    }
+  }
+  const std::vector<LevelVector> candidates(full.begin(), full.end());
+  BOOST_REQUIRE(candidates.size() < 20);
+
+  real best = -1.;
+  for (size_t subset = 0; subset < (static_cast<size_t>(1) << candidates.size()); ++subset) {
+    std::set<LevelVector> w;
+    for (size_t i = 0; i < candidates.size(); ++i) {
+      if (subset & (static_cast<size_t>(1) << i)) w.insert(candidates[i]);
+    }
+    bool feasible = true;
+    for (const auto& l : w) {
+      for (size_t d = 0; d < l.size() && feasible; ++d) {
+        LevelVector lower = l;
+        lower[d] -= 1;
+        if (lower[d] >= lmin[d] && w.find(lower) == w.end()) feasible = false;
+      }
+    }
+    if (!feasible) continue;
+    for (const auto& c : getCoefficientsOfDownset(w)) {
+      if (c.second == 0.) continue;
+      if (dict.find(c.first) == dict.end() ||
+          std::find(blockedFaults.begin(), blockedFaults.end(), c.first) != blockedFaults.end()) {
+        feasible = false;
+        break;
+      }
+    }
+    if (!feasible) continue;
+    real value = 0.;
+    for (const auto& l : w) value += std::pow(4., -static_cast<real>(levelSum(l)));
+    best = std::max(best, value);
+  }
+  return best;
+}
+
+// the value sum 4^-|l| of the downset spanned by the levels with nonzero coefficients
+real getValue(const CombigridDict& dict, const LevelVector& lmin) {
+  std::set<LevelVector> w;
+  for (const auto& entry : dict) {
+    if (entry.second == 0.) continue;
+    for (const auto& l : combigrid::getDownSet(entry.first)) {
+      if (l >= lmin) w.insert(l);
+    }
+  }
+  real value = 0.;
+  for (const auto& l : w) value += std::pow(4., -static_cast<real>(levelSum(l)));
+  return value;
+}
+
+BOOST_FIXTURE_TEST_SUITE(ftcoefficients, TestHelper::BarrierAtEnd, *boost::unit_test::timeout(120))
+
+BOOST_AUTO_TEST_CASE(test_single_fault_2d) {
+  CommunicatorType comm = TestHelper::getComm(1);
+  if (comm == MPI_COMM_NULL) return;
+
+  LevelVector lmin = {1, 1}, lmax = {4, 4};
+  auto dict = getFaultTolerantDict(2, lmin, lmax);
+  FaultTolerantCoefficients ftCoefficients(dict, lmin);
+  BOOST_CHECK(ftCoefficients.getCombiDict() == dict);
+
+  // a fault without consequences for the coefficients
+  BOOST_CHECK(!ftCoefficients.addFault({1, 2}));
+  BOOST_CHECK(ftCoefficients.getCombiDict() == dict);
+
+  // removing (2,3) moves its lower neighbors up
+  BOOST_CHECK(ftCoefficients.addFault({2, 3}));
+  auto newDict = ftCoefficients.getCombiDict();
+  BOOST_CHECK_EQUAL(newDict[LevelVector({2, 3})], 0.);
+  BOOST_CHECK_EQUAL(newDict[LevelVector({1, 3})], 0.);
+  BOOST_CHECK_EQUAL(newDict[LevelVector({2, 2})], 0.);
+  BOOST_CHECK_EQUAL(newDict[LevelVector({1, 2})], -1.);
+  BOOST_CHECK_EQUAL(newDict[LevelVector({1, 4})], 1.);
+  BOOST_CHECK_EQUAL(newDict[LevelVector({3, 1})], -1.);
+
+  // (1,2) was on a lower diagonal and now has to be recomputed
+  const auto recompute = ftCoefficients.getLevelsToRecompute();
+  BOOST_REQUIRE_EQUAL(recompute.size(), 1);
+  BOOST_CHECK(recompute[0] == LevelVector({1, 2}));
+  checkValidCombination(newDict, {{2, 3}, {1, 2}}, recompute);
+}
+
+BOOST_AUTO_TEST_CASE(test_brute_force) {
+  CommunicatorType comm = TestHelper::getComm(1);
+  if (comm == MPI_COMM_NULL) return;
+
+  // compare with all downsets for schemes small enough to enumerate
+  for (DimType dim : {2, 3}) {
+    LevelVector lmin(dim, 1), lmax(dim, dim == 2 ? 5 : 3);
+    auto dict = getFaultTolerantDict(dim, lmin, lmax);
+    LevelVectorList topLevels;
+    for (const auto& entry : dict) {
+      // the two uppermost diagonals
+      if (levelSum(entry.first) >= levelSum(lmin) + lmax[0] - lmin[0] - 1) {
+        topLevels.push_back(entry.first);
+      }
+    }
+    std::mt19937 gen(42);
+    for (int trial = 0; trial < 10; ++trial) {
+      std::shuffle(topLevels.begin(), topLevels.end(), gen);
+      LevelVectorList faults(topLevels.begin(), topLevels.begin() + 1 + trial % 3);
+
+      FaultTolerantCoefficients ftCoefficients(dict, lmin);
+      ftCoefficients.addFaults(faults);
+      auto newDict = ftCoefficients.getCombiDict();
+      checkValidCombination(newDict, faults, ftCoefficients.getLevelsToRecompute());
+      BOOST_CHECK_CLOSE(getValue(newDict, lmin), getBruteForceOptimum(dict, lmin, faults),
+                        TestHelper::tolerance);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_incremental) {
+  CommunicatorType comm = TestHelper::getComm(1);
+  if (comm == MPI_COMM_NULL) return;
+
+  LevelVector lmin = {2, 2, 2}, lmax = {7, 7, 7};
+  auto dict = getFaultTolerantDict(3, lmin, lmax);
+  FaultTolerantCoefficients incremental(dict, lmin);
+  LevelVectorList faults = {{2, 4, 5}, {5, 2, 4}, {3, 3, 4}};
+  for (size_t i = 0; i < faults.size(); ++i) {
+    BOOST_CHECK(incremental.addFault(faults[i]));
+    checkValidCombination(incremental.getCombiDict(),
+                          LevelVectorList(faults.begin(), faults.begin() + i + 1),
+                          incremental.getLevelsToRecompute());
+  }
+
+  // all at once can only be as good or better
+  FaultTolerantCoefficients batch(dict, lmin);
+  batch.addFaults(faults);
+  checkValidCombination(batch.getCombiDict(), faults, batch.getLevelsToRecompute());
+  BOOST_CHECK_GE(getValue(batch.getCombiDict(), lmin) * (1. + TestHelper::tolerance),
+                 getValue(incremental.getCombiDict(), lmin));
+
+  // the solver restarted from the adapted coefficients keeps the previous faults compensated
+  FaultTolerantCoefficients restarted(incremental.getCombiDict(), lmin);
+  BOOST_CHECK(restarted.getCombiDict() == incremental.getCombiDict());
+}
+
+BOOST_AUTO_TEST_CASE(test_scheme_sizes) {
+  CommunicatorType comm = TestHelper::getComm(1);
+  if (comm == MPI_COMM_NULL) return;
+
+  // time to recovery for a single fault on the top diagonal and for several faults at once
+  for (DimType dim : {2, 3, 4, 5, 6}) {
+    for (LevelType diff : {3, 5, 8}) {
+      if (dim >= 5 && diff > 5) continue;
+      LevelVector lmin(dim, 2), lmax(dim, static_cast<LevelType>(2 + diff));
+      auto dict = getFaultTolerantDict(dim, lmin, lmax);
+      LevelVectorList topLevels;
+      for (const auto& entry : dict) {
+        if (levelSum(entry.first) == levelSum(lmin) + diff) {
+          topLevels.push_back(entry.first);
+        }
+      }
+      std::mt19937 gen(static_cast<unsigned>(dim * 100 + diff));
+      std::shuffle(topLevels.begin(), topLevels.end(), gen);
+
+      for (size_t numFaults : {1, 4}) {
+        if (numFaults > topLevels.size()) continue;
+        LevelVectorList faults(topLevels.begin(), topLevels.begin() + numFaults);
+        auto start = std::chrono::high_resolution_clock::now();
+        FaultTolerantCoefficients ftCoefficients(dict, lmin);
+        for (const auto& fault : faults) ftCoefficients.addFault(fault);
+        auto newDict = ftCoefficients.getCombiDict();
+        auto end = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+        BOOST_TEST_MESSAGE("fault tolerant coefficients, dim " << static_cast<int>(dim)
+                           << " lmax-lmin " << diff << " #levels " << dict.size()
+                           << " #faults " << numFaults << ": " << duration.count() << " us");
+        checkValidCombination(newDict, faults, ftCoefficients.getLevelsToRecompute());
+        BOOST_CHECK(duration.count() < 10000000);
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
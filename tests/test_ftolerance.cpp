@@ -161,7 +161,7 @@ class TaskAdvFDM : public combigrid::Task {
   size_t stepsTotal_;
   size_t combiStep_;
   DistributedFullGrid<CombiDataType>* dfg_;
-  std::vector<CombiDataType> phi_;
+  GridVector<CombiDataType> phi_;
 
   template <class Archive>
   void serialize(Archive& ar, const unsigned int version) {
@@ -311,10 +311,8 @@ for (size_t i = 1; i < ncombi; ++i){
         manager.getGroupFaultIDs(faultsID, groupFaults);
 
         /* call optimization code to find new coefficients */
-        const std::string prob_name = "interpolation based optimization";
         std::vector<size_t> redistributeFaultsID, recomputeFaultsID;
-        manager.recomputeOptimumCoefficients(prob_name, faultsID,
-                                             redistributeFaultsID, recomputeFaultsID);
+        manager.recomputeOptimumCoefficients(faultsID, redistributeFaultsID, recomputeFaultsID);
         for ( auto id : redistributeFaultsID ) {
           TaskAdvFDM* tmp = static_cast<TaskAdvFDM*>(manager.getTask(id));
           tmp->setStepsTotal(i*nsteps);
@@ -13,7 +13,12 @@
 #include "utils/Stats.hpp"
 
 namespace TestHelper{
+#ifdef SINGLEPRECISION
+  // the component grids only hold single precision values
+  static constexpr double tolerance = 1e-3;
+#else
   static constexpr double tolerance = 1e-12;
+#endif  // SINGLEPRECISION
   static constexpr double higherTolerance = 1e-5;
 
   static inline bool checkNumMPIProcsAvailable(int nprocs) {
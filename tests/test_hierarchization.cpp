@@ -243,7 +243,7 @@ real checkConservationOfMomentum(DistributedFullGrid<FG_ELEMENT>& dfg,
   auto dfgZero = std::unique_ptr<DistributedFullGrid<FG_ELEMENT>>(
       new DistributedFullGrid<FG_ELEMENT>(dim, lmin, comm, boundary, procs));
   BOOST_CHECK(values.size() == dfgZero->getElementVector().size());
-  dfgZero->getElementVector() = values;
+  dfgZero->getElementVector().assign(values.begin(), values.end());
 
   // no need to dehierarchize, is nodal/scaling function on coarsest grid anyways
 
@@ -185,9 +185,9 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
 
     Stats::startEvent("manager get norms");
     // get all kinds of norms
-    manager.getLpNorms(0);
+    auto maxNorms = manager.getLpNorms(0);
     manager.getLpNorms(1);
-    manager.getLpNorms(2);
+    auto twoNorms = manager.getLpNorms(2);
     auto normsLmax = manager.parallelEvalNorm(lmax, 0);
     auto analyticalNorms = manager.evalAnalyticalOnDFG(lmax, 0);
     auto error = manager.evalErrorOnDFG(lmax, 0);
@@ -199,8 +199,35 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
       BOOST_CHECK_CLOSE(error[1], 0., TestHelper::tolerance);
       BOOST_CHECK_CLOSE(error[2], 0., TestHelper::tolerance);
     }
+    // the same norms with a single signal per group
+    auto normBundle = manager.evalNormBundle(lmax);
+    BOOST_CHECK_EQUAL(normBundle.taskNorms.size(), maxNorms.size());
+    for (const auto& taskNorms : normBundle.taskNorms) {
+      BOOST_CHECK_CLOSE(taskNorms.second[0], maxNorms[taskNorms.first], TestHelper::tolerance);
+      BOOST_CHECK_CLOSE(taskNorms.second[2], twoNorms[taskNorms.first], TestHelper::tolerance);
+    }
+    for (size_t p = 0; p < 3; ++p) {
+      BOOST_CHECK_CLOSE(normBundle.combined[p], normsLmax[p], TestHelper::tolerance);
+      BOOST_CHECK_CLOSE(normBundle.analytical[p], analyticalNorms[p], TestHelper::tolerance);
+      BOOST_CHECK_SMALL(normBundle.error[p] - error[p], TestHelper::tolerance);
+    }
     Stats::stopEvent("manager get norms");
 
+    BOOST_TEST_CHECKPOINT("memory report");
+    auto memoryReports = manager.getMemoryReports();
+    BOOST_REQUIRE_EQUAL(memoryReports.size(), ngroup);
+    auto fullGrids = static_cast<size_t>(MemoryCategory::fullGrids);
+    auto sparseGrids = static_cast<size_t>(MemoryCategory::sparseGrids);
+    uint64_t fullGridBytes = 0;
+    for (const auto& report : memoryReports) {
+      // groups without tasks have no full grids
+      fullGridBytes += report.currentBytesSum[fullGrids];
+      BOOST_CHECK_LE(report.currentBytesMax[fullGrids], report.currentBytesSum[fullGrids]);
+      BOOST_CHECK_LE(report.currentBytesMax[sparseGrids], report.currentBytesSum[sparseGrids]);
+      BOOST_CHECK_LE(report.currentBytesSum[sparseGrids], report.peakBytesSum[sparseGrids]);
+    }
+    BOOST_CHECK_GT(fullGridBytes, 0);
+
     BOOST_TEST_CHECKPOINT("write solution");
     std::string filename("integration_" + std::to_string(ncombi) + ".raw");
     BOOST_TEST_CHECKPOINT("write solution " + filename);
@@ -329,6 +356,104 @@ void checkIntegration(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundar
   BOOST_CHECK(!TestHelper::testStrayMessages(comm));
 }
 
+/**
+ * @brief restores the tasks of one group from the buddy checkpoints taken at the combination
+ * and compares the norms after the following time step with the ones of the original tasks
+ */
+void checkBuddyCheckpoint(size_t ngroup = 4, size_t nprocs = 1) {
+  size_t size = ngroup * nprocs + 1;
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    BOOST_TEST_CHECKPOINT("drop out of test comm");
+    return;
+  }
+  combigrid::Stats::initialize();
+  theMPISystem()->initWorldReusable(comm, ngroup, nprocs);
+
+  DimType dim = 2;
+  LevelVector lmin(dim, 2);
+  LevelVector lmax(dim, 5);
+
+  WORLD_MANAGER_EXCLUSIVE_SECTION {
+    ProcessGroupManagerContainer pgroups;
+    for (size_t i = 0; i < ngroup; ++i) {
+      int pgroupRootID(i);
+      pgroups.emplace_back(std::make_shared<ProcessGroupManager>(pgroupRootID));
+    }
+
+    auto loadmodel = std::unique_ptr<LoadModel>(new LinearLoadModel());
+    std::vector<BoundaryType> boundary(dim, 2);
+    CombiMinMaxScheme combischeme(dim, lmin, lmax);
+    combischeme.createAdaptiveCombischeme();
+    std::vector<LevelVector> levels = combischeme.getCombiSpaces();
+    std::vector<combigrid::real> coeffs = combischeme.getCoeffs();
+
+    TaskContainer tasks;
+    std::vector<size_t> taskIDs;
+    for (size_t i = 0; i < levels.size(); i++) {
+      Task* t = new TaskCount(levels[i], boundary, coeffs[i], loadmodel.get());
+      tasks.push_back(t);
+      taskIDs.push_back(t->getID());
+    }
+
+    CombiParameters params(dim, lmin, lmax, boundary, levels, coeffs, taskIDs, 3);
+    params.setParallelization({static_cast<int>(nprocs), 1});
+    params.setBuddyCheckpointing(true);
+
+    ProcessManager manager{pgroups, tasks, params, std::move(loadmodel)};
+    manager.updateCombiParameters();
+
+    manager.runfirst();
+    manager.combine();
+    manager.runnext();
+    auto norms = manager.getLpNorms(2);
+
+    auto memoryReports = manager.getMemoryReports();
+    auto checkpoints = static_cast<size_t>(MemoryCategory::checkpoints);
+    uint64_t checkpointBytes = 0;
+    for (const auto& report : memoryReports) checkpointBytes += report.currentBytesSum[checkpoints];
+    BOOST_CHECK_GT(checkpointBytes, 0);
+
+    // pretend that the first group was replaced, and restore its state after the combination
+    BOOST_TEST_CHECKPOINT("restore from checkpoints");
+    BOOST_REQUIRE(!pgroups[0]->getTaskContainer().empty());
+    std::vector<ProcessGroupManagerID> recoveredGroups = {pgroups[0]};
+    Stats::startEvent("manager restore from checkpoints");
+    auto notRestored = manager.restoreFromCheckpoints(recoveredGroups);
+    Stats::stopEvent("manager restore from checkpoints");
+    BOOST_TEST_MESSAGE("manager restore from checkpoints: "
+                       << Stats::getDuration("manager restore from checkpoints")
+                       << " milliseconds");
+    BOOST_CHECK(notRestored.empty());
+
+    auto restoredNorms = manager.getLpNorms(2);
+    BOOST_REQUIRE_EQUAL(restoredNorms.size(), norms.size());
+    for (const auto& norm : norms) {
+      BOOST_CHECK_CLOSE(restoredNorms[norm.first], norm.second, TestHelper::tolerance);
+    }
+
+    manager.combine();
+    manager.exit();
+    BOOST_CHECK(!TestHelper::testStrayMessages(theMPISystem()->getGlobalComm()));
+  }
+  else {
+    BOOST_TEST_CHECKPOINT("Worker starts");
+    ProcessGroupWorker pgroup;
+    SignalType signal = -1;
+    while (signal != EXIT) {
+      BOOST_TEST_CHECKPOINT("Last Successful Worker Signal " + std::to_string(signal));
+      signal = pgroup.wait();
+    }
+    BOOST_CHECK(!TestHelper::testStrayMessages(theMPISystem()->getLocalComm()));
+    MASTER_EXCLUSIVE_SECTION { BOOST_CHECK(!TestHelper::testStrayMessages(theMPISystem()->getGlobalComm())); }
+  }
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
 /**
  * @brief Test for integrated passing of the hierarchical basis type
  *        (needs a lot of boilerplate code to set up manager etc, but its really only the
@@ -495,6 +620,8 @@ BOOST_AUTO_TEST_CASE(test_6) {
   checkPassingHierarchicalBases<BiorthogonalPeriodicBasisFunction>(4, 2);
 }
 
+BOOST_AUTO_TEST_CASE(test_buddy_checkpoint) { checkBuddyCheckpoint(4, 1); }
+
 BOOST_AUTO_TEST_CASE(test_7) {
   // unit test for downsampleDecomposition
   LevelVector lmin{1, 2, 4};
@@ -2,6 +2,8 @@
 #include <boost/test/unit_test.hpp>
 
 #include <chrono>
+#include <fstream>
+#include <sstream>
 #include <thread>
 
 #include "utils/Stats.hpp"
@@ -73,6 +75,118 @@ void testMeasureTime(int size, long for_milliseconds) {
 
   combigrid::Stats::finalize();
 }
+void checkScopedEvents(int size) {
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  combigrid::CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+
+  combigrid::Stats::initialize();
+  {
+    STATS_SCOPED_EVENT("outer");
+    for (int i = 0; i < 3; ++i) {
+      STATS_SCOPED_EVENT("inner");
+      std::this_thread::sleep_for(std::chrono::microseconds{1000});
+    }
+  }
+  BOOST_CHECK_EQUAL(combigrid::Stats::internEvent("outer"),
+                    combigrid::Stats::internEvent("outer"));
+  BOOST_CHECK_EQUAL(combigrid::Stats::getEventName(combigrid::Stats::internEvent("inner")),
+                    "inner");
+
+  auto records = combigrid::Stats::getTraceRecords();
+#ifdef TIMING
+  BOOST_REQUIRE_EQUAL(records.size(), 4);
+  BOOST_CHECK_EQUAL(combigrid::Stats::getEventName(records[0].handle), "outer");
+  BOOST_CHECK_EQUAL(records[0].depth, 0);
+  BOOST_CHECK_EQUAL(records[0].parent, -1);
+  for (size_t i = 1; i < records.size(); ++i) {
+    BOOST_CHECK_EQUAL(combigrid::Stats::getEventName(records[i].handle), "inner");
+    BOOST_CHECK_EQUAL(records[i].depth, 1);
+    BOOST_CHECK_EQUAL(records[i].parent, records[0].sequence);
+    BOOST_CHECK(records[i].startNanos >= records[0].startNanos);
+    BOOST_CHECK(records[i].endNanos <= records[0].endNanos);
+    BOOST_CHECK(records[i].endNanos - records[i].startNanos >= 1000000);
+  }
+#else
+  BOOST_CHECK(records.empty());
+#endif
+
+  // other threads get their own buffer
+  std::thread thread([]() { STATS_SCOPED_EVENT("in other thread"); });
+  thread.join();
+
+  combigrid::Stats::startEvent("named");
+  combigrid::Stats::stopEvent("named");
+  combigrid::Stats::finalize();
+  combigrid::Stats::writeChromeTrace("test_stats_trace.json", comm);
+
+#ifdef TIMING
+  MPI_Barrier(comm);
+  if (TestHelper::getRank(comm) == 0) {
+    std::ifstream file("test_stats_trace.json");
+    std::stringstream content;
+    content << file.rdbuf();
+    auto trace = content.str();
+    BOOST_CHECK_EQUAL(trace.rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0), 0);
+    BOOST_CHECK(trace.find("\"name\":\"inner\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"in other thread\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"named\"") != std::string::npos);
+    BOOST_CHECK(trace.find("\"name\":\"rank" + std::to_string(size - 1) + "\"") !=
+                std::string::npos);
+    BOOST_CHECK_EQUAL(trace.substr(trace.size() - 3), "]}\n");
+  }
+
+  // the ring buffer keeps only the newest events
+  auto handle = combigrid::Stats::internEvent("many");
+  for (size_t i = 0; i < combigrid::Stats::traceBufferSize; ++i) {
+    combigrid::Stats::beginScope(handle);
+    combigrid::Stats::endScope();
+  }
+  BOOST_CHECK_EQUAL(combigrid::Stats::getNumDroppedTraceRecords(), 4);
+  records = combigrid::Stats::getTraceRecords();
+  BOOST_CHECK_EQUAL(records.size(), combigrid::Stats::traceBufferSize);
+  BOOST_CHECK_EQUAL(records.front().handle, handle);
+  BOOST_CHECK_EQUAL(records.back().sequence, combigrid::Stats::traceBufferSize + 3);
+#endif
+}
+
+void testScopedEventOverhead(int size) {
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  combigrid::CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  combigrid::Stats::initialize();
+  const int numEvents = 100000;
+
+  auto start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numEvents; ++i) {
+    combigrid::Stats::startEvent("named event in hot loop");
+    combigrid::Stats::stopEvent("named event in hot loop");
+  }
+  auto end = std::chrono::high_resolution_clock::now();
+  auto durationNamed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+  start = std::chrono::high_resolution_clock::now();
+  for (int i = 0; i < numEvents; ++i) {
+    STATS_SCOPED_EVENT("scoped event in hot loop");
+  }
+  end = std::chrono::high_resolution_clock::now();
+  auto durationScoped = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+  BOOST_TEST_MESSAGE("time for " << numEvents << " events: named " << durationNamed.count()
+                                 << " microseconds, scoped " << durationScoped.count()
+                                 << " microseconds");
+#ifdef NDEBUG
+  BOOST_CHECK(durationScoped.count() < durationNamed.count());
+#endif
+  combigrid::Stats::finalize();
+}
+
 BOOST_FIXTURE_TEST_SUITE(stats, TestHelper::BarrierAtEnd, *boost::unit_test::timeout(60))
 
 BOOST_AUTO_TEST_CASE(test_3, * boost::unit_test::timeout(20)) {
@@ -90,4 +204,13 @@ BOOST_AUTO_TEST_CASE(test_time) {
   MPI_Barrier(MPI_COMM_WORLD);
 }
 
+BOOST_AUTO_TEST_CASE(test_scopedEvents, *boost::unit_test::timeout(20)) {
+  checkScopedEvents(1);
+  checkScopedEvents(9);
+}
+
+BOOST_AUTO_TEST_CASE(test_scopedEvents_speed_test, *boost::unit_test::timeout(20)) {
+  testScopedEventOverhead(1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -97,7 +97,7 @@ bool checkReducedFullGrid(ProcessGroupWorker& worker, int nrun) {
         CombiDataType expected = initialFunction(coords);
         CombiDataType occuring = dfg.getData()[li];
         if (expected == 0.) {
-          BOOST_CHECK_SMALL(occuring, 1e-300);
+          BOOST_CHECK_SMALL(occuring, static_cast<CombiDataType>(1e-300));
         } else {
           BOOST_REQUIRE_CLOSE(occuring, expected, TestHelper::tolerance);
         }
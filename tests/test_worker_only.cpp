@@ -7,14 +7,20 @@
 #include <boost/test/unit_test.hpp>
 #include <cstdio>
 #include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <type_traits>
 
 #include "TaskCount.hpp"
+#include "combicom/CombiCom.hpp"
 #include "combischeme/CombiMinMaxScheme.hpp"
 #include "io/H5InputOutput.hpp"
 #include "loadmodel/LearningLoadModel.hpp"
 #include "loadmodel/LinearLoadModel.hpp"
 #include "manager/CombiParameters.hpp"
 #include "manager/ProcessGroupWorker.hpp"
+#include "manager/WorkerOnlyDriver.hpp"
 #include "sparsegrid/DistributedSparseGridUniform.hpp"
 #include "stdlib.h"
 #include "task/Task.hpp"
@@ -330,6 +336,475 @@ void checkWorkerOnly(size_t ngroup = 1, size_t nprocs = 1, BoundaryType boundary
   BOOST_CHECK(!TestHelper::testStrayMessages(comm));
 }
 
+void checkWorkerOnlyDriver(size_t ngroup = 1, size_t nprocs = 1) {
+  size_t size = ngroup * nprocs;
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  CommunicatorType comm = TestHelper::getComm(size);
+  if (comm == MPI_COMM_NULL) {
+    return;
+  }
+  combigrid::Stats::initialize();
+  theMPISystem()->initWorldReusable(comm, ngroup, nprocs, false);
+
+  DimType dim = 2;
+  LevelVector lmin(dim, 2);
+  LevelVector lmax(dim, 5);
+  std::vector<BoundaryType> boundary(dim, 2);
+  size_t ncombi = 3;
+
+  CombiMinMaxScheme combischeme(dim, lmin, lmax);
+  combischeme.createAdaptiveCombischeme();
+  const auto& levels = combischeme.getCombiSpaces();
+  const auto& coeffs = combischeme.getCoeffs();
+
+  // every task is assigned to exactly one group, in all variants
+  auto loadmodel = std::unique_ptr<LoadModel>(new LinearLoadModel());
+  for (auto* model : {static_cast<LoadModel*>(nullptr), loadmodel.get()}) {
+    std::vector<size_t> timesAssigned(levels.size(), 0);
+    for (size_t g = 0; g < ngroup; ++g) {
+      auto assignment = getTaskAssignment(levels, coeffs, g, ngroup, {}, model);
+      BOOST_CHECK_EQUAL(assignment.levels.size(), assignment.taskNumbers.size());
+      for (size_t i = 0; i < assignment.taskNumbers.size(); ++i) {
+        BOOST_CHECK(assignment.levels[i] == levels[assignment.taskNumbers[i]]);
+        ++timesAssigned[assignment.taskNumbers[i]];
+      }
+    }
+    BOOST_CHECK(std::all_of(timesAssigned.begin(), timesAssigned.end(),
+                            [](size_t t) { return t == 1; }));
+  }
+
+  CombiParameters params(dim, lmin, lmax, boundary, ncombi, 1, {static_cast<int>(nprocs), 1},
+                         LevelVector(0), LevelVector(0), false);
+  if (nprocs == 1) {
+    params.setDecomposition({{0}, {0}});
+  } else if (nprocs == 2) {
+    params.setDecomposition({{0, 16}, {0}});
+  }
+  WorkerOnlyDriver driver(params);
+  auto assignment = getTaskAssignment(levels, coeffs, theMPISystem()->getProcessGroupNumber(),
+                                      ngroup, {}, loadmodel.get());
+  BOOST_REQUIRE(assignment.levels.size() > 0);
+  driver.initializeTasks<TaskCount>(assignment, loadmodel.get());
+
+  size_t numRunHooks = 0;
+  size_t numCombineHooks = 0;
+  driver.setAfterRunHook([&numRunHooks](WorkerOnlyDriver&, size_t step) {
+    BOOST_CHECK_EQUAL(step, numRunHooks);
+    ++numRunHooks;
+  });
+  driver.setAfterCombineHook([&numCombineHooks](WorkerOnlyDriver& d, size_t step) {
+    BOOST_CHECK_EQUAL(step, numCombineHooks);
+    ++numCombineHooks;
+    BOOST_CHECK(checkReducedFullGridIntegration(d.getWorker(),
+                                                d.getWorker().getCurrentNumberOfCombinations()));
+  });
+  driver.run(ncombi);
+  BOOST_CHECK_EQUAL(numRunHooks, ncombi);
+  BOOST_CHECK_EQUAL(numCombineHooks, ncombi);
+  BOOST_CHECK_EQUAL(driver.getNumberOfRunSteps(), ncombi);
+  BOOST_CHECK_EQUAL(driver.getWorker().getCurrentNumberOfCombinations(), ncombi);
+
+  // with a given decomposition, the combined solution can be evaluated directly on the sparse
+  // grid; the full grid is still used for output and norms unless a memory budget is set
+  auto& worker = driver.getWorker();
+  BOOST_REQUIRE(worker.canEvalOnSparseGrid());
+  BOOST_CHECK(!worker.useSparseGridEvaluation());
+  worker.getCombiParameters().setEvalMemoryBudget(4096);
+  BOOST_CHECK(worker.useSparseGridEvaluation());
+  worker.getCombiParameters().setEvalMemoryBudget(0);
+  size_t numCoordinates = 100;
+  std::vector<real> randomNumbers(numCoordinates * dim);
+  montecarlo::getNumberSequenceFromSeed(randomNumbers, 42);
+  std::vector<std::vector<real>> interpolationCoords(numCoordinates, std::vector<real>(dim));
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    std::copy(randomNumbers.begin() + i * dim, randomNumbers.begin() + (i + 1) * dim,
+              interpolationCoords[i].begin());
+  }
+  auto sparseGridValues = worker.evalOnSparseGrid(interpolationCoords);
+  auto interpolatedValues = worker.interpolateValues(interpolationCoords);
+  TestFnCount<CombiDataType> initialFunction;
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    BOOST_CHECK_CLOSE(std::real(sparseGridValues[i]), std::real(interpolatedValues[i]),
+                      TestHelper::tolerance);
+    BOOST_CHECK_CLOSE(std::real(sparseGridValues[i]),
+                      std::real(initialFunction(interpolationCoords[i], ncombi)),
+                      TestHelper::tolerance);
+  }
+  auto normsLmax = worker.parallelEvalNorm(lmax);
+  auto analyticalNorms = worker.evalAnalyticalOnDFG(lmax);
+  auto error = worker.evalErrorOnDFG(lmax);
+  // the same norms if evaluated on the sparse grid
+  worker.getCombiParameters().setEvalMemoryBudget(4096);
+  auto sparseGridNormsLmax = worker.parallelEvalNorm(lmax);
+  auto sparseGridError = worker.evalErrorOnDFG(lmax);
+  worker.getCombiParameters().setEvalMemoryBudget(0);
+  for (size_t p = 0; p < 3; ++p) {
+    BOOST_CHECK_CLOSE(normsLmax[p], analyticalNorms[p], TestHelper::tolerance);
+    BOOST_CHECK_SMALL(error[p], TestHelper::tolerance);
+    BOOST_CHECK_CLOSE(sparseGridNormsLmax[p], normsLmax[p], TestHelper::tolerance);
+    BOOST_CHECK_SMALL(sparseGridError[p], TestHelper::tolerance);
+  }
+
+  // the output written slab-wise from the sparse grid is the same as from the full grid
+  FIRST_GROUP_EXCLUSIVE_SECTION {
+    auto readFile = [](const std::string& fileName) {
+      std::ifstream ifs(fileName, std::ios::binary);
+      return std::string(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    };
+    for (const std::string extension : {".dat", ".vtk"}) {
+      const std::string gridSuffix = extension == ".vtk" ? "" : "_0";
+      worker.getCombiParameters().setEvalMemoryBudget(0);
+      worker.parallelEvalUniform("worker_driver_plot" + extension, lmax);
+      for (size_t budget : {1, 4096}) {
+        worker.getCombiParameters().setEvalMemoryBudget(budget);
+        worker.parallelEvalUniform("worker_driver_streamed" + extension, lmax);
+        MPI_Barrier(theMPISystem()->getLocalComm());
+        MASTER_EXCLUSIVE_SECTION {
+          auto fullGridOutput = readFile("worker_driver_plot" + gridSuffix + extension);
+          BOOST_CHECK(!fullGridOutput.empty());
+          BOOST_CHECK(fullGridOutput ==
+                      readFile("worker_driver_streamed" + gridSuffix + extension));
+          std::filesystem::remove("worker_driver_streamed" + gridSuffix + extension);
+        }
+        MPI_Barrier(theMPISystem()->getLocalComm());
+      }
+      MASTER_EXCLUSIVE_SECTION {
+        std::filesystem::remove("worker_driver_plot" + gridSuffix + extension);
+      }
+    }
+  }
+  driver.exit();
+
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
+// the parameters of the driver tests below: the 2D scheme with lmin 2 and lmax 5, on groups of
+// nprocs, decomposed such that the combined solution can be evaluated on the sparse grid
+CombiParameters getDriverTestParameters(size_t nprocs, size_t ncombi, bool decomposed = false) {
+  DimType dim = 2;
+  LevelVector lmin(dim, 2);
+  LevelVector lmax(dim, 5);
+  std::vector<BoundaryType> boundary(dim, 2);
+  CombiParameters params(dim, lmin, lmax, boundary, ncombi, 1, {static_cast<int>(nprocs), 1},
+                         LevelVector(0), LevelVector(0), false);
+  if (decomposed && nprocs == 1) {
+    params.setDecomposition({{0}, {0}});
+  } else if (decomposed && nprocs == 2) {
+    params.setDecomposition({{0, 16}, {0}});
+  }
+  return params;
+}
+
+struct DriverTestSetup {
+  CommunicatorType comm = MPI_COMM_NULL;
+  std::unique_ptr<LoadModel> loadModel;  // the tasks keep a pointer to it
+  std::unique_ptr<WorkerOnlyDriver> driver;
+};
+
+// initialize ngroup groups of nprocs with the tasks of the scheme in params; the comm is
+// MPI_COMM_NULL (and there is no driver) on the ranks that do not take part
+template <typename TaskType = TaskCount>
+DriverTestSetup initializeDriverTest(size_t ngroup, size_t nprocs,
+                                     const CombiParameters& params) {
+  DriverTestSetup setup;
+  size_t size = ngroup * nprocs;
+  BOOST_REQUIRE(TestHelper::checkNumMPIProcsAvailable(size));
+
+  setup.comm = TestHelper::getComm(size);
+  if (setup.comm == MPI_COMM_NULL) {
+    return setup;
+  }
+  combigrid::Stats::initialize();
+  theMPISystem()->initWorldReusable(setup.comm, ngroup, nprocs, false);
+
+  CombiMinMaxScheme combischeme(params.getDim(), params.getLMin(), params.getLMax());
+  combischeme.createAdaptiveCombischeme();
+  setup.driver.reset(new WorkerOnlyDriver(params));
+  auto assignment =
+      getTaskAssignment(combischeme.getCombiSpaces(), combischeme.getCoeffs(),
+                        theMPISystem()->getProcessGroupNumber(), ngroup);
+  BOOST_REQUIRE(assignment.levels.size() > 0);
+  setup.loadModel.reset(new LinearLoadModel());
+  setup.driver->initializeTasks<TaskType>(assignment, setup.loadModel.get());
+  return setup;
+}
+
+void checkWorkerOnlyDriverPipelined(size_t ngroup = 1, size_t nprocs = 1,
+                                    size_t chunkSize = CombiCom::globalReduceChunkSize) {
+  size_t ncombi = 3;
+  auto setup = initializeDriverTest(ngroup, nprocs, getDriverTestParameters(nprocs, ncombi));
+  if (setup.comm == MPI_COMM_NULL) {
+    return;
+  }
+  const auto& comm = setup.comm;
+  auto& driver = *setup.driver;
+
+  // there is no point between run and combination for the after-run hook
+  driver.setAfterRunHook([](WorkerOnlyDriver&, size_t) {});
+  BOOST_CHECK_THROW(driver.runAndCombineStep(), std::runtime_error);
+  driver.setAfterRunHook(nullptr);
+
+  size_t numCombineHooks = 0;
+  driver.setAfterCombineHook([&numCombineHooks](WorkerOnlyDriver& d, size_t step) {
+    BOOST_CHECK_EQUAL(step, numCombineHooks);
+    ++numCombineHooks;
+    BOOST_CHECK(checkReducedFullGridIntegration(d.getWorker(),
+                                                d.getWorker().getCurrentNumberOfCombinations()));
+  });
+  BOOST_CHECK_THROW(driver.setPipelinedCombination(true, 0), std::runtime_error);
+  driver.setPipelinedCombination(true, chunkSize);
+  driver.run(ncombi);
+  if (chunkSize < CombiCom::globalReduceChunkSize) {
+    // the reduce is actually split into several chunks, started while tasks are still running
+    const auto& dsg = *driver.getWorker().getCombinedUniDSGVector()[0];
+    BOOST_CHECK_GT(CombiCom::getNumGlobalReduceChunks(dsg, chunkSize), 2);
+  }
+  BOOST_CHECK_EQUAL(numCombineHooks, ncombi);
+  BOOST_CHECK_EQUAL(driver.getNumberOfRunSteps(), ncombi);
+  BOOST_CHECK_EQUAL(driver.getWorker().getCurrentNumberOfCombinations(), ncombi);
+
+  // the combined solution is the same as after the phased combination
+  std::vector<std::vector<real>> interpolationCoords = {{0.5, 0.5}, {0.125, 0.75}, {0.3, 0.9}};
+  auto interpolatedValues = driver.getWorker().interpolateValues(interpolationCoords);
+  TestFnCount<CombiDataType> initialFunction;
+  for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+    BOOST_CHECK_CLOSE(std::real(interpolatedValues[i]),
+                      std::real(initialFunction(interpolationCoords[i], ncombi)),
+                      TestHelper::tolerance);
+  }
+  driver.exit();
+
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
+void checkWorkerOnlyDriverPartial(size_t ngroup = 1, size_t nprocs = 1) {
+  size_t ncombi = 4;
+  LevelType coarseLevelSum = 4;
+  auto params = getDriverTestParameters(nprocs, ncombi, true);
+  // the fine subspaces are combined in the combinations 0, 2 and 3 (the last one)
+  params.setPartialCombination(coarseLevelSum, 2);
+  std::vector<bool> isPartial;
+  for (size_t i = 0; i < ncombi; ++i) isPartial.push_back(params.isPartialCombination(i));
+  BOOST_CHECK(isPartial == std::vector<bool>({false, true, false, false}));
+
+  auto setup = initializeDriverTest(ngroup, nprocs, params);
+  if (setup.comm == MPI_COMM_NULL) {
+    return;
+  }
+  const auto& comm = setup.comm;
+  auto& driver = *setup.driver;
+  const auto& lmax = params.getLMax();
+  BOOST_CHECK_THROW(driver.setPipelinedCombination(), std::runtime_error);
+
+  // only the selected subspaces are reduced
+  auto& dsg = *driver.getWorker().getCombinedUniDSGVector()[0];
+  dsg.setZero();
+  std::fill(dsg.getRawData(), dsg.getRawData() + dsg.getRawDataSize(), 1.);
+  std::vector<bool> coarseSubspaces(dsg.getNumSubspaces());
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    coarseSubspaces[i] = levelSum(dsg.getLevelVector(i)) <= coarseLevelSum;
+  }
+  CombiCom::distributedGlobalReduce(dsg, coarseSubspaces);
+  for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+    const CombiDataType expected = coarseSubspaces[i] ? static_cast<real>(ngroup) : 1.;
+    for (SubspaceSizeType j = 0; j < dsg.getDataSize(i); ++j) {
+      BOOST_CHECK_EQUAL(dsg.getData(i)[j], expected);
+    }
+  }
+
+  // the partial combinations leave the solution consistent
+  std::vector<std::vector<real>> interpolationCoords = {{0.5, 0.5}, {0.125, 0.75}, {0.3, 0.9}};
+  size_t numCombineHooks = 0;
+  driver.setAfterCombineHook([&](WorkerOnlyDriver& d, size_t step) {
+    BOOST_CHECK_EQUAL(step, numCombineHooks);
+    ++numCombineHooks;
+    auto& worker = d.getWorker();
+    BOOST_CHECK(checkReducedFullGridIntegration(worker, worker.getCurrentNumberOfCombinations()));
+    BOOST_CHECK_EQUAL(worker.isSparseGridPartiallyCombined(), isPartial[step]);
+    if (isPartial[step]) {
+      // in a partial combination, the fine subspaces are not combined
+      for (decltype(dsg.getNumSubspaces()) i = 0; i < dsg.getNumSubspaces(); ++i) {
+        if (coarseSubspaces[i]) continue;
+        for (SubspaceSizeType j = 0; j < dsg.getDataSize(i); ++j) {
+          BOOST_CHECK_EQUAL(dsg.getData(i)[j], 0.);
+        }
+      }
+      // so the sparse grid cannot be evaluated, neither directly nor through a full grid
+      worker.getCombiParameters().setEvalMemoryBudget(4096);
+      BOOST_CHECK(!worker.canEvalOnSparseGrid());
+      BOOST_CHECK(!worker.useSparseGridEvaluation());
+      BOOST_CHECK_THROW(worker.evalOnSparseGrid(interpolationCoords), std::runtime_error);
+      BOOST_CHECK_THROW(worker.parallelEvalNorm(lmax), std::runtime_error);
+      worker.getCombiParameters().setEvalMemoryBudget(0);
+      BOOST_CHECK_THROW(worker.parallelEvalNorm(lmax), std::runtime_error);
+    } else {
+      // after a full combination, the sparse grid holds the combined solution
+      BOOST_REQUIRE(worker.canEvalOnSparseGrid());
+      auto sparseGridValues = worker.evalOnSparseGrid(interpolationCoords);
+      auto interpolatedValues = worker.interpolateValues(interpolationCoords);
+      for (size_t i = 0; i < interpolationCoords.size(); ++i) {
+        BOOST_CHECK_CLOSE(std::real(sparseGridValues[i]), std::real(interpolatedValues[i]),
+                          TestHelper::tolerance);
+      }
+      BOOST_CHECK_NO_THROW(worker.parallelEvalNorm(lmax));
+    }
+  });
+  driver.run(ncombi);
+  BOOST_CHECK_EQUAL(numCombineHooks, ncombi);
+  driver.exit();
+
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
+void checkWorkerOnlyDriverPrecision(size_t ngroup = 1, size_t nprocs = 1) {
+  // the component grids may be single precision (DISCOTEC_SINGLEPRECISION), but they are always
+  // combined in double precision
+  static_assert(std::is_same<RealTypeOf<SparseGridDataType>::type, real>::value,
+                "the sparse grids have to be double precision");
+  size_t ncombi = 2;
+  const auto params = getDriverTestParameters(nprocs, ncombi, true);
+  auto setup = initializeDriverTest(ngroup, nprocs, params);
+  if (setup.comm == MPI_COMM_NULL) {
+    return;
+  }
+  const auto& comm = setup.comm;
+  auto& driver = *setup.driver;
+  const auto dim = params.getDim();
+  const auto& lmax = params.getLMax();
+  driver.run(ncombi);
+  auto& worker = driver.getWorker();
+
+  // the combined solution is exact up to the precision of the component grids, both in the
+  // sparse grid and in the component grids it is extracted to
+  const double gridTolerance =
+      1e3 * std::numeric_limits<RealTypeOf<CombiDataType>::type>::epsilon();
+  TestFnCount<SparseGridDataType> initialFunction;
+  const double maxValue = std::abs(initialFunction(std::vector<real>(dim, 1.), ncombi));
+  size_t numCoordinates = 100;
+  std::vector<real> randomNumbers(numCoordinates * dim);
+  montecarlo::getNumberSequenceFromSeed(randomNumbers, 42);
+  std::vector<std::vector<real>> interpolationCoords(numCoordinates, std::vector<real>(dim));
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    std::copy(randomNumbers.begin() + i * dim, randomNumbers.begin() + (i + 1) * dim,
+              interpolationCoords[i].begin());
+  }
+  auto sparseGridValues = worker.evalOnSparseGrid(interpolationCoords);
+  auto interpolatedValues = worker.interpolateValues(interpolationCoords);
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    const auto expected = initialFunction(interpolationCoords[i], ncombi);
+    BOOST_CHECK_SMALL(std::abs(sparseGridValues[i] - expected), gridTolerance * maxValue);
+    BOOST_CHECK_SMALL(std::abs(static_cast<SparseGridDataType>(interpolatedValues[i]) - expected),
+                      gridTolerance * maxValue);
+  }
+  auto error = worker.evalErrorOnDFG(lmax);
+  for (size_t p = 0; p < 3; ++p) {
+    BOOST_CHECK_SMALL(error[p], gridTolerance * maxValue);
+  }
+
+  // the double precision sparse grid is written and read without loss
+  auto& dsg = *worker.getCombinedUniDSGVector()[0];
+  std::vector<SparseGridDataType> combinedValues(dsg.getRawData(),
+                                                 dsg.getRawData() + dsg.getRawDataSize());
+  const std::string filename =
+      "worker_precision_" + std::to_string(theMPISystem()->getProcessGroupNumber()) + "_dsgs";
+  worker.writeDSGsToDisk(filename);
+  dsg.setZero();
+  worker.readDSGsFromDisk(filename);
+  BOOST_CHECK(std::equal(combinedValues.begin(), combinedValues.end(), dsg.getRawData()));
+  MPI_Barrier(theMPISystem()->getLocalComm());
+  MASTER_EXCLUSIVE_SECTION { std::filesystem::remove(filename + "_0"); }
+  driver.exit();
+
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
+void checkWorkerOnlyDriverMixedPrecision(size_t ngroup = 1, size_t nprocs = 1) {
+  size_t ncombi = 2;
+  const auto params = getDriverTestParameters(nprocs, ncombi + 1, true);
+  auto setup = initializeDriverTest<TaskCountMixedPrecision>(ngroup, nprocs, params);
+  if (setup.comm == MPI_COMM_NULL) {
+    return;
+  }
+  const auto& comm = setup.comm;
+  auto& driver = *setup.driver;
+  auto& worker = driver.getWorker();
+  const auto dim = params.getDim();
+
+  // both kinds of tasks take part (each rank of a group holds the same tasks)
+  int numTasks = static_cast<int>(worker.getTasks().size());
+  int numSinglePrecisionTasks = static_cast<int>(
+      std::count_if(worker.getTasks().begin(), worker.getTasks().end(),
+                    [](const Task* t) { return t->isSinglePrecision(); }));
+  MPI_Allreduce(MPI_IN_PLACE, &numTasks, 1, MPI_INT, MPI_SUM, comm);
+  MPI_Allreduce(MPI_IN_PLACE, &numSinglePrecisionTasks, 1, MPI_INT, MPI_SUM, comm);
+  BOOST_CHECK_GT(numSinglePrecisionTasks, 0);
+  BOOST_CHECK_LT(numSinglePrecisionTasks, numTasks);
+
+  // the single precision grids limit the accuracy of the combined solution
+  const double gridTolerance =
+      1e3 * std::numeric_limits<RealTypeOf<SinglePrecisionDataType>::type>::epsilon();
+  TestFnCount<SparseGridDataType> initialFunction;
+  size_t numCoordinates = 100;
+  std::vector<real> randomNumbers(numCoordinates * dim);
+  montecarlo::getNumberSequenceFromSeed(randomNumbers, 42);
+  std::vector<std::vector<real>> interpolationCoords(numCoordinates, std::vector<real>(dim));
+  for (size_t i = 0; i < numCoordinates; ++i) {
+    std::copy(randomNumbers.begin() + i * dim, randomNumbers.begin() + (i + 1) * dim,
+              interpolationCoords[i].begin());
+  }
+  auto checkCombinedSolution = [&](size_t nrun) {
+    const double maxValue = std::abs(initialFunction(std::vector<real>(dim, 1.), nrun));
+    // every task's grid holds the combined solution, in its own precision
+    for (Task* t : worker.getTasks()) {
+      t->visitDistributedFullGrid([&](auto& dfg) {
+        std::vector<real> coords(dim);
+        for (IndexType li = 0; li < dfg.getNrLocalElements(); ++li) {
+          dfg.getCoordsLocal(li, coords);
+          BOOST_CHECK_SMALL(std::abs(static_cast<SparseGridDataType>(dfg.getData()[li]) -
+                                     initialFunction(coords, nrun)),
+                            gridTolerance * maxValue);
+        }
+      });
+    }
+    auto sparseGridValues = worker.evalOnSparseGrid(interpolationCoords);
+    auto interpolatedValues = worker.interpolateValues(interpolationCoords);
+    for (size_t i = 0; i < numCoordinates; ++i) {
+      const auto expected = initialFunction(interpolationCoords[i], nrun);
+      BOOST_CHECK_SMALL(std::abs(sparseGridValues[i] - expected), gridTolerance * maxValue);
+      BOOST_CHECK_SMALL(
+          std::abs(static_cast<SparseGridDataType>(interpolatedValues[i]) - expected),
+          gridTolerance * maxValue);
+    }
+    auto error = worker.evalErrorOnDFG(params.getLMax());
+    for (size_t p = 0; p < 3; ++p) {
+      BOOST_CHECK_SMALL(error[p], gridTolerance * maxValue);
+    }
+    BOOST_CHECK_EQUAL(worker.getLpNorms(0).size(), worker.getTasks().size());
+  };
+
+  // the mixed grids are hierarchized, added, extracted and dehierarchized in their own type
+  driver.run(ncombi);
+  checkCombinedSolution(ncombi);
+  // also when pipelined
+  driver.setPipelinedCombination(true, 32);
+  driver.run(1);
+  checkCombinedSolution(ncombi + 1);
+  driver.exit();
+
+  combigrid::Stats::finalize();
+  MPI_Barrier(comm);
+  BOOST_CHECK(!TestHelper::testStrayMessages(comm));
+}
+
 #ifndef ISGENE  // worker tests won't work with ISGENE because of worker magic
 
 #ifndef NDEBUG  // in case of a build with asserts, have longer timeout
@@ -390,5 +865,53 @@ BOOST_AUTO_TEST_CASE(test_1, *boost::unit_test::tolerance(TestHelper::higherTole
   BOOST_TEST_MESSAGE("time to run all 'worker' tests: " << duration.count() << " milliseconds");
 }
 
+BOOST_AUTO_TEST_CASE(test_driver, *boost::unit_test::tolerance(TestHelper::higherTolerance)) {
+  for (size_t ngroup : {1, 2, 3}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriver(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_pipelined, *boost::unit_test::tolerance(TestHelper::higherTolerance)) {
+  for (size_t ngroup : {1, 2, 3}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriverPipelined(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+      // chunks small enough to pipeline; the seven tasks are spread unevenly over 2 or 3 groups
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriverPipelined(ngroup, nprocs, 32));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_partial, *boost::unit_test::tolerance(TestHelper::higherTolerance)) {
+  for (size_t ngroup : {1, 2, 3}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriverPartial(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_precision) {
+  for (size_t ngroup : {1, 2, 3}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriverPrecision(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(test_mixedPrecision) {
+  for (size_t ngroup : {1, 2, 3}) {
+    for (size_t nprocs : {1, 2}) {
+      BOOST_CHECK_NO_THROW(checkWorkerOnlyDriverMixedPrecision(ngroup, nprocs));
+      MPI_Barrier(MPI_COMM_WORLD);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 #endif
@@ -0,0 +1,89 @@
+#include <boost/property_tree/ini_parser.hpp>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "combischeme/CombiMinMaxScheme.hpp"
+#include "utils/DecompositionPlanner.hpp"
+#include "utils/IndexVector.hpp"
+#include "utils/Types.hpp"
+
+using namespace combigrid;
+
+int main(int argc, char** argv) {
+  // read in parameter file -- use the same one as for the simulation
+  std::string paramfile = "ctparam";
+  if (argc > 1) paramfile = argv[1];
+  boost::property_tree::ptree cfg;
+  boost::property_tree::ini_parser::read_ini(paramfile, cfg);
+
+  /* read parameters from ctparam */
+  DimType dim = cfg.get<DimType>("ct.dim");
+  LevelVector lmin(dim), lmax(dim);
+  cfg.get<std::string>("ct.lmin") >> lmin;
+  cfg.get<std::string>("ct.lmax") >> lmax;
+  auto numProcs = cfg.get<int>("manager.nprocs");
+  std::string ctschemeFile = cfg.get<std::string>("ct.ctscheme", "");
+  std::vector<BoundaryType> boundary(dim, 2);
+  if (cfg.get_optional<std::string>("ct.boundary")) {
+    std::vector<int> boundaryInts(dim);
+    cfg.get<std::string>("ct.boundary") >> boundaryInts;
+    boundary.assign(boundaryInts.begin(), boundaryInts.end());
+  }
+
+  // solver constraints and weights
+  DecompositionPlannerOptions options;
+  if (cfg.get_optional<std::string>("planner.fixedp")) {
+    options.fixedProcs.resize(dim);
+    cfg.get<std::string>("planner.fixedp") >> options.fixedProcs;
+  }
+  if (cfg.get_optional<std::string>("planner.maxp")) {
+    options.maxProcs.resize(dim);
+    cfg.get<std::string>("planner.maxp") >> options.maxProcs;
+  }
+  options.forwardDecomposition = cfg.get<bool>("planner.forwarddecomposition", false);
+  options.hierarchizationWeight = cfg.get<double>("planner.hierarchizationweight", 1.);
+  options.reduceWeight = cfg.get<double>("planner.reduceweight", 1.);
+  auto numPlansToShow = cfg.get<size_t>("planner.top", 5);
+
+  std::unique_ptr<CombiMinMaxScheme> scheme;
+  if (ctschemeFile == "") {
+    scheme.reset(new CombiMinMaxScheme(dim, lmin, lmax));
+    scheme->createAdaptiveCombischeme();
+  } else {
+    scheme.reset(new CombiMinMaxSchemeFromFile(dim, lmin, lmax, ctschemeFile));
+  }
+  const auto& levels = scheme->getCombiSpaces();
+  std::cout << "planning for " << levels.size() << " component grids on " << numProcs
+            << " processes per group" << std::endl;
+
+  auto plans = planDecompositions(levels, lmin, lmax, boundary, numProcs, options);
+  if (plans.empty()) {
+    std::cout << "no parallelization satisfies the constraints" << std::endl;
+    return 1;
+  }
+  for (size_t i = 0; i < std::min(numPlansToShow, plans.size()); ++i) {
+    std::cout << plans[i].toString() << std::endl;
+  }
+  // the reduce volume per rank is its sparse grid size
+  std::cout << "reduce volume per rank: "
+            << plans[0].sparseGridMaxPerRank * sizeof(SparseGridDataType) << " bytes" << std::endl;
+
+  if (cfg.get_optional<std::string>("ct.p")) {
+    std::vector<int> p(dim);
+    cfg.get<std::string>("ct.p") >> p;
+    std::cout << "current " << evaluateDecomposition(levels, lmax, boundary, p, options).toString()
+              << std::endl;
+  }
+
+  // output in the format of ctparam
+  std::cout << std::endl << "[ct]" << std::endl << "p =";
+  for (const auto& p_d : plans[0].parallelization) std::cout << " " << p_d;
+  std::cout << std::endl << "# decomposition (lowest 1d index on lmax per slice):" << std::endl;
+  for (const auto& d : plans[0].decomposition) std::cout << "# " << d << std::endl;
+
+  return 0;
+}
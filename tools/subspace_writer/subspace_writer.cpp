@@ -83,6 +83,21 @@ int main(int argc, char** argv) {
                   &new_communicator);
   theMPISystem()->storeLocalComm(new_communicator);
 
+  // this rank's part of the sparse grid, from which the subspace sizes are computed
+  SparseGridPartition partition{lmax, boundary, IndexVector(dim), IndexVector(dim),
+                                LevelVector(dim, 0)};
+  {
+    MPICartesianUtils cartesianUtils(theMPISystem()->getLocalComm());
+    std::vector<int> partitionCoords;
+    cartesianUtils.getPartitionCoordsOfRank(theMPISystem()->getLocalRank(), partitionCoords);
+    for (DimType d = 0; d < dim; ++d) {
+      const auto c = static_cast<size_t>(partitionCoords[d]);
+      partition.lowerBounds[d] = decomposition[d][c];
+      partition.upperBounds[d] =
+          (c + 1 < decomposition[d].size()) ? decomposition[d][c + 1] : maxNumPoints[d];
+    }
+  }
+
   std::string firstSubspaceFileName =
       ctschemeFile.substr(0, ctschemeFile.length() - std::string("_00008groups.json").length()) +
       ".sizes";
@@ -97,23 +112,16 @@ int main(int argc, char** argv) {
     const auto& allLevels = scheme->getCombiSpaces();
 
     // generate distributed sparse grid
-    auto uniDSG = std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>(
-        new DistributedSparseGridUniform<CombiDataType>(dim, reducedLmax, lmin,
-                                                        theMPISystem()->getLocalComm()));
+    auto uniDSG = std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>(
+        new DistributedSparseGridUniform<SparseGridDataType>(dim, reducedLmax, lmin,
+                                                             theMPISystem()->getLocalComm()));
     MIDDLE_PROCESS_EXCLUSIVE_SECTION {
       std::cout << "sparse grid contains " << uniDSG->getNumSubspaces() << " subspaces."
                 << std::endl;
     }
 
     // register all component grid levels in this sparse grid
-    for (const auto& l : allLevels) {
-      auto dfgDecomposition = combigrid::downsampleDecomposition(decomposition, lmax, l, boundary);
-      auto uniDFG = std::unique_ptr<DistributedFullGrid<CombiDataType>>(
-          new DistributedFullGrid<CombiDataType>(dim, l, theMPISystem()->getLocalComm(), boundary,
-                                                 p, false, dfgDecomposition));
-      // MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "registering " << l << std::endl;
-      uniDSG->registerDistributedFullGrid(*uniDFG);
-    }
+    uniDSG->registerCombinationLevels(allLevels, partition);
     auto numDOF = std::accumulate(uniDSG->getSubspaceDataSizes().begin(),
                                   uniDSG->getSubspaceDataSizes().end(), 0);
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout
@@ -134,19 +142,12 @@ int main(int argc, char** argv) {
     const auto& allLevels = scheme->getCombiSpaces();
 
     // another sparse grid
-    auto uniDSG = std::unique_ptr<DistributedSparseGridUniform<CombiDataType>>(
-        new DistributedSparseGridUniform<CombiDataType>(dim, reducedLmax, lmin,
-                                                        theMPISystem()->getLocalComm()));
+    auto uniDSG = std::unique_ptr<DistributedSparseGridUniform<SparseGridDataType>>(
+        new DistributedSparseGridUniform<SparseGridDataType>(dim, reducedLmax, lmin,
+                                                             theMPISystem()->getLocalComm()));
 
     // register levels from other CT scheme
-    for (const auto& l : allLevels) {
-      auto dfgDecomposition = combigrid::downsampleDecomposition(decomposition, lmax, l, boundary);
-      auto uniDFG = std::unique_ptr<DistributedFullGrid<CombiDataType>>(
-          new DistributedFullGrid<CombiDataType>(dim, l, theMPISystem()->getLocalComm(), boundary,
-                                                 p, false, dfgDecomposition));
-      // MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "registering " << l << std::endl;
-      uniDSG->registerDistributedFullGrid(*uniDFG);
-    }
+    uniDSG->registerCombinationLevels(allLevels, partition);
     auto numDOF = std::accumulate(uniDSG->getSubspaceDataSizes().begin(),
                                   uniDSG->getSubspaceDataSizes().end(), 0);
     MIDDLE_PROCESS_EXCLUSIVE_SECTION std::cout << "other sparse grid has " << numDOF